@@ -102,8 +102,29 @@ if ((global as any).document) {
 
 (global as any).window.setTimeout = setTimeout;
 (global as any).window.setInterval = setInterval;
-(global as any).window.requestAnimationFrame = requestAnimationFrame;
-(global as any).window.cancelAnimationFrame = cancelAnimationFrame;
+// the native scheduler runs callbacks in the same frame the canvases flush in
+declare const TNSAnimationFrame, org;
+function nativeRequestAnimationFrame(callback: (timestamp: number) => void): number {
+	if (global.isAndroid) {
+		return org.nativescript.canvas.TNSAnimationFrame.requestAnimationFrame(
+			new org.nativescript.canvas.TNSAnimationFrame.Callback({
+				onAnimationFrame: callback,
+			})
+		);
+	}
+	return TNSAnimationFrame.requestAnimationFrameToLoop(callback);
+}
+
+function nativeCancelAnimationFrame(id: number) {
+	if (global.isAndroid) {
+		org.nativescript.canvas.TNSAnimationFrame.cancelAnimationFrame(id);
+	} else {
+		TNSAnimationFrame.cancelAnimationFrameWithId(id);
+	}
+}
+
+(global as any).window.requestAnimationFrame = (global as any).requestAnimationFrame = nativeRequestAnimationFrame;
+(global as any).window.cancelAnimationFrame = (global as any).cancelAnimationFrame = nativeCancelAnimationFrame;
 (global as any).window.getComputedStyle = function (element, pseudoEltOptional) {
 	const obj: any = {};
 	obj.getPropertyValue = function (prop) {
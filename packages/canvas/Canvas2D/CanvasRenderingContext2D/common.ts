@@ -5,6 +5,12 @@ import { Path2D } from '../Path2D';
 import { ImageData } from '../ImageData';
 import { TextMetrics } from '../TextMetrics';
 
+// numbers per sprite of drawImageBatch, IMAGE_BATCH_SPRITE_SIZE in common/context/drawing_images
+export const IMAGE_BATCH_SPRITE_SIZE = 10;
+
+// numbers per string of measureTextBatch, TEXT_METRICS_SIZE in common/context/drawing_text
+export const TEXT_METRICS_SIZE = 12;
+
 export abstract class CanvasRenderingContext2DBase implements CanvasRenderingContext {
 	abstract lineWidth: number;
 	abstract fillStyle: string | CanvasGradient | CanvasPattern;
@@ -146,4 +152,22 @@ export abstract class CanvasRenderingContext2DBase implements CanvasRenderingCon
 	public abstract transform(a: number, b: number, c: number, d: number, e: number, f: number): void;
 
 	public abstract translate(x: number, y: number): void;
+
+	// draws drawImageBatch sprites one drawImage at a time, for sources the native batch doesn't take
+	_drawImageBatchSprites(image: any, sprites: ArrayLike<number>, count: number) {
+		const alpha = this.globalAlpha;
+		for (let i = 0; i < count; i++) {
+			const sprite = i * IMAGE_BATCH_SPRITE_SIZE;
+			const width = sprites[sprite + 6];
+			const height = sprites[sprite + 7];
+			this.save();
+			this.globalAlpha = alpha * Math.min(Math.max(sprites[sprite + 9], 0), 1);
+			this.translate(sprites[sprite + 4] + width / 2, sprites[sprite + 5] + height / 2);
+			this.rotate(sprites[sprite + 8]);
+			// a negative destination size mirrors the sprite, as in the native batch
+			this.scale(width < 0 ? -1 : 1, height < 0 ? -1 : 1);
+			this.drawImage(image, sprites[sprite], sprites[sprite + 1], sprites[sprite + 2], sprites[sprite + 3], -Math.abs(width) / 2, -Math.abs(height) / 2, Math.abs(width), Math.abs(height));
+			this.restore();
+		}
+	}
 }
@@ -66,6 +66,8 @@ export declare class CanvasRenderingContext2D extends CanvasRenderingContext2DBa
 	drawImage(image: any, dx: number, dy: number, dWidth: number, dHeight: number): void;
 	drawImage(image: any, sx: number, sy: number, sWidth: number, sHeight: number, dx: number, dy: number, dWidth: number, dHeight: number): void;
 
+	drawImageBatch(image: any, sprites: number[] | Float32Array, count?: number): void;
+
 	ellipse(x: number, y: number, radiusX: number, radiusY: number, rotation: number, startAngle: number, endAngle: number, anticlockwise?: boolean): void;
 
 	fill(): void;
@@ -77,6 +79,17 @@ export declare class CanvasRenderingContext2D extends CanvasRenderingContext2DBa
 
 	fillText(text: string, x: number, y: number, maxWidth?: number): void;
 
+	fillParagraph(text: string, x: number, y: number, maxWidth?: number, lineHeight?: number): void;
+
+	/**
+	 * Lays out text like fillParagraph and returns width, height, longestLine, minIntrinsicWidth,
+	 * maxIntrinsicWidth, alphabeticBaseline, ideographicBaseline and lineCount followed by
+	 * startIndex, endIndex, ascent, descent, height, width, left and baseline for each line.
+	 */
+	measureParagraph(text: string, maxWidth?: number, lineHeight?: number): Float32Array;
+
+	drawSVG(svg: string, x: number, y: number, width: number, height: number, tint?: number): void;
+
 	getImageData(sx: number, sy: number, sw: number, sh: number): ImageData;
 
 	getLineDash(): number[];
@@ -92,6 +105,12 @@ export declare class CanvasRenderingContext2D extends CanvasRenderingContext2DBa
 
 	measureText(text: string): TextMetrics;
 
+	/**
+	 * Measures every string in one native call, returning TEXT_METRICS_SIZE numbers per string in
+	 * TextMetrics property order, starting with width.
+	 */
+	measureTextBatch(texts: string[]): Float32Array;
+
 	moveTo(x: number, y: number): void;
 
 	putImageData(imageData: ImageData, dx: number, dy: number): void;
@@ -1,4 +1,4 @@
-import { CanvasRenderingContext2DBase } from './common';
+import { CanvasRenderingContext2DBase, IMAGE_BATCH_SPRITE_SIZE } from './common';
 import { CanvasGradient } from '../CanvasGradient';
 import { Path2D } from '../Path2D';
 import { ImageData } from '../ImageData';
@@ -701,57 +701,62 @@ export class CanvasRenderingContext2D extends CanvasRenderingContext2DBase {
 		if (!args) {
 			return;
 		}
-		let image = args[0];
-		let asset = null;
-		let width = 0;
-		let height = 0;
+		const image = this._nativeImage(args[0]);
+		if (args.length === 3) {
+			this.context.drawImage(image, args[1], args[2]);
+		} else if (args.length === 5) {
+			this.context.drawImage(image, args[1], args[2], args[3], args[4]);
+		} else if (args.length === 9) {
+			this.context.drawImage(image, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8]);
+		}
+	}
+
+	/**
+	 * Draws count sprites of one image in as few draws as possible. sprites holds 10 numbers per sprite: the source rect's
+	 * x, y, width and height, the destination rect's, a rotation in radians about the destination's center and an alpha.
+	 * A negative destination width or height mirrors the sprite.
+	 */
+	drawImageBatch(image: any, sprites: number[] | Float32Array, count: number = Math.floor(sprites.length / IMAGE_BATCH_SPRITE_SIZE)): void {
+		this.log('drawImageBatch', count);
+		this._ensureLayoutBeforeDraw();
+		count = Math.min(count, Math.floor(sprites.length / IMAGE_BATCH_SPRITE_SIZE));
+		if (count <= 0) {
+			return;
+		}
+		const native = this._nativeImage(image);
+		if (native instanceof TNSCanvas) {
+			// canvases aren't batched natively
+			this._drawImageBatchSprites(image, sprites, count);
+			return;
+		}
+		this.context.drawImageBatch(native, Array.isArray(sprites) ? sprites : Array.from(sprites), count);
+	}
+
+	_nativeImage(image: any) {
 		if (image instanceof ImageSource) {
 			image = image.ios;
-		} else if (image instanceof ImageAsset || image instanceof UIImage) {
+		} else if (image instanceof ImageAsset) {
+			image = image.native;
+		} else if (image instanceof UIImage) {
 			// NOOP
 		} else if (image && typeof image.tagName === 'string' && (image.tagName === 'IMG' || image.tagName === 'IMAGE')) {
-			width = image.width;
-			height = image.height;
 			if (image._imageSource instanceof ImageSource) {
 				image = image._imageSource.ios;
 			} else if (image._image instanceof UIImage) {
 				image = image._image;
 			} else if (image._asset instanceof ImageAsset) {
-				image = image._asset;
+				image = image._asset.native;
 			} else if (typeof image.src === 'string') {
 				image = ImageSource.fromFileSync(image.src).ios;
 			}
+		} else if (image instanceof Canvas) {
+			image = image.ios;
 		} else if (image && typeof image.tagName === 'string' && image.tagName === 'CANVAS' && image._canvas instanceof Canvas) {
-			image = image._canvas;
+			image = image._canvas.ios;
 		} else if (image instanceof ImageBitmap || image?.native instanceof TNSImageBitmap) {
 			image = image.native;
 		}
-
-		if (args.length === 3) {
-			if (image instanceof ImageAsset) {
-				this.context.drawImage(image.native, args[1], args[2]);
-			} else if (image instanceof Canvas) {
-				this.context.drawImage(image.ios, args[1], args[2]);
-			} else {
-				this.context.drawImage(image, args[1], args[2]);
-			}
-		} else if (args.length === 5) {
-			if (image instanceof ImageAsset) {
-				this.context.drawImage(image.native, args[1], args[2], args[3], args[4]);
-			} else if (image instanceof Canvas) {
-				this.context.drawImage(image.ios, args[1], args[2], args[3], args[4]);
-			} else {
-				this.context.drawImage(image, args[1], args[2], args[3], args[4]);
-			}
-		} else if (args.length === 9) {
-			if (image instanceof ImageAsset) {
-				this.context.drawImage(image.native, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8]);
-			} else if (image instanceof Canvas) {
-				this.context.drawImage(image.ios, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8]);
-			} else {
-				this.context.drawImage(image, args[1], args[2], args[3], args[4], args[5], args[6], args[7], args[8]);
-			}
-		}
+		return image;
 	}
 
 	ellipse(x: number, y: number, radiusX: number, radiusY: number, rotation: number, startAngle: number, endAngle: number, anticlockwise: boolean = false): void {
@@ -798,6 +803,32 @@ export class CanvasRenderingContext2D extends CanvasRenderingContext2DBase {
 		}
 	}
 
+	/**
+	 * Wraps text to maxWidth (no wrapping when 0) and draws it with the current fill style, font,
+	 * textAlign and direction. lineHeight is a multiple of the font size, 0 uses the font's own.
+	 */
+	fillParagraph(text: string, x: number, y: number, maxWidth: number = 0, lineHeight: number = 0): void {
+		this.log('fillParagraph', text, x, y, maxWidth, lineHeight);
+		this._ensureLayoutBeforeDraw();
+		this.context.fillParagraph(text + '', x, y, maxWidth, lineHeight);
+	}
+
+	measureParagraph(text: string, maxWidth: number = 0, lineHeight: number = 0): Float32Array {
+		this.log('measureParagraph', text, maxWidth, lineHeight);
+		this._ensureLayoutBeforeDraw();
+		return this._toFloat32Array(this.context.measureParagraph(text + '', maxWidth, lineHeight));
+	}
+
+	/**
+	 * Draws an svg string scaled to width x height from a rasterized atlas shared by every canvas.
+	 * tint is an ARGB color applied to the drawn pixels, 0 for none.
+	 */
+	drawSVG(svg: string, x: number, y: number, width: number, height: number, tint: number = 0): void {
+		this.log('drawSVG', x, y, width, height, tint);
+		this._ensureLayoutBeforeDraw();
+		this.context.drawSVG(svg, x, y, width, height, tint >>> 0);
+	}
+
 	getImageData(sx: number, sy: number, sw: number, sh: number): ImageData {
 		this.log('getImageData', sx, sy, sw, sh);
 		this._ensureLayoutBeforeDraw();
@@ -854,6 +885,16 @@ export class CanvasRenderingContext2D extends CanvasRenderingContext2DBase {
 		return new TextMetrics(this.context.measureText(text));
 	}
 
+	/**
+	 * Measures every string in one native call, returning TEXT_METRICS_SIZE numbers per string in
+	 * TextMetrics property order, starting with width.
+	 */
+	measureTextBatch(texts: string[]): Float32Array {
+		this.log('measureTextBatch', texts.length);
+		this._ensureLayoutBeforeDraw();
+		return this._toFloat32Array(this.context.measureTextBatch(texts.map((text) => text + '')));
+	}
+
 	moveTo(x: number, y: number): void {
 		this.log('moveTo', x, y);
 		this._ensureLayoutBeforeDraw();
@@ -1008,4 +1049,13 @@ export class CanvasRenderingContext2D extends CanvasRenderingContext2DBase {
 			this.canvas._layoutNative();
 		}
 	}
+	// [Float32] comes back as an NSArray of numbers
+	private _toFloat32Array(value): Float32Array {
+		const count = value.count;
+		const array = new Float32Array(count);
+		for (let i = 0; i < count; i++) {
+			array[i] = value.objectAtIndex(i);
+		}
+		return array;
+	}
 }
@@ -1,4 +1,4 @@
-import { Http, View, Style, CssProperty, AddChildFromBuilder, Frame, Property, path, knownFolders, CSSType, Application, Utils } from '@nativescript/core';
+import { Http, View, Style, CssProperty, AddChildFromBuilder, Frame, Property, path, knownFolders, CSSType, Application, Utils, File } from '@nativescript/core';
 
 export const strokeProperty = new CssProperty<Style, any>({
 	name: 'stroke',
@@ -67,6 +67,13 @@ export class Svg extends View {
 	src: string;
 	__children = [];
 	__attachedToDom = false;
+	// _dom has changes the native document hasn't seen, the next redraw sets it as src again
+	__domChanged = true;
+	__serialized: string;
+	__srcRequest = 0;
+	// a file or download is loading, _dom is replaced once it's done
+	__srcLoading = false;
+	__elements = new Map<SVGItem, any>();
 	constructor() {
 		super();
 		if (global.isAndroid) {
@@ -82,42 +89,57 @@ export class Svg extends View {
 
 	[srcProperty.setNative](value: string) {
 		if (typeof value === 'string') {
-			if (value.indexOf('<svg') > -1) {
-				if (global.isAndroid) {
-					this._svg.setSrc(value);
-				} else if (global.isIOS) {
-					this._svg.src = value;
+			// a newer src wins over a file or download still loading
+			const request = ++this.__srcRequest;
+			const load = (svg: string) => {
+				if (request === this.__srcRequest) {
+					this.__setSrc(svg);
+				}
+			};
+			const failed = (e) => {
+				if (request === this.__srcRequest) {
+					this.__srcLoading = false;
 				}
-			} else {
+				console.log(e);
+			};
+			if (value.indexOf('<svg') > -1) {
+				this.__setSrc(value);
+			} else if (value.startsWith('~') || value.startsWith('/') || value.startsWith('http')) {
+				this.__srcLoading = true;
+				// loaded here rather than by path, so _dom and the native document hold the file's content
 				if (value.startsWith('~')) {
-					if (global.isAndroid) {
-						this._svg.setSrcPath(path.join(knownFolders.currentApp().path, value.replace('~', '')));
-					} else if (global.isIOS) {
-						this._svg.srcPath = path.join(knownFolders.currentApp().path, value.replace('~', ''));
-					}
+					File.fromPath(path.join(knownFolders.currentApp().path, value.replace('~', '')))
+						.readText()
+						.then(load)
+						.catch(failed);
 				} else if (value.startsWith('/')) {
-					if (global.isAndroid) {
-						this._svg.setSrcPath(value);
-					} else if (global.isIOS) {
-						this._svg.srcPath = value;
-					}
+					File.fromPath(value)
+						.readText()
+						.then(load)
+						.catch(failed);
 				} else if (value.startsWith('http')) {
 					Http.getString(value)
-						.then((res) => {
-							if (global.isAndroid) {
-								this._svg.setSrc(res);
-							} else if (global.isIOS) {
-								this._svg.src = res;
-							}
-						})
-						.catch((e) => {
-							console.log(e);
-						});
+						.then(load)
+						.catch(failed);
 				}
 			}
 		}
 	}
 
+	__setSrc(value: string) {
+		this.__srcLoading = false;
+		if (value !== this.__serialized) {
+			this._dom = new DOMParser().parseFromString(value);
+			this.__serialized = undefined;
+			this.__domChanged = false;
+		}
+		if (global.isAndroid) {
+			this._svg.setSrc(value);
+		} else if (global.isIOS) {
+			this._svg.src = value;
+		}
+	}
+
 	public onLayout(left: number, top: number, right: number, bottom: number): void {
 		super.onLayout(left, top, right, bottom);
 		this.__redraw();
@@ -133,7 +155,7 @@ export class Svg extends View {
 	}
 
 	__redraw() {
-		if (this.__attachedToDom) {
+		if (this.__attachedToDom && this.__domChanged && !this.__srcLoading) {
 			const domCopy = this._dom.valueOf();
 			const serialized = this._serializer.serializeToString(domCopy);
 			const width = domCopy.documentElement.getAttribute('width');
@@ -145,11 +167,88 @@ export class Svg extends View {
 				domCopy.documentElement.setAttribute('height', `${this.getMeasuredHeight()}px`);
 			}
 			if (serialized !== initialSVG) {
+				this.__domChanged = false;
+				this.__serialized = serialized;
 				this.src = serialized;
 			}
 		}
 	}
 
+	__element(id: string | null) {
+		return id === null || id === undefined ? this._dom.documentElement : this._dom.getElementById(id);
+	}
+
+	// applies an edit the native document has already seen, otherwise _dom is drawn again as a whole
+	__edited(update: () => void) {
+		if (this.__domChanged) {
+			this.__redraw();
+		} else {
+			update();
+		}
+	}
+
+	/**
+	 * Updates the native document parsed from `src` in place, only what the change touches is parsed and drawn again.
+	 * A `null` id targets the root element, a `null` value removes the attribute.
+	 */
+	setElementAttribute(id: string | null, name: string, value: string | null) {
+		const element = this.__element(id);
+		if (!element) {
+			return;
+		}
+		if (value === null || value === undefined) {
+			element.removeAttribute(name);
+		} else {
+			element.setAttribute(name, value);
+		}
+		this.__edited(() => this._svg.setAttribute(id, name, value));
+	}
+
+	setElementText(id: string | null, text: string) {
+		const element = this.__element(id);
+		if (!element) {
+			return;
+		}
+		while (element.firstChild) {
+			element.removeChild(element.firstChild);
+		}
+		element.appendChild(this._dom.createTextNode(text));
+		this.__edited(() => this._svg.setText(id, text));
+	}
+
+	appendElement(parentId: string | null, xml: string) {
+		this.__appendElement(parentId, xml);
+	}
+
+	__appendElement(parentId: string | null, xml: string) {
+		const parent = this.__element(parentId);
+		if (!parent) {
+			return null;
+		}
+		const fragment = new DOMParser().parseFromString(`<g>${xml}</g>`).documentElement;
+		if (!fragment) {
+			return null;
+		}
+		let first = null;
+		for (const node of Array.from<any>(fragment.childNodes)) {
+			const imported = parent.appendChild(this._dom.importNode(node, true));
+			if (first === null && imported.nodeType === 1) {
+				first = imported;
+			}
+		}
+		this.__edited(() => this._svg.appendChild(parentId, xml));
+		return first;
+	}
+
+	removeElement(id: string) {
+		const element = this.__element(id);
+		if (!element || element === this._dom.documentElement) {
+			return;
+		}
+		element.parentNode.removeChild(element);
+		this.__edited(() => this._svg.removeElement(id));
+	}
+
 	onLoaded() {
 		super.onLoaded();
 		this.__attachedToDom = true;
@@ -172,6 +271,12 @@ export class Svg extends View {
 		this._addView(view);
 		view.__attached = true;
 		this.__children.push(view);
+		if (view._dom && view._dom.documentElement) {
+			const element = this.__appendElement(null, this._serializer.serializeToString(view._dom.documentElement));
+			if (element) {
+				this.__elements.set(view, element);
+			}
+		}
 	}
 
 	removeChild(view: SVGItem) {
@@ -179,6 +284,17 @@ export class Svg extends View {
 			this._removeView(view);
 			view.__attached = false;
 			this.__children = this.__children.filter((item) => item !== view);
+			const element = this.__elements.get(view);
+			this.__elements.delete(view);
+			if (element && element.parentNode) {
+				const id = element.getAttribute('id');
+				element.parentNode.removeChild(element);
+				// the native document finds elements by id only
+				if (!id) {
+					this.__domChanged = true;
+				}
+				this.__edited(() => this._svg.removeElement(id));
+			}
 		}
 	}
 }
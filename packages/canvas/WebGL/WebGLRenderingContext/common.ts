@@ -8,6 +8,92 @@ import {WebGLActiveInfo} from '../WebGLActiveInfo';
 import {WebGLRenderbuffer} from '../WebGLRenderbuffer';
 import {WebGLShaderPrecisionFormat} from '../WebGLShaderPrecisionFormat';
 
+export interface WebGLUniformBatchEntry {
+	location: WebGLUniformLocation;
+	// GL uniform type, e.g. FLOAT_VEC4 or FLOAT_MAT4
+	type: number;
+	value: number | ArrayLike<number>;
+	transpose?: boolean;
+}
+
+// 32 bit values per element of a uniform of GL type, 0 when it isn't a uniform type
+export function uniformComponents(type: number): number {
+	switch (type) {
+		case 0x1406: // FLOAT
+		case 0x1404: // INT
+		case 0x1405: // UNSIGNED_INT
+		case 0x8b56: // BOOL
+		case 0x8b5e: // SAMPLER_2D
+		case 0x8b60: // SAMPLER_CUBE
+		case 0x8b5f: // SAMPLER_3D
+		case 0x8b62: // SAMPLER_2D_SHADOW
+		case 0x8dc1: // SAMPLER_2D_ARRAY
+		case 0x8dc4: // SAMPLER_2D_ARRAY_SHADOW
+		case 0x8dc5: // SAMPLER_CUBE_SHADOW
+		case 0x8dca: // INT_SAMPLER_2D
+		case 0x8dcb: // INT_SAMPLER_3D
+		case 0x8dcc: // INT_SAMPLER_CUBE
+		case 0x8dcf: // INT_SAMPLER_2D_ARRAY
+		case 0x8dd2: // UNSIGNED_INT_SAMPLER_2D
+		case 0x8dd3: // UNSIGNED_INT_SAMPLER_3D
+		case 0x8dd4: // UNSIGNED_INT_SAMPLER_CUBE
+		case 0x8dd7: // UNSIGNED_INT_SAMPLER_2D_ARRAY
+			return 1;
+		case 0x8b50: // FLOAT_VEC2
+		case 0x8b53: // INT_VEC2
+		case 0x8dc6: // UNSIGNED_INT_VEC2
+		case 0x8b57: // BOOL_VEC2
+			return 2;
+		case 0x8b51: // FLOAT_VEC3
+		case 0x8b54: // INT_VEC3
+		case 0x8dc7: // UNSIGNED_INT_VEC3
+		case 0x8b58: // BOOL_VEC3
+			return 3;
+		case 0x8b52: // FLOAT_VEC4
+		case 0x8b55: // INT_VEC4
+		case 0x8dc8: // UNSIGNED_INT_VEC4
+		case 0x8b59: // BOOL_VEC4
+		case 0x8b5a: // FLOAT_MAT2
+			return 4;
+		case 0x8b65: // FLOAT_MAT2x3
+		case 0x8b67: // FLOAT_MAT3x2
+			return 6;
+		case 0x8b66: // FLOAT_MAT2x4
+		case 0x8b69: // FLOAT_MAT4x2
+			return 8;
+		case 0x8b5b: // FLOAT_MAT3
+			return 9;
+		case 0x8b68: // FLOAT_MAT3x4
+		case 0x8b6a: // FLOAT_MAT4x3
+			return 12;
+		case 0x8b5c: // FLOAT_MAT4
+			return 16;
+		default:
+			return 0;
+	}
+}
+
+// the uniformMatrix call for each matrix uniform type
+const UNIFORM_MATRIX_SETTERS: { [type: number]: string } = {
+	0x8b5a: 'uniformMatrix2fv',
+	0x8b5b: 'uniformMatrix3fv',
+	0x8b5c: 'uniformMatrix4fv',
+	0x8b65: 'uniformMatrix2x3fv',
+	0x8b66: 'uniformMatrix2x4fv',
+	0x8b67: 'uniformMatrix3x2fv',
+	0x8b68: 'uniformMatrix3x4fv',
+	0x8b69: 'uniformMatrix4x2fv',
+	0x8b6a: 'uniformMatrix4x3fv',
+};
+
+export function isFloatUniformType(type: number): boolean {
+	return type === 0x1406 || (type >= 0x8b50 && type <= 0x8b52) || !!UNIFORM_MATRIX_SETTERS[type];
+}
+
+function isUnsignedUniformType(type: number): boolean {
+	return type === 0x1405 || (type >= 0x8dc6 && type <= 0x8dc8);
+}
+
 export abstract class WebGLRenderingContextBase
 	implements CanvasRenderingContext {
 	abstract readonly drawingBufferHeight: number;
@@ -1781,6 +1867,32 @@ export abstract class WebGLRenderingContextBase
 		value: number[]
 	): void;
 
+	// applies a uniformBatch one uniform call at a time, where there is no native batch to use
+	protected _uniformBatchEach(program: WebGLProgram, uniforms: WebGLUniformBatchEntry[]): number {
+		this.useProgram(program);
+		const context = this as any;
+		let applied = 0;
+		for (const uniform of uniforms) {
+			const components = uniformComponents(uniform.type);
+			const value = typeof uniform.value === 'number' ? [uniform.value] : uniform.value;
+			if (!uniform.location || components === 0 || value.length === 0 || value.length % components !== 0) {
+				continue;
+			}
+			const matrix = UNIFORM_MATRIX_SETTERS[uniform.type];
+			if (matrix) {
+				context[matrix](uniform.location, !!uniform.transpose, value);
+			} else if (isFloatUniformType(uniform.type)) {
+				context[`uniform${components}fv`](uniform.location, value);
+			} else if (isUnsignedUniformType(uniform.type)) {
+				context[`uniform${components}uiv`](uniform.location, value);
+			} else {
+				context[`uniform${components}iv`](uniform.location, value);
+			}
+			applied++;
+		}
+		return applied;
+	}
+
 	abstract useProgram(program: WebGLProgram): void;
 
 	abstract validateProgram(program: WebGLProgram): void;
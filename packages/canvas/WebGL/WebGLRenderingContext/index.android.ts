@@ -1,4 +1,4 @@
-import { WebGLRenderingContextBase } from './common';
+import { WebGLRenderingContextBase, WebGLUniformBatchEntry, isFloatUniformType, uniformComponents } from './common';
 
 import { WebGLShader } from '../WebGLShader';
 import { WebGLFramebuffer } from '../WebGLFramebuffer';
@@ -44,6 +44,8 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 	public static isDebug = false;
 	public static filter: 'both' | 'error' | 'args' = 'both';
 	private context: org.nativescript.canvas.TNSWebGLRenderingContext;
+	// packed uniformBatch entries, reused across calls
+	private _uniformBatchData: ArrayBuffer;
 	constructor(context) {
 		super(context);
 		this.context = context;
@@ -105,6 +107,16 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.attachShader(value, value2);
 	}
 
+	/**
+	 * Times the calls made until endGpuPass separately as label, reported in the frame stats' gpu
+	 * pass times while GPU timing is enabled.
+	 */
+	beginGpuPass(label: string): void {
+		this._glCheckError('beginGpuPass');
+		this._checkArgs('beginGpuPass', arguments);
+		this.context.beginGpuPass(label);
+	}
+
 	bindAttribLocation(program: WebGLProgram, index: number, name: string): void {
 		this._glCheckError('bindAttribLocation');
 		this._checkArgs('bindAttribLocation', arguments);
@@ -616,6 +628,12 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.enable(cap);
 	}
 
+	endGpuPass(): void {
+		this._glCheckError('endGpuPass');
+		this._checkArgs('endGpuPass', arguments);
+		this.context.endGpuPass();
+	}
+
 	finish(): void {
 		this._glCheckError('finish');
 		this.context.finish();
@@ -1032,6 +1050,23 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.polygonOffset(factor, units);
 	}
 
+	/**
+	 * Compiles and links the sources in the background only to cache the program binary, so a
+	 * later linkProgram of the same sources and attribute bindings skips compilation.
+	 */
+	precompileProgram(vertexSource: string, fragmentSource: string, attributes?: { [name: string]: number }): void {
+		this._glCheckError('precompileProgram');
+		this._checkArgs('precompileProgram', arguments);
+		let bindings = null;
+		if (attributes) {
+			bindings = new java.util.HashMap();
+			for (const name of Object.keys(attributes)) {
+				bindings.put(name, java.lang.Integer.valueOf(attributes[name]));
+			}
+		}
+		this.context.precompileProgram(vertexSource, fragmentSource, bindings);
+	}
+
 	readPixels(x: number, y: number, width: number, height: number, format: number, type: number, pixels: ArrayBuffer | ArrayBufferView): void {
 		this._glCheckError('readPixels');
 		this._checkArgs('readPixels', arguments);
@@ -1083,6 +1118,34 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		}
 	}
 
+	/**
+	 * Reads pixels without blocking, resolving with them once the GPU is done, rows bottom up as
+	 * readPixels returns them. webgl2 contexts read into a pixel pack buffer so neither thread stalls.
+	 */
+	readPixelsAsync(x: number, y: number, width: number, height: number, format: number, type: number): Promise<ArrayBuffer> {
+		this._glCheckError('readPixelsAsync');
+		this._checkArgs('readPixelsAsync', arguments);
+		const readback = this.context.readPixelsAsync(x, y, width, height, format, type);
+		return new Promise((resolve, reject) => {
+			// the readback completes on the GL thread, checking it every frame keeps the callbacks on this one
+			const poll = new org.nativescript.canvas.TNSAnimationFrame.Callback({
+				onAnimationFrame() {
+					if (!readback.isDone()) {
+						org.nativescript.canvas.TNSAnimationFrame.requestAnimationFrame(poll);
+						return;
+					}
+					const error = readback.getError();
+					if (error) {
+						reject(error);
+					} else {
+						resolve((ArrayBuffer as any).from(readback.getData()));
+					}
+				},
+			});
+			org.nativescript.canvas.TNSAnimationFrame.requestAnimationFrame(poll);
+		});
+	}
+
 	renderbufferStorage(target: number, internalFormat: number, width: number, height: number): void {
 		this._glCheckError('renderbufferStorage');
 		this._checkArgs('renderbufferStorage', arguments);
@@ -1529,6 +1592,44 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.uniform4i(loc, v0, v1, v2, v3);
 	}
 
+	/**
+	 * Makes program current and sets the uniforms in one round trip to the GL thread, values
+	 * unchanged since the last batch for program are skipped. Returns the number of uniforms set.
+	 */
+	uniformBatch(program: WebGLProgram, uniforms: WebGLUniformBatchEntry[]): number {
+		this._glCheckError('uniformBatch');
+		this._checkArgs('uniformBatch', arguments);
+		if (!this._isSupported) {
+			return this._uniformBatchEach(program, uniforms);
+		}
+		// header of location, type, element count and transpose, then the values, see WebGLUniformBatch.kt
+		let size = 0;
+		for (const uniform of uniforms) {
+			size += 16 + 4 * (typeof uniform.value === 'number' ? 1 : uniform.value.length);
+		}
+		if (!this._uniformBatchData || this._uniformBatchData.byteLength < size) {
+			this._uniformBatchData = new ArrayBuffer(Math.max(size, this._uniformBatchData ? this._uniformBatchData.byteLength * 2 : 4096));
+		}
+		const ints = new Int32Array(this._uniformBatchData);
+		const floats = new Float32Array(this._uniformBatchData);
+		let offset = 0;
+		for (const uniform of uniforms) {
+			const components = uniformComponents(uniform.type);
+			const value = typeof uniform.value === 'number' ? [uniform.value] : uniform.value;
+			if (!uniform.location || components === 0 || value.length === 0 || value.length % components !== 0) {
+				continue;
+			}
+			ints[offset] = uniform.location.native;
+			ints[offset + 1] = uniform.type;
+			ints[offset + 2] = value.length / components;
+			ints[offset + 3] = uniform.transpose ? 1 : 0;
+			(isFloatUniformType(uniform.type) ? floats : ints).set(value, offset + 4);
+			offset += 4 + value.length;
+		}
+		const value = program ? program.native : 0;
+		return this.context.uniformBatch(value, new Uint8Array(this._uniformBatchData) as any, 0, offset * 4);
+	}
+
 	uniformMatrix2fv(location: WebGLUniformLocation, transpose: boolean, value: number[]): void {
 		this._glCheckError('uniformMatrix2fv');
 		this._checkArgs('uniformMatrix2fv', arguments);
@@ -1,7 +1,10 @@
 import {
 	WebGLRenderingContextBase,
+	WebGLUniformBatchEntry,
 } from './common';
 
+export {WebGLUniformBatchEntry} from './common';
+
 import {WebGLShader} from '../WebGLShader';
 import {WebGLFramebuffer} from '../WebGLFramebuffer';
 import {WebGLTexture} from '../WebGLTexture';
@@ -28,6 +31,12 @@ export declare class WebGLRenderingContext extends WebGLRenderingContextBase {
 
 	attachShader(program: WebGLProgram, shader: WebGLShader): void;
 
+	/**
+	 * Times the calls made until endGpuPass separately as label, reported in the frame stats' gpu
+	 * pass times while GPU timing is enabled. Only recorded on android.
+	 */
+	beginGpuPass(label: string): void;
+
 	bindAttribLocation(program: WebGLProgram, index: number, name: string): void;
 
 	bindBuffer(target: number, buffer: WebGLBuffer): void;
@@ -125,6 +134,8 @@ export declare class WebGLRenderingContext extends WebGLRenderingContextBase {
 
 	enable(cap: number): void;
 
+	endGpuPass(): void;
+
 	finish(): void;
 
 	flush(): void;
@@ -211,8 +222,22 @@ export declare class WebGLRenderingContext extends WebGLRenderingContextBase {
 
 	polygonOffset(factor: number, units: number): void;
 
+	/**
+	 * Compiles and links the sources in the background only to cache the program binary, so a
+	 * later linkProgram of the same sources and attribute bindings skips compilation. A no-op
+	 * where program binaries aren't cached, currently everywhere but android.
+	 */
+	precompileProgram(vertexSource: string, fragmentSource: string, attributes?: { [name: string]: number }): void;
+
 	readPixels(x: number, y: number, width: number, height: number, format: number, type: number, pixels: ArrayBufferView): void;
 
+	/**
+	 * Reads pixels without blocking, resolving with them, rows bottom up as readPixels returns them.
+	 * On android webgl2 contexts read into a pixel pack buffer so neither thread waits on the GPU,
+	 * on ios the pixels are read right away.
+	 */
+	readPixelsAsync(x: number, y: number, width: number, height: number, format: number, type: number): Promise<ArrayBuffer>;
+
 	renderbufferStorage(target: number, internalFormat: number, width: number, height: number): void;
 
 	sampleCoverage(value: number, invert: boolean): void;
@@ -275,6 +300,12 @@ export declare class WebGLRenderingContext extends WebGLRenderingContextBase {
 
 	uniform4i(location: WebGLUniformLocation, v0: number, v1: number, v2: number, v3: number): void;
 
+	/**
+	 * Makes program current and sets the uniforms in one call. On android the values unchanged since
+	 * the last batch for program are skipped. Returns the number of uniforms set.
+	 */
+	uniformBatch(program: WebGLProgram, uniforms: WebGLUniformBatchEntry[]): number;
+
 	uniformMatrix2fv(location: WebGLUniformLocation, transpose: boolean, value: number[]): void;
 
 	uniformMatrix3fv(location: WebGLUniformLocation, transpose: boolean, value: number[]): void;
@@ -1,4 +1,4 @@
-import { WebGLRenderingContextBase } from './common';
+import { WebGLRenderingContextBase, WebGLUniformBatchEntry } from './common';
 
 import { WebGLShader } from '../WebGLShader';
 import { WebGLFramebuffer } from '../WebGLFramebuffer';
@@ -75,6 +75,12 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.attachShader(value, value2);
 	}
 
+	// GPU timing is only recorded on android
+	beginGpuPass(label: string): void {
+		this._glCheckError('beginGpuPass');
+		this._checkArgs('beginGpuPass', arguments);
+	}
+
 	bindAttribLocation(program: WebGLProgram, index: number, name: string): void {
 		this._glCheckError('bindAttribLocation');
 		this._checkArgs('bindAttribLocation', arguments);
@@ -395,6 +401,11 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.enable(cap);
 	}
 
+	endGpuPass(): void {
+		this._glCheckError('endGpuPass');
+		this._checkArgs('endGpuPass', arguments);
+	}
+
 	finish(): void {
 		this._glCheckError('finish');
 		this._checkArgs('finish', arguments);
@@ -842,6 +853,12 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.polygonOffset(factor, units);
 	}
 
+	// program binaries are only cached on android, there is nothing to precompile for
+	precompileProgram(vertexSource: string, fragmentSource: string, attributes?: { [name: string]: number }): void {
+		this._glCheckError('precompileProgram');
+		this._checkArgs('precompileProgram', arguments);
+	}
+
 	readPixels(x: number, y: number, width: number, height: number, format: number, type: number, pixels: ArrayBufferView): void {
 		this._glCheckError('readPixels');
 		this._checkArgs('readPixels', arguments);
@@ -852,6 +869,19 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		}
 	}
 
+	// there is no native asynchronous read on ios, the pixels are read right away
+	readPixelsAsync(x: number, y: number, width: number, height: number, format: number, type: number): Promise<ArrayBuffer> {
+		this._glCheckError('readPixelsAsync');
+		this._checkArgs('readPixelsAsync', arguments);
+		const size = this._readPixelsByteSize(width, height, format, type, this.getParameter(this.PACK_ALIGNMENT));
+		if (size <= 0) {
+			return Promise.reject('Unsupported format or type');
+		}
+		const pixels = new Uint8Array(size);
+		this.readPixels(x, y, width, height, format, type, pixels);
+		return Promise.resolve(pixels.buffer);
+	}
+
 	renderbufferStorage(target: number, internalFormat: number, width: number, height: number): void {
 		this._glCheckError('renderbufferStorage');
 		this._checkArgs('renderbufferStorage', arguments);
@@ -1144,6 +1174,13 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.uniform4i(location.native, v0, v1, v2, v3);
 	}
 
+	// there is no native batch on ios, the uniforms are set one call at a time
+	uniformBatch(program: WebGLProgram, uniforms: WebGLUniformBatchEntry[]): number {
+		this._glCheckError('uniformBatch');
+		this._checkArgs('uniformBatch', arguments);
+		return this._uniformBatchEach(program, uniforms);
+	}
+
 	uniformMatrix2fv(location: WebGLUniformLocation, transpose: boolean, value: number[]): void {
 		this._glCheckError('uniformMatrix2fv');
 		this._checkArgs('uniformMatrix2fv', arguments);
@@ -1257,6 +1294,69 @@ export class WebGLRenderingContext extends WebGLRenderingContextBase {
 		this.context.viewport(x, y, width, height);
 	}
 
+	// bytes readPixels writes with rows padded to alignment, 0 for an unsupported format or type
+	private _readPixelsByteSize(width: number, height: number, format: number, type: number, alignment: number): number {
+		let components;
+		switch (format) {
+			case 0x1908: // RGBA
+			case 0x8d99: // RGBA_INTEGER
+				components = 4;
+				break;
+			case 0x1907: // RGB
+			case 0x8d98: // RGB_INTEGER
+				components = 3;
+				break;
+			case 0x8227: // RG
+			case 0x8228: // RG_INTEGER
+			case 0x190a: // LUMINANCE_ALPHA
+				components = 2;
+				break;
+			case 0x1903: // RED
+			case 0x8d94: // RED_INTEGER
+			case 0x1906: // ALPHA
+			case 0x1909: // LUMINANCE
+				components = 1;
+				break;
+			default:
+				return 0;
+		}
+		let pixelSize;
+		switch (type) {
+			case 0x1401: // UNSIGNED_BYTE
+			case 0x1400: // BYTE
+				pixelSize = components;
+				break;
+			case 0x8033: // UNSIGNED_SHORT_4_4_4_4
+			case 0x8034: // UNSIGNED_SHORT_5_5_5_1
+			case 0x8363: // UNSIGNED_SHORT_5_6_5
+				pixelSize = 2;
+				break;
+			case 0x1403: // UNSIGNED_SHORT
+			case 0x1402: // SHORT
+			case 0x140b: // HALF_FLOAT
+				pixelSize = components * 2;
+				break;
+			case 0x1405: // UNSIGNED_INT
+			case 0x1404: // INT
+			case 0x1406: // FLOAT
+				pixelSize = components * 4;
+				break;
+			case 0x8368: // UNSIGNED_INT_2_10_10_10_REV
+			case 0x8c3b: // UNSIGNED_INT_10F_11F_11F_REV
+			case 0x8c3e: // UNSIGNED_INT_5_9_9_9_REV
+				pixelSize = 4;
+				break;
+			default:
+				return 0;
+		}
+		if (width <= 0 || height <= 0) {
+			return 0;
+		}
+		const padding = Math.max(alignment || 4, 1) - 1;
+		const rowSize = (width * pixelSize + padding) & ~padding;
+		return rowSize * (height - 1) + width * pixelSize;
+	}
+
 	protected getJSArray(value): any[] {
 		const count = value.count;
 		const array = [];
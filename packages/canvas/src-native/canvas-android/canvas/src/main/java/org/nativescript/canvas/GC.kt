@@ -1,69 +1,160 @@
 package org.nativescript.canvas
 
+import android.util.Log
 import java.lang.ref.PhantomReference
+import java.lang.ref.Reference
 import java.lang.ref.ReferenceQueue
 import java.nio.ByteBuffer
-import java.util.concurrent.Executors
-import java.util.concurrent.atomic.AtomicBoolean
+import java.util.*
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicIntegerArray
 
-
-class GC {
-	interface Object {
-		fun dispose()
+/**
+ * Owns the lifecycle of native handles held by Kotlin objects. Handles are released on a daemon
+ * thread that blocks on the reference queue once their owner becomes unreachable, or right away
+ * through [NativeHandle.release].
+ */
+class GC private constructor() {
+	enum class HandleType {
+		Context,
+		ImageAsset,
+		ImageData,
+		Path,
+		Matrix,
+		ByteBufMut,
+		SVGDocument,
+		SVGRenderToken
 	}
 
-	class BufferWrapper(private val nativePtr: Long, val value: Any) : Object {
-		override fun dispose() {
-			disposeByteBufMut(nativePtr)
+	/**
+	 * A native handle that outlives changes to its value, e.g. a path rebuilt by addPath.
+	 * Must not reference its owner, otherwise the owner never becomes unreachable.
+	 */
+	class NativeHandle internal constructor(
+		val type: HandleType,
+		value: Long,
+		private val release: (Long) -> Unit
+	) {
+		@Volatile
+		var value: Long = value
+
+		internal var reference: Reference<*>? = null
+
+		/**
+		 * Frees the native handle now, later calls and the owner being collected are no-ops.
+		 */
+		fun release() {
+			val handle = synchronized(this) {
+				val handle = value
+				value = 0
+				handle
+			}
+			instance.unregister(this)
+			if (handle != 0L) {
+				release(handle)
+			}
 		}
 	}
 
-	private var executor = Executors.newSingleThreadExecutor()
-	private val monitoring = AtomicBoolean()
+	private class HandleReference(
+		owner: Any,
+		queue: ReferenceQueue<Any>,
+		val handle: NativeHandle
+	) : PhantomReference<Any>(owner, queue)
 
-	private fun startWatch() {
-		if (monitoring.get()) {
-			return
-		}
-		monitoring.set(true)
-		executor.execute {
-			while (monitoring.get()) {
-				val tmp = bufferRefQue.poll()
-				tmp?.get()?.dispose()
+	private val queue = ReferenceQueue<Any>()
+
+	// phantom references are only enqueued while reachable themselves
+	private val references = Collections.newSetFromMap(ConcurrentHashMap<HandleReference, Boolean>())
+	private val liveCounts = AtomicIntegerArray(HandleType.values().size)
+	private val batch = arrayOfNulls<HandleReference>(RELEASE_BATCH_SIZE)
+
+	private val reaper = Thread({
+		while (true) {
+			try {
+				reap()
+			} catch (ignore: InterruptedException) {
+			} catch (e: Throwable) {
+				Log.e(TAG, "Failed to release native handles", e)
 			}
 		}
+	}, "CanvasNativeReaper").apply {
+		isDaemon = true
+		priority = Thread.MIN_PRIORITY
+	}
+
+	init {
+		reaper.start()
 	}
 
-	private fun stopWatch() {
-		monitoring.set(false)
-		executor.shutdown()
+	private fun reap() {
+		// block until something is collected, then drain whatever else is ready in one go
+		var count = 0
+		batch[count++] = queue.remove() as HandleReference
+		while (count < RELEASE_BATCH_SIZE) {
+			val next = queue.poll() ?: break
+			batch[count++] = next as HandleReference
+		}
+		for (i in 0 until count) {
+			batch[i]?.handle?.release()
+			batch[i] = null
+		}
 	}
 
-	fun restartWatch() {
-		stopWatch()
-		executor = Executors.newSingleThreadExecutor()
-		startWatch()
+	private fun register(owner: Any, handle: NativeHandle): NativeHandle {
+		val reference = HandleReference(owner, queue, handle)
+		handle.reference = reference
+		references.add(reference)
+		liveCounts.incrementAndGet(handle.type.ordinal)
+		return handle
 	}
 
-	fun watchItem(value: Object) {
-		PhantomReference(value, bufferRefQue)
+	private fun unregister(handle: NativeHandle) {
+		val reference = synchronized(handle) {
+			val reference = handle.reference
+			handle.reference = null
+			reference
+		} ?: return
+		references.remove(reference)
+		reference.clear()
+		liveCounts.decrementAndGet(handle.type.ordinal)
 	}
 
 	companion object {
+		private const val TAG = "GC"
+		private const val RELEASE_BATCH_SIZE = 64
 
 		@JvmStatic
-		val bufferRefQue: ReferenceQueue<Object> = ReferenceQueue()
+		val instance = GC()
 
+		/**
+		 * Tracks [value] owned by [owner], [release] runs once [owner] is unreachable.
+		 */
 		@JvmStatic
-		val instance = GC()
+		fun register(owner: Any, type: HandleType, value: Long, release: (Long) -> Unit): NativeHandle {
+			return instance.register(owner, NativeHandle(type, value, release))
+		}
 
-		init {
-			instance.startWatch()
+		/**
+		 * Number of handles of [type] not released yet, useful for spotting leaks.
+		 */
+		@JvmStatic
+		fun liveCount(type: HandleType): Int {
+			return instance.liveCounts.get(type.ordinal)
+		}
+
+		@JvmStatic
+		fun liveCounts(): Map<HandleType, Int> {
+			val counts = EnumMap<HandleType, Int>(HandleType::class.java)
+			for (type in HandleType.values()) {
+				counts[type] = liveCount(type)
+			}
+			return counts
 		}
 
 		@JvmStatic
 		fun watchObject(key: Long, value: ByteBuffer) {
-			PhantomReference(BufferWrapper(key, value), bufferRefQue)
+			register(value, HandleType.ByteBufMut, key) { disposeByteBufMut(it) }
 		}
 
 		@JvmStatic
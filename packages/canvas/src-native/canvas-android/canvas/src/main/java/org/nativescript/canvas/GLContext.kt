@@ -81,6 +81,7 @@ internal class GLContext {
 			val canvasView = reference!!.get()
 			if (canvasView != null) {
 				queueEvent {
+					canvasView.glState.invalidateViewport()
 					if (createSurface && didInit) {
 						getConfig(canvasView)
 						mEGLSurface = createSurface(mEGLConfig, mGLThread?.mSurface)
@@ -171,6 +172,7 @@ internal class GLContext {
 						canvasView.invalidateState and TNSCanvas.INVALIDATE_STATE_PENDING.inv()
 
 					TNSCanvas.nativeFlush(canvasView.nativeContext)
+					canvasView.gpuTimers?.frameBoundary()
 					if (!mGLThread!!.getPaused() && !swapBuffers(mEGLSurface)) {
 						Log.e(TAG, "GLContext: Cannot swap buffers!")
 					}
@@ -178,6 +180,7 @@ internal class GLContext {
 						canvasView.invalidateState and TNSCanvas.INVALIDATE_STATE_INVALIDATING.inv()
 				} else {
 					// WebGL
+					canvasView?.gpuTimers?.frameBoundary()
 					if (!mGLThread!!.getPaused() && !swapBuffers(mEGLSurface)) {
 						Log.e(TAG, "GLContext: Cannot swap buffers!")
 					}
@@ -659,6 +662,9 @@ internal class GLContext {
 
 			// Switch to our EGLContext
 			makeEGLContextCurrent()
+			// a new context has none of the state the caches recorded for the old one
+			view?.glState?.invalidate()
+			view?.vertexArrays?.reset()
 //			EGL14.eglSwapInterval(EGL14.eglGetCurrentDisplay(), 0)
 			if (view?.contextPreserveDrawingBuffer == true) {
 				// Enable buffer preservation -- allows app to draw over previous frames without clearing
@@ -689,6 +695,8 @@ internal class GLContext {
 
 		private fun deInitEGL() {
 			makeEGLContextCurrent()
+			reference?.get()?.readbacks?.release()
+			reference?.get()?.gpuTimers?.release()
 			destroySurface(mEGLSurface)
 			mEGL!!.eglDestroyContext(mEGLDisplay, mEGLContext)
 			mEGL!!.eglTerminate(mEGLDisplay)
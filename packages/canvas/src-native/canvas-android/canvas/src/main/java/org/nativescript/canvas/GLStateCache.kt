@@ -0,0 +1,395 @@
+package org.nativescript.canvas
+
+import android.opengl.GLES20
+import android.opengl.GLES30
+import android.util.SparseIntArray
+
+/**
+ * Shadow of the GL state a WebGL context changes through its own calls, kept on the calling
+ * thread. Lets redundant binds and toggles return without a round trip to the GL thread and lets
+ * getParameter answer tracked queries without glGet, which stalls the pipeline on many drivers.
+ *
+ * Every entry starts out unknown and unknown entries never cause a call to be skipped, anything
+ * touching GL state behind the WebGL calls has to invalidate what it changes.
+ */
+internal class GLStateCache {
+	private var activeTexture = UNKNOWN
+	private var program = UNKNOWN
+	private var arrayBuffer = UNKNOWN
+	private var elementArrayBuffer = UNKNOWN
+	private var framebuffer = UNKNOWN
+	private var renderbuffer = UNKNOWN
+	private var vertexArray = UNKNOWN
+	private val textures2D = IntArray(MAX_TEXTURE_UNITS) { UNKNOWN }
+	private val texturesCubeMap = IntArray(MAX_TEXTURE_UNITS) { UNKNOWN }
+	private val viewport = intArrayOf(UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN)
+	private val blendFunc = intArrayOf(UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN)
+	private val blendEquation = intArrayOf(UNKNOWN, UNKNOWN)
+	private var depthFunc = UNKNOWN
+	private var depthMask = UNKNOWN
+
+	// 1 enabled, 0 disabled
+	private val capabilities = SparseIntArray()
+
+	// set from the GL thread when it changes state on its own, e.g. resizing
+	@Volatile
+	private var invalidated = false
+
+	@Volatile
+	private var viewportInvalidated = false
+
+	/**
+	 * Forgets everything, safe to call from any thread.
+	 */
+	fun invalidate() {
+		invalidated = true
+	}
+
+	/**
+	 * Forgets the viewport, safe to call from any thread.
+	 */
+	fun invalidateViewport() {
+		viewportInvalidated = true
+	}
+
+	fun invalidateArrayBuffer() {
+		arrayBuffer = UNKNOWN
+	}
+
+	private fun sync() {
+		if (invalidated) {
+			invalidated = false
+			activeTexture = UNKNOWN
+			program = UNKNOWN
+			arrayBuffer = UNKNOWN
+			elementArrayBuffer = UNKNOWN
+			framebuffer = UNKNOWN
+			renderbuffer = UNKNOWN
+			vertexArray = UNKNOWN
+			textures2D.fill(UNKNOWN)
+			texturesCubeMap.fill(UNKNOWN)
+			blendFunc.fill(UNKNOWN)
+			blendEquation.fill(UNKNOWN)
+			depthFunc = UNKNOWN
+			depthMask = UNKNOWN
+			capabilities.clear()
+			viewportInvalidated = true
+		}
+		if (viewportInvalidated) {
+			viewportInvalidated = false
+			viewport.fill(UNKNOWN)
+		}
+	}
+
+	private fun textureUnit(): Int {
+		if (activeTexture == UNKNOWN) {
+			return UNKNOWN
+		}
+		val unit = activeTexture - GLES20.GL_TEXTURE0
+		return if (unit in 0 until MAX_TEXTURE_UNITS) unit else UNKNOWN
+	}
+
+	private fun textureBindings(target: Int): IntArray? {
+		return when (target) {
+			GLES20.GL_TEXTURE_2D -> textures2D
+			GLES20.GL_TEXTURE_CUBE_MAP -> texturesCubeMap
+			else -> null
+		}
+	}
+
+	// Each setter records the new value and returns false when GL already has it.
+
+	fun activeTexture(texture: Int): Boolean {
+		sync()
+		if (activeTexture == texture) {
+			return false
+		}
+		activeTexture = texture
+		return true
+	}
+
+	fun bindTexture(target: Int, texture: Int): Boolean {
+		sync()
+		val bindings = textureBindings(target) ?: return true
+		val unit = textureUnit()
+		if (unit == UNKNOWN) {
+			return true
+		}
+		if (bindings[unit] == texture) {
+			return false
+		}
+		bindings[unit] = texture
+		return true
+	}
+
+	/**
+	 * The program in use, [UNKNOWN] when not tracked.
+	 */
+	fun currentProgram(): Int {
+		sync()
+		return program
+	}
+
+	/**
+	 * The bound array buffer, [UNKNOWN] when not tracked.
+	 */
+	fun arrayBuffer(): Int {
+		sync()
+		return arrayBuffer
+	}
+
+	fun useProgram(program: Int): Boolean {
+		sync()
+		if (this.program == program) {
+			return false
+		}
+		this.program = program
+		return true
+	}
+
+	fun bindBuffer(target: Int, buffer: Int): Boolean {
+		sync()
+		when (target) {
+			GLES20.GL_ARRAY_BUFFER -> {
+				if (arrayBuffer == buffer) {
+					return false
+				}
+				arrayBuffer = buffer
+			}
+			GLES20.GL_ELEMENT_ARRAY_BUFFER -> {
+				if (elementArrayBuffer == buffer) {
+					return false
+				}
+				elementArrayBuffer = buffer
+			}
+		}
+		return true
+	}
+
+	fun bindFramebuffer(target: Int, framebuffer: Int): Boolean {
+		sync()
+		if (target != GLES20.GL_FRAMEBUFFER) {
+			// draw or read only, the combined binding no longer describes both
+			this.framebuffer = UNKNOWN
+			return true
+		}
+		if (this.framebuffer == framebuffer) {
+			return false
+		}
+		this.framebuffer = framebuffer
+		return true
+	}
+
+	fun bindRenderbuffer(renderbuffer: Int): Boolean {
+		sync()
+		if (this.renderbuffer == renderbuffer) {
+			return false
+		}
+		this.renderbuffer = renderbuffer
+		return true
+	}
+
+	fun bindVertexArray(vertexArray: Int): Boolean {
+		sync()
+		if (this.vertexArray == vertexArray) {
+			return false
+		}
+		this.vertexArray = vertexArray
+		// the element array binding is part of the vertex array
+		elementArrayBuffer = UNKNOWN
+		return true
+	}
+
+	fun setCapability(cap: Int, enabled: Boolean): Boolean {
+		sync()
+		val value = if (enabled) 1 else 0
+		if (capabilities.get(cap, UNKNOWN) == value) {
+			return false
+		}
+		capabilities.put(cap, value)
+		return true
+	}
+
+	fun blendFunc(srcRGB: Int, dstRGB: Int, srcAlpha: Int, dstAlpha: Int): Boolean {
+		sync()
+		if (blendFunc[0] == srcRGB && blendFunc[1] == dstRGB && blendFunc[2] == srcAlpha && blendFunc[3] == dstAlpha) {
+			return false
+		}
+		blendFunc[0] = srcRGB
+		blendFunc[1] = dstRGB
+		blendFunc[2] = srcAlpha
+		blendFunc[3] = dstAlpha
+		return true
+	}
+
+	fun blendEquation(modeRGB: Int, modeAlpha: Int): Boolean {
+		sync()
+		if (blendEquation[0] == modeRGB && blendEquation[1] == modeAlpha) {
+			return false
+		}
+		blendEquation[0] = modeRGB
+		blendEquation[1] = modeAlpha
+		return true
+	}
+
+	fun depthFunc(func: Int): Boolean {
+		sync()
+		if (depthFunc == func) {
+			return false
+		}
+		depthFunc = func
+		return true
+	}
+
+	fun depthMask(flag: Boolean): Boolean {
+		sync()
+		val value = if (flag) 1 else 0
+		if (depthMask == value) {
+			return false
+		}
+		depthMask = value
+		return true
+	}
+
+	fun viewport(x: Int, y: Int, width: Int, height: Int): Boolean {
+		sync()
+		if (viewport[0] == x && viewport[1] == y && viewport[2] == width && viewport[3] == height) {
+			return false
+		}
+		viewport[0] = x
+		viewport[1] = y
+		viewport[2] = width
+		viewport[3] = height
+		return true
+	}
+
+	// GL unbinds deleted objects from the current context, mirror that.
+
+	fun deleteTexture(texture: Int) {
+		sync()
+		for (i in 0 until MAX_TEXTURE_UNITS) {
+			if (textures2D[i] == texture) {
+				textures2D[i] = 0
+			}
+			if (texturesCubeMap[i] == texture) {
+				texturesCubeMap[i] = 0
+			}
+		}
+	}
+
+	fun deleteBuffer(buffer: Int) {
+		sync()
+		if (arrayBuffer == buffer) {
+			arrayBuffer = 0
+		}
+		if (elementArrayBuffer == buffer) {
+			elementArrayBuffer = 0
+		}
+	}
+
+	fun deleteFramebuffer(framebuffer: Int) {
+		sync()
+		if (this.framebuffer == framebuffer) {
+			this.framebuffer = 0
+		}
+	}
+
+	fun deleteRenderbuffer(renderbuffer: Int) {
+		sync()
+		if (this.renderbuffer == renderbuffer) {
+			this.renderbuffer = 0
+		}
+	}
+
+	fun deleteVertexArray(vertexArray: Int) {
+		sync()
+		if (this.vertexArray == vertexArray) {
+			bindVertexArray(0)
+		}
+	}
+
+	/**
+	 * Returns true when [getParameter] can answer [pname] without asking GL.
+	 */
+	fun isTracked(pname: Int): Boolean {
+		sync()
+		return when (pname) {
+			GLES20.GL_ACTIVE_TEXTURE -> activeTexture != UNKNOWN
+			GLES20.GL_CURRENT_PROGRAM -> program != UNKNOWN
+			GLES20.GL_ARRAY_BUFFER_BINDING -> arrayBuffer != UNKNOWN
+			GLES20.GL_ELEMENT_ARRAY_BUFFER_BINDING -> elementArrayBuffer != UNKNOWN
+			GLES20.GL_FRAMEBUFFER_BINDING -> framebuffer != UNKNOWN
+			GLES20.GL_RENDERBUFFER_BINDING -> renderbuffer != UNKNOWN
+			GLES30.GL_VERTEX_ARRAY_BINDING -> vertexArray != UNKNOWN
+			GLES20.GL_TEXTURE_BINDING_2D -> textureUnit() != UNKNOWN && textures2D[textureUnit()] != UNKNOWN
+			GLES20.GL_TEXTURE_BINDING_CUBE_MAP -> textureUnit() != UNKNOWN && texturesCubeMap[textureUnit()] != UNKNOWN
+			GLES20.GL_VIEWPORT -> viewport[2] != UNKNOWN
+			GLES20.GL_BLEND_SRC_RGB, GLES20.GL_BLEND_DST_RGB, GLES20.GL_BLEND_SRC_ALPHA, GLES20.GL_BLEND_DST_ALPHA -> blendFunc[0] != UNKNOWN
+			GLES20.GL_BLEND_EQUATION_RGB, GLES20.GL_BLEND_EQUATION_ALPHA -> blendEquation[0] != UNKNOWN
+			GLES20.GL_DEPTH_FUNC -> depthFunc != UNKNOWN
+			GLES20.GL_DEPTH_WRITEMASK -> depthMask != UNKNOWN
+			GLES20.GL_BLEND, GLES20.GL_CULL_FACE, GLES20.GL_DEPTH_TEST, GLES20.GL_DITHER,
+			GLES20.GL_POLYGON_OFFSET_FILL, GLES20.GL_SCISSOR_TEST, GLES20.GL_STENCIL_TEST -> capabilities.get(pname, UNKNOWN) != UNKNOWN
+			else -> false
+		}
+	}
+
+	/**
+	 * Answers a tracked [pname] the way WebGL getParameter does, check [isTracked] first.
+	 */
+	fun getParameter(pname: Int): Any? {
+		return when (pname) {
+			GLES20.GL_ACTIVE_TEXTURE -> activeTexture
+			GLES20.GL_CURRENT_PROGRAM -> binding(program)
+			GLES20.GL_ARRAY_BUFFER_BINDING -> binding(arrayBuffer)
+			GLES20.GL_ELEMENT_ARRAY_BUFFER_BINDING -> binding(elementArrayBuffer)
+			GLES20.GL_FRAMEBUFFER_BINDING -> binding(framebuffer)
+			GLES20.GL_RENDERBUFFER_BINDING -> binding(renderbuffer)
+			GLES30.GL_VERTEX_ARRAY_BINDING -> binding(vertexArray)
+			GLES20.GL_TEXTURE_BINDING_2D -> binding(textures2D[textureUnit()])
+			GLES20.GL_TEXTURE_BINDING_CUBE_MAP -> binding(texturesCubeMap[textureUnit()])
+			GLES20.GL_VIEWPORT -> viewport.copyOf()
+			GLES20.GL_BLEND_SRC_RGB -> blendFunc[0]
+			GLES20.GL_BLEND_DST_RGB -> blendFunc[1]
+			GLES20.GL_BLEND_SRC_ALPHA -> blendFunc[2]
+			GLES20.GL_BLEND_DST_ALPHA -> blendFunc[3]
+			GLES20.GL_BLEND_EQUATION_RGB -> blendEquation[0]
+			GLES20.GL_BLEND_EQUATION_ALPHA -> blendEquation[1]
+			GLES20.GL_DEPTH_FUNC -> depthFunc
+			GLES20.GL_DEPTH_WRITEMASK -> depthMask == 1
+			else -> capabilities.get(pname, UNKNOWN) == 1
+		}
+	}
+
+	private fun binding(value: Int): Int? {
+		return if (value == 0) null else value
+	}
+
+	/**
+	 * State TextureRender saves and restores around its draw, unknown entries are -1 and get
+	 * queried natively. Layout matches TRACKED_STATE_* in android/gl/texture_render.rs.
+	 */
+	fun textureRenderState(): IntArray {
+		sync()
+		val unit = textureUnit()
+		return intArrayOf(
+			viewport[0],
+			viewport[1],
+			viewport[2],
+			viewport[3],
+			activeTexture,
+			if (unit == UNKNOWN) UNKNOWN else textures2D[unit],
+			program,
+			framebuffer,
+			renderbuffer,
+			arrayBuffer
+		)
+	}
+
+	companion object {
+		const val UNKNOWN = -1
+
+		// GLES guarantees at least 8 combined units, most devices have 16 to 32
+		private const val MAX_TEXTURE_UNITS = 32
+	}
+}
@@ -0,0 +1,158 @@
+package org.nativescript.canvas
+
+import android.opengl.GLES20
+import android.opengl.GLES30
+import android.os.Build
+import androidx.annotation.RequiresApi
+import java.util.ArrayDeque
+
+/**
+ * GPU time of a context's frames and of labelled passes within them, measured with
+ * EXT_disjoint_timer_query TIME_ELAPSED queries while [TNSAnimationFrame.isGpuTimingEnabled].
+ *
+ * Time elapsed queries can't nest, so a pass ends the frame's running query and the frame resumes
+ * with a new one once the pass ends. A frame's time is the sum of its queries. Results are read
+ * frames later once available, nothing waits on the GPU, and are dropped when the GPU reports a
+ * disjoint event. Needs an ES 3 context exposing the extension.
+ *
+ * Everything runs on the GL thread.
+ */
+@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+internal class GpuTimers {
+	private class Query(val id: Int, val frame: Long, val label: String?)
+
+	private val pending = ArrayDeque<Query>()
+	private val freeQueries = ArrayList<Int>()
+	private var current: Query? = null
+	private var frame = 0L
+
+	// null until checked on the first timed frame
+	private var supported: Boolean? = null
+
+	// frame whose queries are being summed up
+	private var resolvingFrame = -1L
+	private var resolvingTime = 0L
+	private val resolvingPasses = HashMap<String, Long>()
+
+	/** Ends the current frame's timing and starts the next, called right before the swap. */
+	fun frameBoundary() {
+		end()
+		poll()
+		frame++
+		if (TNSAnimationFrame.isGpuTimingEnabled && isSupported()) {
+			begin(null)
+		}
+	}
+
+	fun beginPass(label: String) {
+		if (current == null) {
+			return
+		}
+		end()
+		begin(label)
+	}
+
+	fun endPass() {
+		if (current?.label == null) {
+			return
+		}
+		end()
+		begin(null)
+	}
+
+	fun release() {
+		current?.let {
+			GLES30.glEndQuery(Constants.GL_TIME_ELAPSED_EXT)
+			pending.addLast(it)
+		}
+		current = null
+		val ids = (pending.map { it.id } + freeQueries).toIntArray()
+		if (ids.isNotEmpty()) {
+			GLES30.glDeleteQueries(ids.size, ids, 0)
+		}
+		pending.clear()
+		freeQueries.clear()
+		resetResolving()
+	}
+
+	private fun isSupported(): Boolean {
+		val supported = supported ?: run {
+			val version = GLES20.glGetString(GLES20.GL_VERSION) ?: ""
+			val extensions = GLES20.glGetString(GLES20.GL_EXTENSIONS) ?: ""
+			version.startsWith("OpenGL ES 3") &&
+				extensions.contains("GL_EXT_disjoint_timer_query")
+		}
+		this.supported = supported
+		return supported
+	}
+
+	private fun begin(label: String?) {
+		val id = if (freeQueries.isNotEmpty()) {
+			freeQueries.removeAt(freeQueries.size - 1)
+		} else {
+			val ids = IntArray(1)
+			GLES30.glGenQueries(1, ids, 0)
+			ids[0]
+		}
+		GLES30.glBeginQuery(Constants.GL_TIME_ELAPSED_EXT, id)
+		current = Query(id, frame, label)
+	}
+
+	private fun end() {
+		val query = current ?: return
+		GLES30.glEndQuery(Constants.GL_TIME_ELAPSED_EXT)
+		pending.addLast(query)
+		current = null
+	}
+
+	private fun poll() {
+		if (pending.isEmpty()) {
+			return
+		}
+		val value = IntArray(1)
+		GLES20.glGetIntegerv(Constants.GL_GPU_DISJOINT_EXT, value, 0)
+		if (value[0] != 0) {
+			// the timings in flight are meaningless, e.g. the GPU changed frequency
+			for (query in pending) {
+				freeQueries.add(query.id)
+			}
+			pending.clear()
+			resetResolving()
+			return
+		}
+		while (pending.isNotEmpty()) {
+			val query = pending.first
+			GLES30.glGetQueryObjectuiv(query.id, Constants.GL_QUERY_RESULT_AVAILABLE_EXT, value, 0)
+			if (value[0] == GLES20.GL_FALSE) {
+				break
+			}
+			GLES30.glGetQueryObjectuiv(query.id, Constants.GL_QUERY_RESULT_EXT, value, 0)
+			pending.removeFirst()
+			freeQueries.add(query.id)
+
+			if (query.frame != resolvingFrame) {
+				resetResolving()
+				resolvingFrame = query.frame
+			}
+			// nanoseconds, unsigned
+			val elapsed = value[0].toLong() and 0xFFFFFFFFL
+			resolvingTime += elapsed
+			query.label?.let {
+				resolvingPasses[it] = (resolvingPasses[it] ?: 0L) + elapsed
+			}
+
+			// queries are resolved in order, the frame is complete once the next one isn't its own
+			val next = pending.peekFirst()
+			if (next == null || next.frame != resolvingFrame) {
+				TNSAnimationFrame.reportGpuFrame(resolvingTime, HashMap(resolvingPasses))
+				resetResolving()
+			}
+		}
+	}
+
+	private fun resetResolving() {
+		resolvingFrame = -1L
+		resolvingTime = 0L
+		resolvingPasses.clear()
+	}
+}
@@ -0,0 +1,358 @@
+package org.nativescript.canvas
+
+import android.content.Context
+import android.opengl.GLES20
+import android.opengl.GLES30
+import android.os.Build
+import android.util.Log
+import android.util.SparseArray
+import android.util.SparseIntArray
+import androidx.annotation.RequiresApi
+import java.io.File
+import java.io.FileInputStream
+import java.io.FileOutputStream
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.security.MessageDigest
+import java.util.*
+import java.util.concurrent.Executors
+
+/**
+ * On disk cache of linked program binaries, keyed by the shader sources, attribute bindings and the
+ * driver that produced them so a driver update simply misses. Every GL call happens on the GL
+ * thread of the caller, files are written on a background thread.
+ */
+internal class ProgramBinaryCache private constructor(private val directory: File) {
+	@Volatile
+	private var driver: String? = null
+
+	private val writer = Executors.newSingleThreadExecutor { runnable ->
+		Thread(runnable, "CanvasProgramCache").apply {
+			isDaemon = true
+			priority = Thread.MIN_PRIORITY
+		}
+	}
+
+	private fun driver(): String {
+		return driver ?: (GLES20.glGetString(GLES20.GL_VENDOR) + '\n' +
+			GLES20.glGetString(GLES20.GL_RENDERER) + '\n' +
+			GLES20.glGetString(GLES20.GL_VERSION)).also { driver = it }
+	}
+
+	/**
+	 * [shaders] are (type, source) pairs, [attributes] the explicit attribute bindings.
+	 */
+	fun key(shaders: List<Pair<Int, String>>, attributes: Map<String, Int>): String {
+		val digest = MessageDigest.getInstance("SHA-256")
+		digest.update(driver().toByteArray())
+		for ((type, source) in shaders.sortedBy { it.first }) {
+			digest.update(0)
+			digest.update(type.toString().toByteArray())
+			digest.update(0)
+			digest.update(source.toByteArray())
+		}
+		for ((name, index) in TreeMap(attributes)) {
+			digest.update(1)
+			digest.update(name.toByteArray())
+			digest.update(0)
+			digest.update(index.toString().toByteArray())
+		}
+		val hash = digest.digest()
+		val key = StringBuilder(hash.size * 2)
+		for (byte in hash) {
+			key.append(HEX_DIGITS[(byte.toInt() shr 4) and 0xF])
+			key.append(HEX_DIGITS[byte.toInt() and 0xF])
+		}
+		return key.toString()
+	}
+
+	fun contains(key: String): Boolean {
+		return File(directory, key).exists()
+	}
+
+	/**
+	 * Links [program] from the cached binary, false when there is none or the driver rejected it.
+	 */
+	@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+	fun load(program: Int, key: String): Boolean {
+		val file = File(directory, key)
+		if (!file.exists()) {
+			return false
+		}
+		try {
+			FileInputStream(file).channel.use { channel ->
+				val header = ByteBuffer.allocate(HEADER_SIZE)
+				while (header.hasRemaining()) {
+					if (channel.read(header) < 0) throw IOException("Truncated program binary")
+				}
+				header.flip()
+				val format = header.int
+				val length = header.int
+				if (length <= 0 || length.toLong() != channel.size() - HEADER_SIZE) {
+					throw IOException("Truncated program binary")
+				}
+				val binary = ByteBuffer.allocateDirect(length)
+				while (binary.hasRemaining()) {
+					if (channel.read(binary) < 0) throw IOException("Truncated program binary")
+				}
+				binary.flip()
+				GLES30.glProgramBinary(program, format, binary, length)
+			}
+			val status = IntArray(1)
+			GLES20.glGetProgramiv(program, GLES20.GL_LINK_STATUS, status, 0)
+			if (status[0] == GLES20.GL_TRUE) {
+				file.setLastModified(System.currentTimeMillis())
+				return true
+			}
+		} catch (e: IOException) {
+			Log.w(TAG, "Failed to read program binary", e)
+		}
+		// stale or corrupt, the program is left unlinked so a normal link still works
+		file.delete()
+		return false
+	}
+
+	/**
+	 * Saves the binary of the linked [program]. The program should be linked with
+	 * GL_PROGRAM_BINARY_RETRIEVABLE_HINT set for drivers that otherwise drop it.
+	 */
+	@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+	fun store(program: Int, key: String) {
+		val length = IntArray(1)
+		GLES20.glGetProgramiv(program, GLES30.GL_PROGRAM_BINARY_LENGTH, length, 0)
+		if (length[0] <= 0) {
+			return
+		}
+		val binary = ByteBuffer.allocateDirect(length[0])
+		val written = IntArray(1)
+		val format = IntArray(1)
+		GLES30.glGetProgramBinary(program, length[0], written, 0, format, 0, binary)
+		if (written[0] <= 0) {
+			return
+		}
+		binary.limit(written[0])
+		writer.execute { write(key, format[0], binary) }
+	}
+
+	private fun write(key: String, format: Int, binary: ByteBuffer) {
+		directory.mkdirs()
+		val temp = File(directory, "$key.tmp")
+		try {
+			FileOutputStream(temp).channel.use { channel ->
+				val header = ByteBuffer.allocate(HEADER_SIZE)
+				header.putInt(format).putInt(binary.remaining()).flip()
+				while (header.hasRemaining()) channel.write(header)
+				while (binary.hasRemaining()) channel.write(binary)
+			}
+			if (!temp.renameTo(File(directory, key))) {
+				temp.delete()
+			}
+			trim()
+		} catch (e: IOException) {
+			temp.delete()
+			Log.w(TAG, "Failed to write program binary", e)
+		}
+	}
+
+	private fun trim() {
+		val files = directory.listFiles() ?: return
+		if (files.size <= MAX_ENTRIES) {
+			return
+		}
+		files.sortBy { it.lastModified() }
+		for (i in 0 until files.size - MAX_ENTRIES) {
+			files[i].delete()
+		}
+	}
+
+	companion object {
+		private const val TAG = "ProgramBinaryCache"
+		private const val HEADER_SIZE = 8
+		private const val MAX_ENTRIES = 256
+		private const val HEX_DIGITS = "0123456789abcdef"
+
+		@Volatile
+		private var instance: ProgramBinaryCache? = null
+
+		@JvmStatic
+		fun get(context: Context): ProgramBinaryCache {
+			return instance ?: synchronized(this) {
+				instance ?: ProgramBinaryCache(File(context.cacheDir, "canvas_programs")).also {
+					instance = it
+				}
+			}
+		}
+
+		/**
+		 * GL thread. Program binaries need ES 3 and a driver exposing at least one format.
+		 */
+		@JvmStatic
+		fun isSupported(glVersion: Int): Boolean {
+			if (glVersion < 3 || Build.VERSION.SDK_INT < Build.VERSION_CODES.JELLY_BEAN_MR2) {
+				return false
+			}
+			val formats = IntArray(1)
+			GLES20.glGetIntegerv(GLES30.GL_NUM_PROGRAM_BINARY_FORMATS, formats, 0)
+			return formats[0] > 0
+		}
+	}
+}
+
+/**
+ * What a context needs to key its programs: shader types and sources, attachments and attribute
+ * bindings. Compiles are deferred until they are needed, so a program linked from its binary never
+ * compiles its shaders. Touched from both the calling and the GL thread, hence the locking.
+ */
+internal class ProgramSources {
+	private val shaderTypes = SparseIntArray()
+	private val shaderSources = SparseArray<String>()
+
+	// compileShader was called but glCompileShader was not issued yet
+	private val pendingCompiles = HashSet<Int>()
+
+	// attached to a program that loaded from a binary, so they are known to compile
+	private val verifiedShaders = HashSet<Int>()
+
+	private val programShaders = SparseArray<MutableSet<Int>>()
+	private val programAttributes = SparseArray<MutableMap<String, Int>>()
+
+	// e.g. transform feedback varyings, which are not part of the key
+	private val uncacheablePrograms = HashSet<Int>()
+
+	// deleted while attached, GL keeps them until they are detached and so is their state here
+	private val deletedShaders = HashSet<Int>()
+
+	@Synchronized
+	fun shaderCreated(shader: Int, type: Int) {
+		shaderTypes.put(shader, type)
+	}
+
+	/**
+	 * Returns true when a deferred compile of the old source has to be issued first.
+	 */
+	@Synchronized
+	fun shaderSource(shader: Int, source: String?): Boolean {
+		verifiedShaders.remove(shader)
+		if (source == null) shaderSources.remove(shader) else shaderSources.put(shader, source)
+		return pendingCompiles.remove(shader)
+	}
+
+	@Synchronized
+	fun deferCompile(shader: Int) {
+		verifiedShaders.remove(shader)
+		pendingCompiles.add(shader)
+	}
+
+	@Synchronized
+	fun isVerified(shader: Int): Boolean {
+		return verifiedShaders.contains(shader)
+	}
+
+	/**
+	 * Returns true when the caller has to issue the deferred compile of [shader] now.
+	 */
+	@Synchronized
+	fun takePendingCompile(shader: Int): Boolean {
+		return pendingCompiles.remove(shader)
+	}
+
+	/**
+	 * The deferred compiles of the shaders attached to [program], to issue before linking it.
+	 */
+	@Synchronized
+	fun takePendingCompiles(program: Int): IntArray {
+		val shaders = programShaders[program] ?: return IntArray(0)
+		val pending = shaders.filter { pendingCompiles.remove(it) }
+		return pending.toIntArray()
+	}
+
+	/**
+	 * [program] linked from its binary, its shaders stay uncompiled until queried or relinked.
+	 */
+	@Synchronized
+	fun markVerified(program: Int) {
+		programShaders[program]?.let { verifiedShaders.addAll(it) }
+	}
+
+	@Synchronized
+	fun attach(program: Int, shader: Int) {
+		val shaders = programShaders[program] ?: HashSet<Int>().also { programShaders.put(program, it) }
+		shaders.add(shader)
+	}
+
+	@Synchronized
+	fun detach(program: Int, shader: Int) {
+		programShaders[program]?.remove(shader)
+		forgetIfDeleted(shader)
+	}
+
+	@Synchronized
+	fun bindAttribLocation(program: Int, index: Int, name: String?) {
+		name ?: return
+		val attributes = programAttributes[program] ?: HashMap<String, Int>().also { programAttributes.put(program, it) }
+		attributes[name] = index
+	}
+
+	@Synchronized
+	fun markUncacheable(program: Int) {
+		uncacheablePrograms.add(program)
+	}
+
+	/**
+	 * The (type, source) pairs attached to [program], null when it cannot be keyed.
+	 */
+	@Synchronized
+	fun shaders(program: Int): List<Pair<Int, String>>? {
+		if (uncacheablePrograms.contains(program)) {
+			return null
+		}
+		val shaders = programShaders[program]
+		if (shaders.isNullOrEmpty()) {
+			return null
+		}
+		return shaders.map { shader ->
+			val source = shaderSources[shader] ?: return null
+			Pair(shaderTypes.get(shader), source)
+		}
+	}
+
+	@Synchronized
+	fun attributes(program: Int): Map<String, Int> {
+		return programAttributes[program]?.let { HashMap(it) } ?: emptyMap()
+	}
+
+	/**
+	 * A shader still attached keeps its source and deferred compile until it is detached, a program
+	 * relinking from it compiles it then.
+	 */
+	@Synchronized
+	fun deleteShader(shader: Int) {
+		deletedShaders.add(shader)
+		forgetIfDeleted(shader)
+	}
+
+	@Synchronized
+	fun deleteProgram(program: Int) {
+		val shaders = programShaders[program]
+		programShaders.remove(program)
+		programAttributes.remove(program)
+		uncacheablePrograms.remove(program)
+		shaders?.forEach { forgetIfDeleted(it) }
+	}
+
+	private fun forgetIfDeleted(shader: Int) {
+		if (!deletedShaders.contains(shader)) {
+			return
+		}
+		for (i in 0 until programShaders.size()) {
+			if (programShaders.valueAt(i).contains(shader)) {
+				return
+			}
+		}
+		deletedShaders.remove(shader)
+		shaderTypes.delete(shader)
+		shaderSources.remove(shader)
+		verifiedShaders.remove(shader)
+		pendingCompiles.remove(shader)
+	}
+}
@@ -0,0 +1,76 @@
+package org.nativescript.canvas
+
+import android.util.Log
+import java.util.ArrayDeque
+import java.util.concurrent.LinkedBlockingQueue
+import java.util.concurrent.ThreadFactory
+import java.util.concurrent.ThreadPoolExecutor
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Renders every [TNSSVG] on one pool sized to the cores instead of a thread per view. Each view
+ * gets a [Queue], its tasks run in order and one at a time while different views render in
+ * parallel.
+ */
+internal object SVGRenderScheduler {
+	private const val TAG = "SVGRenderScheduler"
+	private const val KEEP_ALIVE_SECONDS = 30L
+
+	private val threadCount = AtomicInteger()
+	private val poolSize = maxOf(1, Runtime.getRuntime().availableProcessors())
+
+	private val pool = ThreadPoolExecutor(
+		poolSize,
+		poolSize,
+		KEEP_ALIVE_SECONDS,
+		TimeUnit.SECONDS,
+		LinkedBlockingQueue(),
+		ThreadFactory { runnable ->
+			Thread(runnable, "CanvasSVG-${threadCount.incrementAndGet()}").apply {
+				isDaemon = true
+			}
+		}
+	).apply {
+		// idle screens don't keep the threads around
+		allowCoreThreadTimeOut(true)
+	}
+
+	/**
+	 * Serial queue on the shared pool. After each task the queue goes to the back of the pool's
+	 * queue, so a view with a lot of work doesn't hold a thread while others wait.
+	 */
+	class Queue {
+		private val tasks = ArrayDeque<Runnable>()
+		private var scheduled = false
+
+		fun execute(task: Runnable) {
+			synchronized(this) {
+				tasks.addLast(task)
+				if (scheduled) {
+					return
+				}
+				scheduled = true
+			}
+			pool.execute(this::runNext)
+		}
+
+		private fun runNext() {
+			val task = synchronized(this) {
+				tasks.pollFirst()
+			}
+			try {
+				task?.run()
+			} catch (e: Throwable) {
+				Log.e(TAG, "SVG render task failed", e)
+			}
+			synchronized(this) {
+				if (tasks.isEmpty()) {
+					scheduled = false
+					return
+				}
+			}
+			pool.execute(this::runNext)
+		}
+	}
+}
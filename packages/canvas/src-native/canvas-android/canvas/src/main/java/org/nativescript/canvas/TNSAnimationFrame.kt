@@ -0,0 +1,247 @@
+package org.nativescript.canvas
+
+import android.os.Handler
+import android.os.Looper
+import android.os.SystemClock
+import android.view.Choreographer
+import kotlin.math.roundToInt
+
+/**
+ * requestAnimationFrame on one Choreographer callback shared with the canvases. Callbacks run in
+ * the order they were requested with the vsync timestamp of the frame, the ones requested while a
+ * frame runs wait for the next one. Frame listeners ([TNSCanvas]) run after the callbacks so what
+ * they drew is flushed in the same frame. Nothing is posted while there is nothing to run.
+ *
+ * Everything runs on the main thread.
+ */
+object TNSAnimationFrame : Choreographer.FrameCallback {
+	interface Callback {
+		fun onAnimationFrame(timestamp: Double)
+	}
+
+	interface FrameListener {
+		fun onFrame(frameTimeNanos: Long)
+	}
+
+	/**
+	 * Timings of the frames run since the last reset, times are in milliseconds. The gpu ones are
+	 * of the WebGL and GPU 2D contexts' frames while [isGpuTimingEnabled], they arrive a few frames
+	 * late and stay 0 where timer queries aren't supported. A frame whose gpu time is above its
+	 * callback and flush time is GPU bound.
+	 */
+	class FrameStats(
+		val frames: Int,
+		val droppedFrames: Int,
+		val callbackTime: Double,
+		val averageCallbackTime: Double,
+		val maxCallbackTime: Double,
+		val flushTime: Double,
+		val averageFlushTime: Double,
+		val maxFlushTime: Double,
+		val frameInterval: Double,
+		val gpuFrames: Int,
+		val gpuTime: Double,
+		val averageGpuTime: Double,
+		val maxGpuTime: Double,
+		val gpuPassTimes: Map<String, Double>
+	)
+
+	private const val DEFAULT_VSYNC_NANOS = 16_666_667L
+	private const val NANOS_PER_MILLI = 1_000_000.0
+
+	private var nextId = 1
+	private var callbacks = LinkedHashMap<Int, Callback>()
+	private var running = LinkedHashMap<Int, Callback>()
+	private val listeners = ArrayList<FrameListener>()
+	private var posted = false
+
+	// frame time of the previous vsync while posted continuously, 0 after going idle
+	private var lastVsync = 0L
+	private var lastRun = 0L
+	private var vsyncNanos = DEFAULT_VSYNC_NANOS
+
+	private var frames = 0
+	private var droppedFrames = 0
+	private var callbackTime = 0.0
+	private var totalCallbackTime = 0.0
+	private var maxCallbackTime = 0.0
+	private var flushTime = 0.0
+	private var totalFlushTime = 0.0
+	private var maxFlushTime = 0.0
+	private var frameInterval = 0.0
+	private var gpuFrames = 0
+	private var gpuTime = 0.0
+	private var totalGpuTime = 0.0
+	private var maxGpuTime = 0.0
+	private var gpuPassTimes: Map<String, Double> = emptyMap()
+
+	private val mainHandler = Handler(Looper.getMainLooper())
+
+	/** Measures the GPU time of every frame with timer queries, see [GpuTimers]. */
+	@JvmStatic
+	@Volatile
+	var isGpuTimingEnabled = false
+
+	/** Frames per second callbacks run at, 0 for the display's rate. Vsyncs in between are skipped. */
+	@JvmStatic
+	var targetFrameRate = 0
+		set(value) {
+			field = maxOf(0, value)
+			lastRun = 0
+		}
+
+	/** Runs [callback] with the timestamp of the next frame in milliseconds, returns the id to cancel it with. */
+	@JvmStatic
+	fun requestAnimationFrame(callback: Callback): Int {
+		val id = nextId++
+		callbacks[id] = callback
+		post()
+		return id
+	}
+
+	@JvmStatic
+	fun cancelAnimationFrame(id: Int) {
+		// also cancels a callback of the running frame that hasn't run yet
+		callbacks.remove(id)
+		running.remove(id)
+	}
+
+	@JvmStatic
+	fun addFrameListener(listener: FrameListener) {
+		if (!listeners.contains(listener)) {
+			listeners.add(listener)
+			post()
+		}
+	}
+
+	@JvmStatic
+	fun removeFrameListener(listener: FrameListener) {
+		listeners.remove(listener)
+	}
+
+	@JvmStatic
+	fun getStats(): FrameStats {
+		val count = maxOf(frames, 1).toDouble()
+		return FrameStats(
+			frames,
+			droppedFrames,
+			callbackTime,
+			totalCallbackTime / count,
+			maxCallbackTime,
+			flushTime,
+			totalFlushTime / count,
+			maxFlushTime,
+			frameInterval,
+			gpuFrames,
+			gpuTime,
+			totalGpuTime / maxOf(gpuFrames, 1),
+			maxGpuTime,
+			gpuPassTimes
+		)
+	}
+
+	@JvmStatic
+	fun resetStats() {
+		frames = 0
+		droppedFrames = 0
+		callbackTime = 0.0
+		totalCallbackTime = 0.0
+		maxCallbackTime = 0.0
+		flushTime = 0.0
+		totalFlushTime = 0.0
+		maxFlushTime = 0.0
+		gpuFrames = 0
+		gpuTime = 0.0
+		totalGpuTime = 0.0
+		maxGpuTime = 0.0
+		gpuPassTimes = emptyMap()
+	}
+
+	// from the GL threads, the stats are only touched on the main thread
+	internal fun reportGpuFrame(nanos: Long, passes: Map<String, Long>) {
+		mainHandler.post {
+			gpuFrames++
+			gpuTime = nanos / NANOS_PER_MILLI
+			totalGpuTime += gpuTime
+			maxGpuTime = maxOf(maxGpuTime, gpuTime)
+			gpuPassTimes = passes.mapValues { it.value / NANOS_PER_MILLI }
+		}
+	}
+
+	override fun doFrame(frameTimeNanos: Long) {
+		posted = false
+		if (lastVsync != 0L) {
+			val delta = frameTimeNanos - lastVsync
+			if (delta > 0) {
+				val missed = (delta.toDouble() / vsyncNanos).roundToInt() - 1
+				if (missed > 0) {
+					droppedFrames += missed
+				} else {
+					// the display's refresh interval, averaged over the frames that weren't late
+					vsyncNanos = (vsyncNanos * 7 + delta) / 8
+				}
+			}
+		}
+		lastVsync = frameTimeNanos
+
+		if (shouldRun(frameTimeNanos)) {
+			frameInterval = if (lastRun != 0L) (frameTimeNanos - lastRun) / NANOS_PER_MILLI else vsyncNanos / NANOS_PER_MILLI
+			lastRun = frameTimeNanos
+			runFrame(frameTimeNanos)
+		}
+
+		if (callbacks.isNotEmpty() || listeners.isNotEmpty()) {
+			post()
+		} else {
+			lastVsync = 0
+			lastRun = 0
+		}
+	}
+
+	private fun shouldRun(frameTimeNanos: Long): Boolean {
+		if (targetFrameRate <= 0 || lastRun == 0L) {
+			return true
+		}
+		val target = 1_000_000_000L / targetFrameRate
+		// half a vsync of slack so a 30fps target on a 60hz display doesn't drift to 20fps
+		return frameTimeNanos - lastRun >= target - vsyncNanos / 2
+	}
+
+	private fun runFrame(frameTimeNanos: Long) {
+		val start = SystemClock.elapsedRealtimeNanos()
+		val timestamp = frameTimeNanos / NANOS_PER_MILLI
+		// swapped so callbacks requested from a callback go to the next frame
+		val current = callbacks
+		callbacks = running
+		running = current
+		while (running.isNotEmpty()) {
+			val iterator = running.entries.iterator()
+			val entry = iterator.next()
+			iterator.remove()
+			entry.value.onAnimationFrame(timestamp)
+		}
+		val callbacksDone = SystemClock.elapsedRealtimeNanos()
+
+		for (listener in listeners.toTypedArray()) {
+			listener.onFrame(frameTimeNanos)
+		}
+		val end = SystemClock.elapsedRealtimeNanos()
+		TNSProfiler.record("frame", end - start)
+		TNSStats.endFrame()
+
+		frames++
+		callbackTime = (callbacksDone - start) / NANOS_PER_MILLI
+		totalCallbackTime += callbackTime
+		maxCallbackTime = maxOf(maxCallbackTime, callbackTime)
+		flushTime = (end - callbacksDone) / NANOS_PER_MILLI
+		totalFlushTime += flushTime
+		maxFlushTime = maxOf(maxFlushTime, flushTime)
+	}
+
+	private fun post() {
+		if (!posted) {
+			posted = true
+			Choreographer.getInstance().postFrameCallback(this)
+		}
+	}
+}
@@ -14,8 +14,6 @@ import android.os.*
 import android.util.AttributeSet
 import android.util.Base64
 import android.util.Log
-import android.view.Choreographer
-import android.view.Choreographer.FrameCallback
 import android.view.ViewGroup
 import android.widget.FrameLayout
 import androidx.core.text.TextUtilsCompat
@@ -34,8 +32,22 @@ import java.util.concurrent.TimeUnit
 /**
  * Created by triniwiz on 3/29/20
  */
-class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
-	internal var nativeContext: Long = 0L
+class TNSCanvas : FrameLayout, TNSAnimationFrame.FrameListener, ActivityLifecycleCallbacks {
+	private var contextHandle: GC.NativeHandle? = null
+
+	/**
+	 * The native 2D context, released once this view is collected or a new context replaces it.
+	 */
+	internal var nativeContext: Long
+		get() = contextHandle?.value ?: 0L
+		set(value) {
+			contextHandle?.release()
+			contextHandle = if (value != 0L) {
+				GC.register(this, GC.HandleType.Context, value) { nativeDestroyContext(it) }
+			} else {
+				null
+			}
+		}
 	internal var surface: GLView? = null
 	internal var cpuView: CPUView? = null
 	var isHandleInvalidationManually = false
@@ -130,12 +142,21 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 	@JvmField
 	internal var mDepthMask = true
 
+	internal val glState = GLStateCache()
+
+	internal val vertexArrays = VertexArrayCache()
+
+	internal val readbacks = PixelReadbacks()
+
+	internal val gpuTimers = if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN_MR2) GpuTimers() else null
+
 	@JvmField
 	internal var glVersion = 2
 
 	private lateinit var mainHandler: Handler
 
-	override fun doFrame(frameTimeNanos: Long) {
+	// runs after this frame's animation frame callbacks so what they drew goes out in the same frame
+	override fun onFrame(frameTimeNanos: Long) {
 		if (!isHandleInvalidationManually) {
 			// Only pending state flag is accepted
 			if (invalidateState == INVALIDATE_STATE_PENDING) {
@@ -143,7 +164,11 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 				flush()
 			}
 		}
-		Choreographer.getInstance().postFrameCallback(this)
+		if (readbacks.hasPending) {
+			queueEvent {
+				readbacks.poll()
+			}
+		}
 	}
 
 	constructor(context: Context) : super(context, null) {
@@ -285,11 +310,6 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 	@Synchronized
 	@Throws(Throwable::class)
 	protected fun finalize() {
-		if (nativeContext != 0L) {
-			nativeDestroyContext(nativeContext)
-			nativeContext = 0
-		}
-
 		if (useCpu) {
 			if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN_MR2) {
 				cpuHandlerThread?.quitSafely()
@@ -305,15 +325,16 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 
 	fun queueEvent(runnable: Runnable?) {
 		runnable?.let {
+			val task = if (TNSProfiler.isEnabled) TNSProfiler.timed(it) else it
 			if (useCpu) {
 				if (!cpuHandlerThread!!.isAlive || cpuHandlerThread!!.isInterrupted) {
 					cpuHandlerThread = null
 					cpuHandler = null
 					initCPUThread()
 				}
-				cpuHandler?.post(it)
+				cpuHandler?.post(task)
 			} else {
-				surface?.queueEvent(it)
+				surface?.queueEvent(task)
 			}
 		}
 	}
@@ -426,6 +447,40 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 		return emptyByteArray
 	}
 
+	/**
+	 * Snapshots a 2D canvas into a native image handle that another context can draw without the
+	 * pixels going through the JVM. Returns 0 for other context types or when the snapshot timed out.
+	 */
+	internal fun snapshotImage(): Long {
+		if (contextType != ContextType.CANVAS) {
+			return 0
+		}
+		val lock = CountDownLatch(1)
+		val image = longArrayOf(0)
+		var abandoned = false
+		queueEvent {
+			val snapshot = nativeSnapshotImage(nativeContext)
+			synchronized(image) {
+				if (abandoned) {
+					nativeDestroySnapshotImage(snapshot)
+				} else {
+					image[0] = snapshot
+				}
+			}
+			lock.countDown()
+		}
+		try {
+			lock.await(2, TimeUnit.SECONDS)
+		} catch (ignore: InterruptedException) {
+		}
+		synchronized(image) {
+			if (image[0] == 0L) {
+				abandoned = true
+			}
+			return image[0]
+		}
+	}
+
 	private val defaultMatrix = Matrix()
 	private val invertMatrix = Matrix()
 	private val invertFlipMatrix = Matrix()
@@ -581,6 +636,7 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 	private var needRenderRequest = 0
 
 	fun resizeViewPort() {
+		glState.invalidateViewport()
 		queueEvent { GLES20.glViewport(0, 0, width, height) }
 	}
 
@@ -855,13 +911,13 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 	override fun onDetachedFromWindow() {
 		super.onDetachedFromWindow()
 		isPaused = true
-		Choreographer.getInstance().removeFrameCallback(this)
+		TNSAnimationFrame.removeFrameListener(this)
 	}
 
 	override fun onAttachedToWindow() {
 		super.onAttachedToWindow()
 		isPaused = false
-		Choreographer.getInstance().postFrameCallback(this)
+		TNSAnimationFrame.addFrameListener(this)
 	}
 
 	interface Listener {
@@ -983,6 +1039,12 @@ class TNSCanvas : FrameLayout, FrameCallback, ActivityLifecycleCallbacks {
 		@JvmStatic
 		private external fun nativeToData(context: Long): ByteArray?
 
+		@JvmStatic
+		private external fun nativeSnapshotImage(context: Long): Long
+
+		@JvmStatic
+		private external fun nativeDestroySnapshotImage(image: Long)
+
 		@JvmStatic
 		private external fun nativeSnapshotCanvas(context: Long): ByteArray
 
@@ -14,11 +14,6 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 
 	private val lock = ResettableCountDownLatch(1)
 
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		nativeDestroy(canvas.nativeContext)
-	}
-
 	var direction: TNSTextDirection
 		get() {
 			var value = TNSTextDirection.Ltr
@@ -530,6 +525,18 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 	}
 
 
+	/**
+	 * Draws [svg] scaled to [width] x [height] from a rasterized atlas shared by every canvas, so
+	 * repeated icons are rasterized once per size and [tint] (ARGB, 0 for none).
+	 */
+	@JvmOverloads
+	fun drawSVG(svg: String, x: Float, y: Float, width: Float, height: Float, tint: Int = 0) {
+		canvas.queueEvent {
+			nativeDrawSVG(canvas.nativeContext, svg, x, y, width, height, tint)
+			updateCanvas()
+		}
+	}
+
 	@JvmOverloads
 	fun strokeText(text: String, x: Float, y: Float, width: Float = 0f) {
 		canvas.queueEvent {
@@ -1008,8 +1015,55 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		}
 	}
 
+	/**
+	 * Draws a 2D canvas straight from its native surface. Drawing a canvas onto itself uses the
+	 * surface snapshot as is, other canvases hand over a native image so the pixels never reach the JVM.
+	 * Returns false when [image] is not a 2D canvas.
+	 */
+	private fun drawCanvas(
+		image: TNSCanvas,
+		sx: Float,
+		sy: Float,
+		sWidth: Float,
+		sHeight: Float,
+		dx: Float,
+		dy: Float,
+		dWidth: Float,
+		dHeight: Float
+	): Boolean {
+		if (image.contextType != TNSCanvas.ContextType.CANVAS) {
+			return false
+		}
+		if (image === canvas) {
+			canvas.queueEvent {
+				nativeDrawImageWithSelf(canvas.nativeContext, sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight)
+				updateCanvas()
+			}
+			return true
+		}
+		val snapshot = image.snapshotImage()
+		if (snapshot == 0L) {
+			return false
+		}
+		canvas.queueEvent {
+			nativeDrawImageWithSnapshot(
+				canvas.nativeContext,
+				snapshot,
+				sx,
+				sy,
+				sWidth,
+				sHeight,
+				dx,
+				dy,
+				dWidth,
+				dHeight
+			)
+			updateCanvas()
+		}
+		return true
+	}
+
 	fun drawImage(image: TNSCanvas, dx: Float, dy: Float) {
-		val ss = image.snapshot()
 		var width = image.width
 		var height = image.height
 		if (width == 0) {
@@ -1032,6 +1086,10 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		}
 		val finalWidth = width.toFloat()
 		val finalHeight = height.toFloat()
+		if (drawCanvas(image, 0f, 0f, finalWidth, finalHeight, dx, dy, finalWidth, finalHeight)) {
+			return
+		}
+		val ss = image.snapshot()
 		canvas.queueEvent {
 			nativeDrawImageDxDy(
 				canvas.nativeContext,
@@ -1108,7 +1166,6 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 	}
 
 	fun drawImage(image: TNSCanvas, dx: Float, dy: Float, dWidth: Float, dHeight: Float) {
-		val ss = image.snapshot()
 		var width = image.width
 		var height = image.height
 		if (width == 0) {
@@ -1131,6 +1188,10 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		}
 		val finalWidth = width.toFloat()
 		val finalHeight = height.toFloat()
+		if (drawCanvas(image, 0f, 0f, finalWidth, finalHeight, dx, dy, dWidth, dHeight)) {
+			return
+		}
+		val ss = image.snapshot()
 		canvas.queueEvent {
 			nativeDrawImageDxDyDwDy(
 				canvas.nativeContext,
@@ -1222,7 +1283,6 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		dWidth: Float,
 		dHeight: Float
 	) {
-		val ss = image.snapshot()
 		var width = image.width
 		var height = image.height
 		if (image.width == 0) {
@@ -1245,6 +1305,10 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		}
 		val finalWidth = width.toFloat()
 		val finalHeight = height.toFloat()
+		if (drawCanvas(image, sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight)) {
+			return
+		}
+		val ss = image.snapshot()
 		canvas.queueEvent {
 			nativeDrawImage(
 				canvas.nativeContext,
@@ -1388,11 +1452,94 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 	}
 
 
+	/**
+	 * Draws [count] sprites of [asset] in as few draws as possible. [sprites] holds
+	 * [IMAGE_BATCH_SPRITE_SIZE] floats per sprite: the source rect's x, y, width and height, the
+	 * destination rect's, a rotation in radians about the destination's center and an alpha.
+	 * Sprites scaled the same on both axes go out in one atlas draw. A negative destination width or
+	 * height mirrors the sprite.
+	 *
+	 * The sprites are copied, the array can be refilled for the next frame right away.
+	 */
+	@JvmOverloads
+	fun drawImageBatch(asset: TNSImageAsset, sprites: FloatArray, count: Int = sprites.size / IMAGE_BATCH_SPRITE_SIZE) {
+		val data = spriteData(sprites, count) ?: return
+		canvas.queueEvent {
+			nativeDrawImageBatchWithAsset(canvas.nativeContext, asset.nativeImageAsset, data, data.size / IMAGE_BATCH_SPRITE_SIZE)
+			updateCanvas()
+		}
+	}
+
+	@JvmOverloads
+	fun drawImageBatch(bitmap: TNSImageBitmap, sprites: FloatArray, count: Int = sprites.size / IMAGE_BATCH_SPRITE_SIZE) {
+		val data = spriteData(sprites, count) ?: return
+		canvas.queueEvent {
+			nativeDrawImageBatchWithAsset(canvas.nativeContext, bitmap.nativeImageAsset, data, data.size / IMAGE_BATCH_SPRITE_SIZE)
+			updateCanvas()
+		}
+	}
+
+	@JvmOverloads
+	fun drawImageBatch(image: Bitmap?, sprites: FloatArray, count: Int = sprites.size / IMAGE_BATCH_SPRITE_SIZE) {
+		image ?: return
+		val data = spriteData(sprites, count) ?: return
+		canvas.queueEvent {
+			nativeDrawImageBatchWithBitmap(
+				canvas.nativeContext,
+				image,
+				image.width.toFloat(),
+				image.height.toFloat(),
+				data,
+				data.size / IMAGE_BATCH_SPRITE_SIZE
+			)
+			updateCanvas()
+		}
+	}
+
+	private fun spriteData(sprites: FloatArray, count: Int): FloatArray? {
+		val size = minOf(count, sprites.size / IMAGE_BATCH_SPRITE_SIZE) * IMAGE_BATCH_SPRITE_SIZE
+		if (size <= 0) {
+			return null
+		}
+		return sprites.copyOf(size)
+	}
+
 	@JvmOverloads
 	fun measureText(text: String? = ""): TNSTextMetrics {
 		return TNSTextMetrics(nativeMeasureText(canvas.nativeContext, text ?: ""))
 	}
 
+	/**
+	 * Measures all [texts] in one native call. Returns [TEXT_METRICS_SIZE] floats per string in the
+	 * order of the [TNSTextMetrics] properties, starting with width.
+	 */
+	fun measureTextBatch(texts: Array<String?>): FloatArray {
+		return nativeMeasureTextBatch(canvas.nativeContext, texts)
+	}
+
+	/**
+	 * Wraps [text] to [maxWidth] (no wrapping when 0) and draws it with the current fill style,
+	 * font, textAlign and direction. [lineHeight] is a multiple of the font size, 0 uses the font's own.
+	 */
+	@JvmOverloads
+	fun fillParagraph(text: String, x: Float, y: Float, maxWidth: Float = 0f, lineHeight: Float = 0f) {
+		canvas.queueEvent {
+			nativeFillParagraph(canvas.nativeContext, text, x, y, maxWidth, lineHeight)
+			updateCanvas()
+		}
+	}
+
+	/**
+	 * Lays out [text] like [fillParagraph] and returns the packed metrics:
+	 * width, height, longestLine, minIntrinsicWidth, maxIntrinsicWidth, alphabeticBaseline,
+	 * ideographicBaseline, lineCount followed by startIndex, endIndex, ascent, descent, height,
+	 * width, left and baseline for each line.
+	 */
+	@JvmOverloads
+	fun measureParagraph(text: String, maxWidth: Float = 0f, lineHeight: Float = 0f): FloatArray {
+		return nativeMeasureParagraph(canvas.nativeContext, text, maxWidth, lineHeight)
+	}
+
 	fun createImageData(width: Int, height: Int): TNSImageData {
 		return TNSImageData(width, height, nativeCreateImageData(width, height))
 	}
@@ -1492,9 +1639,10 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 
 	companion object {
 		const val TAG = "CanvasRenderingContext"
+		const val TEXT_METRICS_SIZE = 12
 
-		@JvmStatic
-		private external fun nativeDestroy(context: Long)
+		// floats per sprite of drawImageBatch, IMAGE_BATCH_SPRITE_SIZE in common/context/drawing_images
+		const val IMAGE_BATCH_SPRITE_SIZE = 10
 
 		@JvmStatic
 		private external fun nativeSetDirection(context: Long, direction: Int)
@@ -1589,6 +1737,17 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 			height: Float
 		)
 
+		@JvmStatic
+		private external fun nativeDrawSVG(
+			context: Long,
+			svg: String,
+			x: Float,
+			y: Float,
+			width: Float,
+			height: Float,
+			tint: Int
+		)
+
 		@JvmStatic
 		private external fun nativeFillText(
 			context: Long,
@@ -1821,6 +1980,33 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 			y: Float
 		)
 
+		@JvmStatic
+		private external fun nativeDrawImageWithSnapshot(
+			context: Long,
+			snapshot: Long,
+			sx: Float,
+			sy: Float,
+			sWidth: Float,
+			sHeight: Float,
+			dx: Float,
+			dy: Float,
+			dWidth: Float,
+			dHeight: Float
+		)
+
+		@JvmStatic
+		private external fun nativeDrawImageWithSelf(
+			context: Long,
+			sx: Float,
+			sy: Float,
+			sWidth: Float,
+			sHeight: Float,
+			dx: Float,
+			dy: Float,
+			dWidth: Float,
+			dHeight: Float
+		)
+
 		@JvmStatic
 		private external fun nativeDrawImageDxDy(
 			context: Long,
@@ -1920,6 +2106,19 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 			dHeight: Float
 		)
 
+		@JvmStatic
+		private external fun nativeDrawImageBatchWithAsset(context: Long, asset: Long, sprites: FloatArray, count: Int)
+
+		@JvmStatic
+		private external fun nativeDrawImageBatchWithBitmap(
+			context: Long,
+			bitmap: Bitmap,
+			width: Float,
+			height: Float,
+			sprites: FloatArray,
+			count: Int
+		)
+
 		@JvmStatic
 		private external fun nativeDrawImageWithAsset(
 			context: Long,
@@ -1989,6 +2188,27 @@ class TNSCanvasRenderingContext2D internal constructor(val canvas: TNSCanvas) :
 		@JvmStatic
 		private external fun nativeMeasureText(context: Long, text: String): Long
 
+		@JvmStatic
+		private external fun nativeMeasureTextBatch(context: Long, texts: Array<String?>): FloatArray
+
+		@JvmStatic
+		private external fun nativeFillParagraph(
+			context: Long,
+			text: String,
+			x: Float,
+			y: Float,
+			maxWidth: Float,
+			lineHeight: Float
+		)
+
+		@JvmStatic
+		private external fun nativeMeasureParagraph(
+			context: Long,
+			text: String,
+			maxWidth: Float,
+			lineHeight: Float
+		): FloatArray
+
 		@JvmStatic
 		private external fun nativeCreateImageData(width: Int, height: Int): Long
 
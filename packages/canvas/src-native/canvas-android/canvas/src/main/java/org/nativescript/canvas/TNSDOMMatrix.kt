@@ -3,9 +3,17 @@ package org.nativescript.canvas
 /**
  * Created by triniwiz on 3/27/20
  */
-class TNSDOMMatrix(internal var matrix: Long) {
+class TNSDOMMatrix(matrix: Long) {
 	constructor() : this(nativeInit())
 
+	private val handle = GC.register(this, GC.HandleType.Matrix, matrix) { nativeDestroy(it) }
+
+	internal var matrix: Long
+		get() = handle.value
+		set(value) {
+			handle.value = value
+		}
+
 	var a: Float
 		set(value) {
 			nativeSetA(matrix, value)
@@ -185,12 +193,6 @@ class TNSDOMMatrix(internal var matrix: Long) {
 			return nativeM44(matrix)
 		}
 
-	@Synchronized
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		nativeDestroy(matrix)
-	}
-
 	companion object {
 		@JvmStatic
 		private external fun nativeInit(): Long
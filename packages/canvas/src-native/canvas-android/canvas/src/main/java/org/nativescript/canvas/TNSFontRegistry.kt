@@ -0,0 +1,45 @@
+package org.nativescript.canvas
+
+/**
+ * App wide custom fonts, shared by every 2D context. Register fonts once at startup, they are
+ * matched by family name before the system fonts when resolving the context font.
+ */
+object TNSFontRegistry {
+	/**
+	 * Registers the font file at [path] under [family], or the family name stored in the font when null.
+	 * The file is memory mapped rather than read into memory.
+	 */
+	@JvmStatic
+	@JvmOverloads
+	fun registerFont(path: String, family: String? = null): Boolean {
+		return nativeRegisterFontFromPath(path, family)
+	}
+
+	@JvmStatic
+	@JvmOverloads
+	fun registerFont(bytes: ByteArray, family: String? = null): Boolean {
+		return nativeRegisterFontFromBytes(bytes, family)
+	}
+
+	@JvmStatic
+	fun unregisterFont(family: String): Boolean {
+		return nativeUnregisterFont(family)
+	}
+
+	@JvmStatic
+	fun clear() {
+		nativeClear()
+	}
+
+	@JvmStatic
+	private external fun nativeRegisterFontFromPath(path: String, family: String?): Boolean
+
+	@JvmStatic
+	private external fun nativeRegisterFontFromBytes(bytes: ByteArray, family: String?): Boolean
+
+	@JvmStatic
+	private external fun nativeUnregisterFont(family: String): Boolean
+
+	@JvmStatic
+	private external fun nativeClear()
+}
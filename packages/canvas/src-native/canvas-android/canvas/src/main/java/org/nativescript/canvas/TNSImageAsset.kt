@@ -21,7 +21,10 @@ import java.util.concurrent.TimeUnit
  * Created by triniwiz on 5/4/20
  */
 class TNSImageAsset {
-	internal var nativeImageAsset: Long
+	private val handle = GC.register(this, GC.HandleType.ImageAsset, nativeInit()) { nativeDestroy(it) }
+
+	internal val nativeImageAsset: Long
+		get() = handle.value
 
 	interface Callback {
 		fun onSuccess(value: Any?)
@@ -287,12 +290,6 @@ class TNSImageAsset {
 		}
 	}
 
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		nativeDestroy(nativeImageAsset)
-		nativeImageAsset = 0
-	}
-
 	internal class ByteArrayOutputStream2 : ByteArrayOutputStream {
 		constructor() : super() {}
 		constructor(size: Int) : super(size) {}
@@ -371,8 +368,4 @@ class TNSImageAsset {
 
 		private val executorService = Executors.newCachedThreadPool()
 	}
-
-	init {
-		nativeImageAsset = nativeInit()
-	}
 }
@@ -14,7 +14,12 @@ import java.util.concurrent.Executors
 
 class TNSImageBitmap internal constructor(asset: Long) {
 
-	var nativeImageAsset: Long = asset
+	private val handle = GC.register(this, GC.HandleType.ImageAsset, asset) {
+		TNSImageAsset.nativeDestroyImpl(it)
+	}
+
+	val nativeImageAsset: Long
+		get() = handle.value
 
 	val width: Int
 		get() = if (nativeImageAsset == 0L) {
@@ -26,17 +31,7 @@ class TNSImageBitmap internal constructor(asset: Long) {
 		} else TNSImageAsset.nativeGetHeightImpl(nativeImageAsset)
 
 	fun close() {
-		TNSImageAsset.nativeDestroyImpl(nativeImageAsset)
-		nativeImageAsset = 0
-	}
-
-
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		if (nativeImageAsset != 0L) {
-			TNSImageAsset.nativeDestroyImpl(nativeImageAsset)
-			nativeImageAsset = 0
-		}
+		handle.release()
 	}
 
 	interface Callback {
@@ -5,12 +5,18 @@ import java.nio.ByteBuffer
 /**
  * Created by triniwiz on 2019-08-04
  */
-class TNSImageData(val width: Int, val height: Int, internal var nativeImageData: Long) {
+class TNSImageData(val width: Int, val height: Int, nativeImageData: Long) {
 	private var dataStore: ByteBuffer? = null
+	private var handle: GC.NativeHandle? = null
+
+	internal val nativeImageData: Long
+		get() = handle?.value ?: -1L
 
 	init {
 		if (nativeImageData == -1L) {
 			dataStore = ByteBuffer.allocateDirect(width * height * 4)
+		} else {
+			handle = GC.register(this, GC.HandleType.ImageData, nativeImageData) { nativeDestroy(it) }
 		}
 	}
 
@@ -22,11 +28,6 @@ class TNSImageData(val width: Int, val height: Int, internal var nativeImageData
 			return nativeData(nativeImageData)
 		}
 
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		nativeDestroy(nativeImageData)
-	}
-
 	companion object {
 		@JvmStatic
 		private external fun nativeData(imageData: Long): ByteBuffer
@@ -4,18 +4,28 @@ package org.nativescript.canvas
  * Created by triniwiz on 2019-08-11
  */
 class TNSPath2D {
+	private val handle: GC.NativeHandle
+
 	internal var path: Long
+		get() = handle.value
+		set(value) {
+			handle.value = value
+		}
 
 	constructor() {
-		path = nativeInit()
+		handle = register(nativeInit())
 	}
 
 	constructor(path2D: TNSPath2D) {
-		path = nativeCreateWithPath(path2D.path)
+		handle = register(nativeCreateWithPath(path2D.path))
 	}
 
 	constructor(data: String) {
-		path = nativeCreateWithString(data)
+		handle = register(nativeCreateWithString(data))
+	}
+
+	private fun register(path: Long): GC.NativeHandle {
+		return GC.register(this, GC.HandleType.Path, path) { nativeDestroy(it) }
 	}
 
 	fun addPath(path2D: TNSPath2D) {
@@ -177,12 +187,6 @@ class TNSPath2D {
 		nativeQuadraticCurveTo(path, cpx, cpy, x, y)
 	}
 
-	@Throws(Throwable::class)
-	protected fun finalize() {
-		nativeDestroy(path)
-		path = 0
-	}
-
 	companion object {
 		@JvmStatic
 		private external fun nativeInit(): Long
@@ -0,0 +1,63 @@
+package org.nativescript.canvas
+
+/**
+ * Timings of the native hot paths, the GL thread queue and the animation frames, dumped as Chrome
+ * trace JSON to open in chrome://tracing or Perfetto. Only records when the native library was
+ * built with the `profiler` feature, [isEnabled] stays false otherwise.
+ */
+object TNSProfiler {
+	@Volatile
+	private var enabled = false
+
+	@JvmStatic
+	val isEnabled: Boolean
+		get() = enabled
+
+	/** Turns recording on or off, returns whether it is on. */
+	@JvmStatic
+	fun setEnabled(enabled: Boolean): Boolean {
+		this.enabled = nativeSetEnabled(enabled)
+		return this.enabled
+	}
+
+	@JvmStatic
+	fun dump(): String {
+		return nativeDump()
+	}
+
+	@JvmStatic
+	fun clear() {
+		nativeClear()
+	}
+
+	/** Records [name] as an event that took [durationNanos] and ended now. */
+	@JvmStatic
+	fun record(name: String, durationNanos: Long) {
+		if (enabled) {
+			nativeRecord(name, durationNanos)
+		}
+	}
+
+	// times how long the task waited for the GL thread and how long it ran
+	internal fun timed(task: Runnable): Runnable {
+		val queued = System.nanoTime()
+		return Runnable {
+			val start = System.nanoTime()
+			record("gl.queue_wait", start - queued)
+			task.run()
+			record("gl.task", System.nanoTime() - start)
+		}
+	}
+
+	@JvmStatic
+	private external fun nativeSetEnabled(enabled: Boolean): Boolean
+
+	@JvmStatic
+	private external fun nativeRecord(name: String, duration: Long)
+
+	@JvmStatic
+	private external fun nativeClear()
+
+	@JvmStatic
+	private external fun nativeDump(): String
+}
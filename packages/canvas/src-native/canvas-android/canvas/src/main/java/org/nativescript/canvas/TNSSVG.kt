@@ -7,7 +7,7 @@ import android.graphics.Color
 import android.graphics.Matrix
 import android.util.AttributeSet
 import android.view.View
-import java.util.concurrent.Executors
+import java.util.concurrent.atomic.AtomicBoolean
 
 /**
  * Created by triniwiz on 2019-08-05
@@ -18,11 +18,27 @@ class TNSSVG : View {
 	private var isInit = false
 	internal val lock = Any()
 	private var pendingInvalidate: Boolean = false
-	private val executor = Executors.newSingleThreadExecutor()
+	private val queue = SVGRenderScheduler.Queue()
+	@Volatile
 	private var src: String = ""
+	@Volatile
 	private var srcPath: String = ""
 	private var mMatrix = Matrix()
 
+	// retained document of src, created by the first edit and only touched on the queue.
+	// Until then src is drawn through the shared native cache
+	private var document: GC.NativeHandle? = null
+
+	// bumped by every draw request, a render of an older request stops at its next check
+	private val renderToken = GC.register(this, GC.HandleType.SVGRenderToken, nativeCreateRenderToken()) {
+		nativeDestroyRenderToken(it)
+	}
+	private val drawQueued = AtomicBoolean()
+
+	// size the surface still has to be created or resized to, applied by the next render
+	@Volatile
+	private var pendingSize: IntArray? = null
+
 	constructor(context: Context) : super(context, null) {
 		init(context)
 	}
@@ -60,82 +76,40 @@ class TNSSVG : View {
 			}
 		}
 
-	private var currentTask: java.util.concurrent.Future<*>? = null
-	private fun resize(w: Int, h: Int) {
-		currentTask?.cancel(true)
-		currentTask = executor.submit {
-			val metrics = resources.displayMetrics
-			TNSCanvas.nativeResizeCustomSurface(
-				svgCanvas,
-				w.toFloat(),
-				h.toFloat(),
-				metrics.density,
-				true,
-				metrics.densityDpi,
-			)
-
-			if (srcPath.isNotEmpty() || src.isNotEmpty()) {
-				if (srcPath.isNotEmpty()) {
-					nativeDrawSVGFromPath(svgCanvas, srcPath)
-				} else {
-					nativeDrawSVG(svgCanvas, src)
-				}
-				bitmap?.let {
-					TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, it)
-					handler!!.post {
-						pendingInvalidate = false
-						invalidate()
-					}
-				}
-			}
-			currentTask = null
-		}
-	}
-
-
 	override fun onSizeChanged(w: Int, h: Int, oldw: Int, oldh: Int) {
 		super.onSizeChanged(w, h, oldw, oldh)
 		if (w != 0 && h != 0) {
-			val metrics = resources.displayMetrics
-
 			bitmap = Bitmap.createBitmap(w, h, Bitmap.Config.ARGB_8888)
+			pendingSize = intArrayOf(w, h)
+			doDraw()
+		}
+	}
 
+	// runs on the queue
+	private fun applyPendingSize() {
+		val size = pendingSize ?: return
+		pendingSize = null
+		val metrics = resources.displayMetrics
+		synchronized(lock) {
 			if (svgCanvas == 0L) {
-				currentTask?.cancel(true)
-				currentTask = executor.submit {
-					synchronized(lock) {
-						svgCanvas = TNSCanvas.nativeInitContextWithCustomSurface(
-							w.toFloat(),
-							h.toFloat(),
-							metrics.density,
-							true,
-							Color.BLACK,
-							metrics.densityDpi.toFloat(),
-							TNSCanvas.direction.toNative()
-						)
-
-						if (srcPath.isNotEmpty() || src.isNotEmpty()) {
-
-							if (srcPath.isNotEmpty()) {
-								nativeDrawSVGFromPath(svgCanvas, srcPath)
-							} else {
-								nativeDrawSVG(svgCanvas, src)
-							}
-							bitmap?.let {
-								TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, it)
-								handler!!.post {
-									pendingInvalidate = false
-									invalidate()
-								}
-							}
-
-						}
-
-						currentTask = null
-					}
-				}
+				svgCanvas = TNSCanvas.nativeInitContextWithCustomSurface(
+					size[0].toFloat(),
+					size[1].toFloat(),
+					metrics.density,
+					true,
+					Color.BLACK,
+					metrics.densityDpi.toFloat(),
+					TNSCanvas.direction.toNative()
+				)
 			} else {
-				resize(w, h)
+				TNSCanvas.nativeResizeCustomSurface(
+					svgCanvas,
+					size[0].toFloat(),
+					size[1].toFloat(),
+					metrics.density,
+					true,
+					metrics.densityDpi,
+				)
 			}
 		}
 	}
@@ -147,63 +121,138 @@ class TNSSVG : View {
 	}
 
 	fun flush() {
-		bitmap?.let {
-			synchronized(lock) {
-				if (svgCanvas != 0L) {
-					currentTask?.cancel(true)
-					currentTask = executor.submit {
-						TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, it)
-						handler!!.post {
-							pendingInvalidate = false
-							invalidate()
-						}
-
-						currentTask = null
-					}
-				}
-			}
+		queue.execute {
+			flushBitmap()
+		}
+	}
+
+	// runs on the queue
+	private fun flushBitmap() {
+		val bitmap = bitmap ?: return
+		if (svgCanvas == 0L) {
+			return
+		}
+		TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, bitmap)
+		handler?.post {
+			pendingInvalidate = false
+			invalidate()
 		}
 	}
 
+	/**
+	 * Requests a render. Requests made before the queued render starts are coalesced into it and a
+	 * render already running is cancelled, so only the latest state is drawn.
+	 */
 	private fun doDraw() {
-		synchronized(lock) {
-			if (svgCanvas != 0L) {
-				currentTask?.cancel(true)
-				currentTask = executor.submit {
-					if (srcPath.isNotEmpty()) {
-						nativeDrawSVGFromPath(svgCanvas, srcPath)
-						bitmap?.let {
-							if (svgCanvas != 0L) {
-								TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, it)
-								handler!!.post {
-									pendingInvalidate = false
-									invalidate()
-								}
-							}
-						}
-					} else {
-						nativeDrawSVG(svgCanvas, src)
-						bitmap?.let {
-							if (svgCanvas != 0L) {
-								TNSCanvas.nativeCustomWithBitmapFlush(svgCanvas, it)
-								handler!!.post {
-									pendingInvalidate = false
-									invalidate()
-								}
-							}
-						}
-					}
-					currentTask = null
-				}
-			}
+		nativeCancelRender(renderToken.value)
+		if (!drawQueued.compareAndSet(false, true)) {
+			return
+		}
+		queue.execute {
+			drawQueued.set(false)
+			render()
+		}
+	}
+
+	// runs on the queue
+	private fun render() {
+		applyPendingSize()
+		if (svgCanvas == 0L) {
+			return
+		}
+		val token = renderToken.value
+		val drawn = when {
+			srcPath.isNotEmpty() -> nativeDrawSVGFromPath(svgCanvas, srcPath, token)
+			src.isNotEmpty() -> drawSrc(token)
+			else -> false
+		}
+		// a cancelled render left the surface as it was, the newer request redraws it
+		if (drawn) {
+			flushBitmap()
 		}
 	}
 
 	fun setSrc(src: String) {
 		this.src = src
+		queue.execute {
+			document?.release()
+			document = null
+		}
 		doDraw()
 	}
 
+	// runs on the queue
+	private fun drawSrc(token: Long): Boolean {
+		val document = document?.value ?: 0L
+		return if (document != 0L) {
+			nativeDrawSVGDocument(svgCanvas, document, token)
+		} else {
+			nativeDrawSVG(svgCanvas, src, token)
+		}
+	}
+
+	/**
+	 * Runs [block] against the retained document on the queue and redraws when it changed
+	 * something, only the parts of the document it touched are parsed again.
+	 */
+	private fun edit(block: (Long) -> Boolean) {
+		queue.execute {
+			val document = retainedDocument()
+			if (document != 0L && block(document)) {
+				doDraw()
+			}
+		}
+	}
+
+	private fun retainedDocument(): Long {
+		document?.let {
+			return it.value
+		}
+		if (src.isEmpty()) {
+			return 0L
+		}
+		val document = nativeDocumentCreate(src)
+		if (document != 0L) {
+			this.document = GC.register(this, GC.HandleType.SVGDocument, document) { nativeDocumentDestroy(it) }
+		}
+		return document
+	}
+
+	/**
+	 * Sets [name] on the element of [src][setSrc] with [id], or on the root when [id] is null.
+	 * A null [value] removes the attribute.
+	 */
+	fun setAttribute(id: String?, name: String, value: String?) {
+		edit { document ->
+			val node = nativeDocumentElementById(document, id)
+			node >= 0 && nativeDocumentSetAttribute(document, node, name, value)
+		}
+	}
+
+	fun setText(id: String?, text: String) {
+		edit { document ->
+			val node = nativeDocumentElementById(document, id)
+			node >= 0 && nativeDocumentSetText(document, node, text)
+		}
+	}
+
+	/**
+	 * Parses [xml] and appends it to the element with [parentId], or to the root when it is null.
+	 */
+	fun appendChild(parentId: String?, xml: String) {
+		edit { document ->
+			val node = nativeDocumentElementById(document, parentId)
+			node >= 0 && nativeDocumentAppendChild(document, node, xml) >= 0
+		}
+	}
+
+	fun removeElement(id: String) {
+		edit { document ->
+			val node = nativeDocumentElementById(document, id)
+			node >= 0 && nativeDocumentRemove(document, node)
+		}
+	}
+
 	fun setSrcPath(path: String) {
 		this.srcPath = path
 		doDraw()
@@ -222,10 +271,55 @@ class TNSSVG : View {
 			TNSCanvas.loadLib()
 		}
 
+		/**
+		 * Bytes the native cache of parsed svgs and their recorded pictures may use, shared by every
+		 * TNSSVG. 0 disables the cache.
+		 */
+		@JvmStatic
+		fun setCacheBudget(bytes: Long) {
+			nativeSetCacheBudget(bytes)
+		}
+
+		@JvmStatic
+		private external fun nativeSetCacheBudget(bytes: Long)
+
+		@JvmStatic
+		private external fun nativeCreateRenderToken(): Long
+
+		@JvmStatic
+		private external fun nativeCancelRender(token: Long)
+
+		@JvmStatic
+		private external fun nativeDestroyRenderToken(token: Long)
+
+		@JvmStatic
+		private external fun nativeDrawSVG(svgCanvas: Long, svg: String, token: Long): Boolean
+
+		@JvmStatic
+		private external fun nativeDrawSVGFromPath(svgCanvas: Long, svg: String, token: Long): Boolean
+
+		@JvmStatic
+		private external fun nativeDrawSVGDocument(svgCanvas: Long, document: Long, token: Long): Boolean
+
+		@JvmStatic
+		private external fun nativeDocumentCreate(svg: String): Long
+
+		@JvmStatic
+		private external fun nativeDocumentDestroy(document: Long)
+
+		@JvmStatic
+		private external fun nativeDocumentElementById(document: Long, id: String?): Int
+
+		@JvmStatic
+		private external fun nativeDocumentSetAttribute(document: Long, node: Int, name: String, value: String?): Boolean
+
+		@JvmStatic
+		private external fun nativeDocumentSetText(document: Long, node: Int, text: String): Boolean
+
 		@JvmStatic
-		private external fun nativeDrawSVG(svgCanvas: Long, svg: String)
+		private external fun nativeDocumentAppendChild(document: Long, parent: Int, xml: String): Int
 
 		@JvmStatic
-		private external fun nativeDrawSVGFromPath(svgCanvas: Long, svg: String)
+		private external fun nativeDocumentRemove(document: Long, node: Int): Boolean
 	}
 }
@@ -0,0 +1,119 @@
+package org.nativescript.canvas
+
+import java.util.concurrent.atomic.AtomicLongArray
+
+/**
+ * Counters of the work the contexts do: draw calls by type, state changes, path and paint copies,
+ * bytes uploaded and read back, cache hits and misses and native objects alive. They are always
+ * on, each count is an atomic add.
+ *
+ * Totals run since the last [reset]. [TNSAnimationFrame] ends a frame after flushing the canvases,
+ * `getStats(true)` returns what the last ended frame added. Counts made on the Java side, the
+ * WebGL ones, are handed to the native counters once per frame.
+ */
+object TNSStats {
+	// indices of the native counters
+	const val DRAW_RECT = 0
+	const val DRAW_PATH = 1
+	const val DRAW_IMAGE = 2
+	const val DRAW_TEXT = 3
+	const val DRAW_OTHER = 4
+	const val GL_DRAW_ARRAYS = 5
+	const val GL_DRAW_ELEMENTS = 6
+	const val STATE_CHANGES = 7
+	const val PATH_CLONES = 8
+	const val PAINT_CLONES = 9
+	const val BYTES_UPLOADED = 10
+	const val BYTES_READ_BACK = 11
+	const val FONT_CACHE_HITS = 12
+	const val FONT_CACHE_MISSES = 13
+	const val TEXT_CACHE_HITS = 14
+	const val TEXT_CACHE_MISSES = 15
+	const val SHADER_CACHE_HITS = 16
+	const val SHADER_CACHE_MISSES = 17
+	const val IMAGE_CACHE_HITS = 18
+	const val IMAGE_CACHE_MISSES = 19
+	const val HANDLES_ALIVE = 20
+	const val FRAMES = 21
+	private const val COUNTER_COUNT = 22
+
+	class Stats internal constructor(values: LongArray) {
+		val drawRect = values[DRAW_RECT]
+		val drawPath = values[DRAW_PATH]
+		val drawImage = values[DRAW_IMAGE]
+		val drawText = values[DRAW_TEXT]
+		val drawOther = values[DRAW_OTHER]
+		val glDrawArrays = values[GL_DRAW_ARRAYS]
+		val glDrawElements = values[GL_DRAW_ELEMENTS]
+		val stateChanges = values[STATE_CHANGES]
+		val pathClones = values[PATH_CLONES]
+		val paintClones = values[PAINT_CLONES]
+		val bytesUploaded = values[BYTES_UPLOADED]
+		val bytesReadBack = values[BYTES_READ_BACK]
+		val fontCacheHits = values[FONT_CACHE_HITS]
+		val fontCacheMisses = values[FONT_CACHE_MISSES]
+		val textCacheHits = values[TEXT_CACHE_HITS]
+		val textCacheMisses = values[TEXT_CACHE_MISSES]
+		val shaderCacheHits = values[SHADER_CACHE_HITS]
+		val shaderCacheMisses = values[SHADER_CACHE_MISSES]
+		val imageCacheHits = values[IMAGE_CACHE_HITS]
+		val imageCacheMisses = values[IMAGE_CACHE_MISSES]
+
+		/** Native contexts, paths and image assets alive, not a count of the frame. */
+		val handlesAlive = values[HANDLES_ALIVE]
+		val frames = values[FRAMES]
+
+		val drawCalls: Long
+			get() = drawRect + drawPath + drawImage + drawText + drawOther + glDrawArrays + glDrawElements
+	}
+
+	// java side counts since the last frame ended, written from the GL threads
+	private val pending = AtomicLongArray(COUNTER_COUNT)
+
+	/** The totals, or what the last ended frame added when [lastFrame] is set. */
+	@JvmStatic
+	@JvmOverloads
+	fun getStats(lastFrame: Boolean = false): Stats {
+		val values = nativeGetStats(lastFrame)
+		if (!lastFrame) {
+			for (i in 0 until COUNTER_COUNT) {
+				values[i] += pending.get(i)
+			}
+		}
+		return Stats(values)
+	}
+
+	/** Zeroes every counter but the handles alive. */
+	@JvmStatic
+	fun reset() {
+		for (i in 0 until COUNTER_COUNT) {
+			pending.set(i, 0)
+		}
+		nativeReset()
+	}
+
+	internal fun add(counter: Int, value: Long) {
+		pending.addAndGet(counter, value)
+	}
+
+	internal fun increment(counter: Int) {
+		pending.incrementAndGet(counter)
+	}
+
+	internal fun endFrame() {
+		val values = LongArray(COUNTER_COUNT)
+		for (i in 0 until COUNTER_COUNT) {
+			values[i] = pending.getAndSet(i, 0)
+		}
+		nativeEndFrame(values)
+	}
+
+	@JvmStatic
+	private external fun nativeGetStats(lastFrame: Boolean): LongArray
+
+	@JvmStatic
+	private external fun nativeEndFrame(pending: LongArray)
+
+	@JvmStatic
+	private external fun nativeReset()
+}
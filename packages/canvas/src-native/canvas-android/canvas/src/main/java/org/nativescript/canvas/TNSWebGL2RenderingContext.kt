@@ -94,6 +94,11 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun bindVertexArray() {
+		if (!canvas.glState.bindVertexArray(0)) {
+			return
+		}
+		canvas.vertexArrays.bind(0, GLStateCache.UNKNOWN)
+
 		runOnGLThread {
 			GLES30.glBindVertexArray(0)
 			lock.countDown()
@@ -106,6 +111,11 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun bindVertexArray(vertexArray: Int) {
+		if (!canvas.glState.bindVertexArray(vertexArray)) {
+			return
+		}
+		canvas.vertexArrays.bind(vertexArray, GLStateCache.UNKNOWN)
+
 		runOnGLThread {
 			GLES30.glBindVertexArray(vertexArray)
 			lock.countDown()
@@ -449,6 +459,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 			lock.reset()
 		} catch (ignored: InterruptedException) {
 		}
+		canvas.vertexArrays.created(array[0])
 		return array[0]
 	}
 
@@ -523,6 +534,8 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun deleteVertexArray(vertexArray: Int) {
+		canvas.glState.deleteVertexArray(vertexArray)
+		canvas.vertexArrays.delete(vertexArray, GLStateCache.UNKNOWN)
 
 		runOnGLThread {
 			val array = intArrayOf(vertexArray)
@@ -541,6 +554,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 		runOnGLThread {
 			clearIfComposited()
 			GLES30.glDrawArraysInstanced(mode, first, count, instanceCount)
+			TNSStats.increment(TNSStats.GL_DRAW_ARRAYS)
 			updateCanvas()
 			lock.countDown()
 		}
@@ -556,6 +570,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 		runOnGLThread {
 			clearIfComposited()
 			GLES30.glDrawElementsInstanced(mode, count, type, offset, instanceCount)
+			TNSStats.increment(TNSStats.GL_DRAW_ELEMENTS)
 			updateCanvas()
 			lock.countDown()
 		}
@@ -571,6 +586,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 		runOnGLThread {
 			clearIfComposited()
 			GLES30.glDrawRangeElements(mode, start, end, count, type, offset)
+			TNSStats.increment(TNSStats.GL_DRAW_ELEMENTS)
 			updateCanvas()
 			lock.countDown()
 		}
@@ -3738,6 +3754,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun transformFeedbackVaryings(program: Int, varyings: Array<String?>?, bufferMode: Int) {
+		programSources.markUncacheable(program)
 
 		runOnGLThread {
 			GLES30.glTransformFeedbackVaryings(program, varyings, bufferMode)
@@ -3751,6 +3768,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform1ui(location: Int, v0: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES30.glUniform1ui(location, v0)
@@ -3764,6 +3782,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform2ui(location: Int, v0: Int, v1: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES30.glUniform2ui(location, v0, v1)
@@ -3777,6 +3796,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform3ui(location: Int, v0: Int, v1: Int, v2: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES30.glUniform3ui(location, v0, v1, v2)
@@ -3790,6 +3810,7 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform4ui(location: Int, v0: Int, v1: Int, v2: Int, v3: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES30.glUniform4ui(location, v0, v1, v2, v3)
@@ -3803,10 +3824,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform1uiv(location: Int, data: IntArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 1
-			GLES30.glUniform1uiv(location, count, IntBuffer.wrap(data))
+			uploadUniform(location, UNSIGNED_INT, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3817,10 +3838,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform2uiv(location: Int, data: IntArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 2
-			GLES30.glUniform2uiv(location, count, IntBuffer.wrap(data))
+			uploadUniform(location, UNSIGNED_INT_VEC2, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3831,10 +3852,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform3uiv(location: Int, data: IntArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 3
-			GLES30.glUniform3uiv(location, count, IntBuffer.wrap(data))
+			uploadUniform(location, UNSIGNED_INT_VEC3, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3845,10 +3866,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform4uiv(location: Int, data: IntArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 4
-			GLES30.glUniform4uiv(location, count, IntBuffer.wrap(data))
+			uploadUniform(location, UNSIGNED_INT_VEC4, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3860,10 +3881,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 
 
 	fun uniform1uivBuffer(location: Int, data: IntBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 1
-			GLES30.glUniform1uiv(location, count, data)
+			uploadUniform(location, UNSIGNED_INT, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3874,10 +3895,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform2uivBuffer(location: Int, data: IntBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 2
-			GLES30.glUniform2uiv(location, count, data)
+			uploadUniform(location, UNSIGNED_INT_VEC2, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3888,10 +3909,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform3uivBuffer(location: Int, data: IntBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 3
-			GLES30.glUniform3uiv(location, count, data)
+			uploadUniform(location, UNSIGNED_INT_VEC3, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3902,10 +3923,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniform4uivBuffer(location: Int, data: IntBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 4
-			GLES30.glUniform4uiv(location, count, data)
+			uploadUniform(location, UNSIGNED_INT_VEC4, false, data)
 			lock.countDown()
 		}
 		try {
@@ -3929,10 +3950,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix3x2fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 6
-			GLES30.glUniformMatrix3x2fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT3x2, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -3943,10 +3964,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix4x2fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 8
-			GLES30.glUniformMatrix4x2fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT4x2, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -3957,10 +3978,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix2x3fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 6
-			GLES30.glUniformMatrix2x3fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT2x3, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -3971,10 +3992,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix4x3fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 12
-			GLES30.glUniformMatrix4x3fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT4x3, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -3985,10 +4006,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix2x4fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 8
-			GLES30.glUniformMatrix2x4fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT2x4, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -3999,10 +4020,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix3x4fv(location: Int, transpose: Boolean, data: FloatArray) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.size / 12
-			GLES30.glUniformMatrix3x4fv(location, count, transpose, FloatBuffer.wrap(data))
+			uploadUniform(location, FLOAT_MAT3x4, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4014,10 +4035,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 
 
 	fun uniformMatrix3x2fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 6
-			GLES30.glUniformMatrix3x2fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT3x2, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4028,10 +4049,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix4x2fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 8
-			GLES30.glUniformMatrix4x2fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT4x2, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4042,10 +4063,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix2x3fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 6
-			GLES30.glUniformMatrix2x3fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT2x3, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4056,10 +4077,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix4x3fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 12
-			GLES30.glUniformMatrix4x3fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT4x3, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4070,10 +4091,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix2x4fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 8
-			GLES30.glUniformMatrix2x4fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT2x4, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4084,10 +4105,10 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 	}
 
 	fun uniformMatrix3x4fvBuffer(location: Int, transpose: Boolean, data: FloatBuffer) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = data.capacity() / 12
-			GLES30.glUniformMatrix3x4fv(location, count, transpose, data)
+			uploadUniform(location, FLOAT_MAT3x4, transpose, data)
 			lock.countDown()
 		}
 		try {
@@ -4099,6 +4120,9 @@ class TNSWebGL2RenderingContext : TNSWebGLRenderingContext {
 
 
 	fun vertexAttribDivisor(index: Int, divisor: Int) {
+		if (!canvas.vertexArrays.vertexAttribDivisor(index, divisor)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES30.glVertexAttribDivisor(index, divisor)
@@ -3,6 +3,7 @@ package org.nativescript.canvas
 import android.graphics.Bitmap
 import android.graphics.drawable.Drawable
 import android.opengl.GLES20
+import android.opengl.GLES30
 import android.os.Build
 import android.os.Build.VERSION_CODES
 import org.nativescript.canvas.extensions.*
@@ -23,6 +24,27 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 
 	internal val lock = ResettableCountDownLatch(1)
 
+	internal val programSources = ProgramSources()
+
+	// programs with values remembered by uniformBatch, only touched on the calling thread
+	private val batchedPrograms = HashSet<Int>()
+
+	// only ever resolved on the calling thread, the first use asks the GL thread for support
+	internal val programCache: ProgramBinaryCache? by lazy {
+		val supported = BooleanArray(1)
+		runOnGLThread {
+			// webgl contexts run on ES 2 even when the device has ES 3
+			supported[0] = canvas.actualContextType == "webgl2" && ProgramBinaryCache.isSupported(canvas.glVersion)
+			lock.countDown()
+		}
+		try {
+			lock.await(2, TimeUnit.SECONDS)
+			lock.reset()
+		} catch (ignored: InterruptedException) {
+		}
+		if (supported[0]) ProgramBinaryCache.get(canvas.context) else null
+	}
+
 	constructor(canvas: TNSCanvas) {
 		this.canvas = canvas
 	}
@@ -54,6 +76,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 
 
 	fun activeTexture(texture: Int) {
+		if (!canvas.glState.activeTexture(texture)) {
+			return
+		}
+
 		runOnGLThread {
 			GLES20.glActiveTexture(texture)
 			lock.countDown()
@@ -66,6 +92,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun attachShader(program: Int, shader: Int) {
+		programSources.attach(program, shader)
 		runOnGLThread {
 			GLES20.glAttachShader(program, shader)
 			lock.countDown()
@@ -78,6 +105,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindAttribLocation(program: Int, index: Int, name: String?) {
+		programSources.bindAttribLocation(program, index, name)
 
 		runOnGLThread {
 			GLES20.glBindAttribLocation(program, index, name)
@@ -91,6 +119,12 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindBuffer(target: Int, buffer: Int) {
+		if (target == ELEMENT_ARRAY_BUFFER) {
+			canvas.vertexArrays.bindElementArrayBuffer(buffer)
+		}
+		if (!canvas.glState.bindBuffer(target, buffer)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBindBuffer(target, buffer)
@@ -104,6 +138,12 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindBuffer(target: Int, buffer: Any?) {
+		if (target == ELEMENT_ARRAY_BUFFER) {
+			canvas.vertexArrays.bindElementArrayBuffer(0)
+		}
+		if (!canvas.glState.bindBuffer(target, 0)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBindBuffer(target, 0)
@@ -117,6 +157,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindFramebuffer(target: Int, framebuffer: Int) {
+		if (!canvas.glState.bindFramebuffer(target, framebuffer)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBindFramebuffer(target, framebuffer)
@@ -130,6 +173,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindRenderbuffer(target: Int, renderbuffer: Int) {
+		if (!canvas.glState.bindRenderbuffer(renderbuffer)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBindRenderbuffer(target, renderbuffer)
@@ -143,6 +189,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun bindTexture(target: Int, texture: Int) {
+		if (!canvas.glState.bindTexture(target, texture)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBindTexture(target, texture)
@@ -169,6 +218,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun blendEquation(mode: Int) {
+		if (!canvas.glState.blendEquation(mode, mode)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBlendEquation(mode)
@@ -182,6 +234,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun blendEquationSeparate(modeRGB: Int, modeAlpha: Int) {
+		if (!canvas.glState.blendEquation(modeRGB, modeAlpha)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBlendEquationSeparate(modeRGB, modeAlpha)
@@ -195,6 +250,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun blendFunc(sfactor: Int, dfactor: Int) {
+		if (!canvas.glState.blendFunc(sfactor, dfactor, sfactor, dfactor)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBlendFunc(sfactor, dfactor)
@@ -208,6 +266,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun blendFuncSeparate(srcRGB: Int, dstRGB: Int, srcAlpha: Int, dstAlpha: Int) {
+		if (!canvas.glState.blendFunc(srcRGB, dstRGB, srcAlpha, dstAlpha)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha)
@@ -265,8 +326,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: ByteArray, usage: Int) {
 
 		runOnGLThread {
-			val buffer = ByteBuffer.wrap(srcData)
-			GLES20.glBufferData(target, srcData.size, buffer, usage)
+			nativeBufferDataArray(target, srcData, 0, srcData.size, SIZE_OF_BYTE, usage)
 			lock.countDown()
 		}
 		try {
@@ -279,9 +339,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: ShortArray, usage: Int) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_SHORT
-			val buffer = ShortBuffer.wrap(srcData)
-			GLES20.glBufferData(target, size, buffer, usage)
+			nativeBufferDataArray(target, srcData, 0, srcData.size, SIZE_OF_SHORT, usage)
 			lock.countDown()
 		}
 		try {
@@ -294,9 +352,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: FloatArray, usage: Int) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_FLOAT
-			val buffer = FloatBuffer.wrap(srcData)
-			GLES20.glBufferData(target, size, buffer, usage)
+			nativeBufferDataArray(target, srcData, 0, srcData.size, SIZE_OF_FLOAT, usage)
 			lock.countDown()
 		}
 		try {
@@ -309,9 +365,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: IntArray, usage: Int) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_INT
-			val buffer = IntBuffer.wrap(srcData)
-			GLES20.glBufferData(target, size, buffer, usage)
+			nativeBufferDataArray(target, srcData, 0, srcData.size, SIZE_OF_INT, usage)
 			lock.countDown()
 		}
 		try {
@@ -342,7 +396,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: ByteBuffer, usage: Int) {
 
 		runOnGLThread {
-			GLES20.glBufferData(target, srcData.capacity(), srcData, usage)
+			uploadBufferData(target, srcData, usage)
 			lock.countDown()
 		}
 		try {
@@ -355,7 +409,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: ShortBuffer, usage: Int) {
 
 		runOnGLThread {
-			GLES20.glBufferData(target, srcData.capacity() * SIZE_OF_SHORT, srcData, usage)
+			uploadBufferData(target, srcData, usage)
 			lock.countDown()
 		}
 		try {
@@ -368,7 +422,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: IntBuffer, usage: Int) {
 
 		runOnGLThread {
-			GLES20.glBufferData(target, srcData.capacity() * SIZE_OF_INT, srcData, usage)
+			uploadBufferData(target, srcData, usage)
 			lock.countDown()
 		}
 		try {
@@ -381,7 +435,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferData(target: Int, srcData: FloatBuffer, usage: Int) {
 
 		runOnGLThread {
-			GLES20.glBufferData(target, srcData.capacity() * SIZE_OF_FLOAT, srcData, usage)
+			uploadBufferData(target, srcData, usage)
 			lock.countDown()
 		}
 		try {
@@ -410,9 +464,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: ByteArray) {
 
 		runOnGLThread {
-			val size = srcData.size
-			val buffer = ByteBuffer.wrap(srcData)
-			GLES20.glBufferSubData(target, offset, size, buffer)
+			nativeBufferSubDataArray(target, offset, srcData, 0, srcData.size, SIZE_OF_BYTE)
 			lock.countDown()
 		}
 		try {
@@ -425,10 +477,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: ShortArray) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_SHORT
-			val buffer = ShortBuffer.wrap(srcData)
-			val os = SIZE_OF_SHORT * offset
-			GLES20.glBufferSubData(target, os, size, buffer)
+			nativeBufferSubDataArray(target, SIZE_OF_SHORT * offset, srcData, 0, srcData.size, SIZE_OF_SHORT)
 			lock.countDown()
 		}
 		try {
@@ -441,10 +490,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: IntArray) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_INT
-			val buffer = IntBuffer.wrap(srcData)
-			val os = SIZE_OF_INT * offset
-			GLES20.glBufferSubData(target, os, size, buffer)
+			nativeBufferSubDataArray(target, SIZE_OF_INT * offset, srcData, 0, srcData.size, SIZE_OF_INT)
 			lock.countDown()
 		}
 		try {
@@ -457,10 +503,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: FloatArray) {
 
 		runOnGLThread {
-			val size = srcData.size * SIZE_OF_FLOAT
-			val buffer = FloatBuffer.wrap(srcData)
-			val os = SIZE_OF_FLOAT * offset
-			GLES20.glBufferSubData(target, os, size, buffer)
+			nativeBufferSubDataArray(target, SIZE_OF_FLOAT * offset, srcData, 0, srcData.size, SIZE_OF_FLOAT)
 			lock.countDown()
 		}
 		try {
@@ -491,7 +534,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: ByteBuffer) {
 
 		runOnGLThread {
-			GLES20.glBufferSubData(target, offset, srcData.capacity(), srcData)
+			uploadBufferSubData(target, offset, srcData)
 			lock.countDown()
 		}
 		try {
@@ -504,7 +547,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: ShortBuffer) {
 
 		runOnGLThread {
-			GLES20.glBufferSubData(target, offset, srcData.capacity() * SIZE_OF_SHORT, srcData)
+			uploadBufferSubData(target, offset, srcData)
 			lock.countDown()
 		}
 		try {
@@ -517,7 +560,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: IntBuffer) {
 
 		runOnGLThread {
-			GLES20.glBufferSubData(target, offset, srcData.capacity() * SIZE_OF_INT, srcData)
+			uploadBufferSubData(target, offset, srcData)
 			lock.countDown()
 		}
 		try {
@@ -530,7 +573,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	fun bufferSubData(target: Int, offset: Int, srcData: FloatBuffer) {
 
 		runOnGLThread {
-			GLES20.glBufferSubData(target, offset, srcData.capacity() * SIZE_OF_FLOAT, srcData)
+			uploadBufferSubData(target, offset, srcData)
 			lock.countDown()
 		}
 		try {
@@ -717,6 +760,11 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun compileShader(shader: Int) {
+		if (programCache != null) {
+			// issued at link time unless the program loads from its binary, or when queried
+			programSources.deferCompile(shader)
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glCompileShader(shader)
@@ -1580,6 +1628,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 			lock.reset()
 		} catch (ignored: InterruptedException) {
 		}
+		if (shader[0] != 0) {
+			programSources.shaderCreated(shader[0], type)
+		}
 		return shader[0]
 	}
 
@@ -1612,6 +1663,8 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteBuffer(buffer: Int) {
+		canvas.glState.deleteBuffer(buffer)
+		canvas.vertexArrays.deleteBuffer(buffer)
 
 		runOnGLThread {
 			val id = intArrayOf(buffer)
@@ -1626,6 +1679,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteFramebuffer(frameBuffer: Int) {
+		canvas.glState.deleteFramebuffer(frameBuffer)
 
 		runOnGLThread {
 			val id = intArrayOf(frameBuffer)
@@ -1640,6 +1694,8 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteProgram(program: Int) {
+		programSources.deleteProgram(program)
+		forgetBatchedUniforms(program, true)
 
 		runOnGLThread {
 			GLES20.glDeleteProgram(program)
@@ -1653,6 +1709,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteRenderbuffer(renderbuffer: Int) {
+		canvas.glState.deleteRenderbuffer(renderbuffer)
 
 		runOnGLThread {
 			val id = intArrayOf(renderbuffer)
@@ -1667,6 +1724,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteShader(shader: Int) {
+		programSources.deleteShader(shader)
 
 		runOnGLThread {
 			GLES20.glDeleteShader(shader)
@@ -1680,6 +1738,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun deleteTexture(texture: Int) {
+		canvas.glState.deleteTexture(texture)
 
 		runOnGLThread {
 			val id = intArrayOf(texture)
@@ -1694,6 +1753,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun depthFunc(func: Int) {
+		if (!canvas.glState.depthFunc(func)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glDepthFunc(func)
@@ -1707,6 +1769,11 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun depthMask(flag: Boolean) {
+		// restored after the clears done for compositing
+		canvas.mDepthMask = flag
+		if (!canvas.glState.depthMask(flag)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glDepthMask(flag)
@@ -1733,6 +1800,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun detachShader(program: Int, shader: Int) {
+		programSources.detach(program, shader)
 
 		runOnGLThread {
 			GLES20.glDetachShader(program, shader)
@@ -1746,6 +1814,12 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun disable(cap: Int) {
+		if (cap == GLES20.GL_SCISSOR_TEST) {
+			canvas.mScissorEnabled = false
+		}
+		if (!canvas.glState.setCapability(cap, false)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glDisable(cap)
@@ -1759,6 +1833,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun disableVertexAttribArray(index: Int) {
+		if (!canvas.vertexArrays.enableVertexAttribArray(index, false)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glDisableVertexAttribArray(index)
@@ -1776,6 +1853,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			clearIfComposited()
 			GLES20.glDrawArrays(mode, first, count)
+			TNSStats.increment(TNSStats.GL_DRAW_ARRAYS)
 			updateCanvas()
 			lock.countDown()
 		}
@@ -1791,6 +1869,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			clearIfComposited()
 			GLES20.glDrawElements(mode, count, type, offset)
+			TNSStats.increment(TNSStats.GL_DRAW_ELEMENTS)
 			updateCanvas()
 			lock.countDown()
 		}
@@ -1802,6 +1881,12 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun enable(cap: Int) {
+		if (cap == GLES20.GL_SCISSOR_TEST) {
+			canvas.mScissorEnabled = true
+		}
+		if (!canvas.glState.setCapability(cap, true)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glEnable(cap)
@@ -1815,6 +1900,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun enableVertexAttribArray(index: Int) {
+		if (!canvas.vertexArrays.enableVertexAttribArray(index, true)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glEnableVertexAttribArray(index)
@@ -2108,9 +2196,12 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 				value[0] = OES_texture_half_float()
 			} else if (name == "OES_texture_half_float_linear" && extensions.contains("GL_OES_texture_half_float_linear")) {
 				value[0] = OES_texture_half_float_linear()
-			} else if (name == "OES_vertex_array_object" && extensions.contains("GL_OES_vertex_array_object")) {
+			} else if (name == "OES_vertex_array_object") {
 				if (Build.VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN_MR2) {
-					value[0] = OES_vertex_array_object(canvas)
+					// vertex arrays are core in ES 3, a WebGL 1 context often gets one anyway
+					val version = GLES20.glGetString(GLES20.GL_VERSION) ?: ""
+					val emulated = !version.startsWith("OpenGL ES 3")
+					value[0] = OES_vertex_array_object(canvas, emulated)
 				} else {
 					value[0] = null
 				}
@@ -2138,7 +2229,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 			} else if (name == "ANGLE_instanced_arrays") {
 				if (canvas.glVersion > 2) {
 					if (Build.VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN_MR2) {
-						value[0] = ANGLE_instanced_arrays()
+						value[0] = ANGLE_instanced_arrays(canvas)
 					} else {
 						value[0] = null
 					}
@@ -2217,6 +2308,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	open fun getParameter(pname: Int): Any? {
+		if (canvas.glState.isTracked(pname)) {
+			return canvas.glState.getParameter(pname)
+		}
 
 		val parameter = arrayOfNulls<Any>(1)
 		runOnGLThread {
@@ -2352,9 +2446,16 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun getShaderInfoLog(shader: Int): String? {
+		if (programSources.isVerified(shader)) {
+			return ""
+		}
+		val compile = programSources.takePendingCompile(shader)
 
 		val infoLog = arrayOfNulls<String>(1)
 		runOnGLThread {
+			if (compile) {
+				GLES20.glCompileShader(shader)
+			}
 			infoLog[0] = GLES20.glGetShaderInfoLog(shader)
 			lock.countDown()
 		}
@@ -2367,9 +2468,16 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun getShaderParameter(shader: Int, pname: Int): Any? {
+		if (pname == COMPILE_STATUS && programSources.isVerified(shader)) {
+			return true
+		}
+		val compile = pname == COMPILE_STATUS && programSources.takePendingCompile(shader)
 
 		val parameter = arrayOfNulls<Any>(1)
 		runOnGLThread {
+			if (compile) {
+				GLES20.glCompileShader(shader)
+			}
 			val params = IntArray(1)
 			GLES20.glGetShaderiv(shader, pname, params, 0)
 			when (pname) {
@@ -2594,6 +2702,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun getVertexAttrib(index: Int, pname: Int): Any? {
+		if (canvas.vertexArrays.isTracked(index, pname)) {
+			return canvas.vertexArrays.getVertexAttrib(index, pname)
+		}
 
 		val attrib = arrayOfNulls<Any>(1)
 		runOnGLThread {
@@ -2622,6 +2733,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun getVertexAttribOffset(index: Int, pname: Int): Long {
+		if (canvas.vertexArrays.isTracked(index, pname)) {
+			return (canvas.vertexArrays.getVertexAttrib(index, pname) as Int).toLong()
+		}
 
 		val offset = LongArray(1)
 		runOnGLThread {
@@ -2780,9 +2894,37 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun linkProgram(program: Int) {
-
-		runOnGLThread {
+		forgetBatchedUniforms(program, false)
+		val cache = programCache
+		val shaders = if (cache != null) programSources.shaders(program) else null
+		val attributes = if (shaders != null) programSources.attributes(program) else emptyMap()
+
+		runOnGLThread {
+			var key: String? = null
+			if (cache != null && shaders != null && Build.VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN_MR2) {
+				key = cache.key(shaders, attributes)
+				if (cache.load(program, key)) {
+					TNSStats.increment(TNSStats.SHADER_CACHE_HITS)
+					programSources.markVerified(program)
+					lock.countDown()
+					return@runOnGLThread
+				}
+				TNSStats.increment(TNSStats.SHADER_CACHE_MISSES)
+			}
+			for (shader in programSources.takePendingCompiles(program)) {
+				GLES20.glCompileShader(shader)
+			}
+			if (cache != null && key != null && Build.VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN_MR2) {
+				GLES30.glProgramParameteri(program, GLES30.GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GLES20.GL_TRUE)
+			}
 			GLES20.glLinkProgram(program)
+			if (cache != null && key != null && Build.VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN_MR2) {
+				val status = IntArray(1)
+				GLES20.glGetProgramiv(program, GLES20.GL_LINK_STATUS, status, 0)
+				if (status[0] == GLES20.GL_TRUE) {
+					cache.store(program, key)
+				}
+			}
 			lock.countDown()
 		}
 		try {
@@ -2824,6 +2966,48 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	var flipYWebGL = false
 	private var premultiplyAlphaWebGL = false
 	private var colorSpaceConversionWebGL = -1
+	/**
+	 * Compiles and links [vertexSource] and [fragmentSource] on the GL thread without waiting, only
+	 * to store the program binary so a later link of the same sources skips compilation. A no-op
+	 * when program binaries are not supported or the program is already cached.
+	 */
+	@JvmOverloads
+	fun precompileProgram(vertexSource: String, fragmentSource: String, attributes: Map<String, Int>? = null) {
+		val cache = programCache ?: return
+		if (Build.VERSION.SDK_INT < VERSION_CODES.JELLY_BEAN_MR2) {
+			return
+		}
+		val bindings = attributes?.let { HashMap(it) } ?: emptyMap<String, Int>()
+		runOnGLThread {
+			val key = cache.key(listOf(Pair(VERTEX_SHADER, vertexSource), Pair(FRAGMENT_SHADER, fragmentSource)), bindings)
+			if (cache.contains(key)) {
+				return@runOnGLThread
+			}
+			val vertex = GLES20.glCreateShader(VERTEX_SHADER)
+			val fragment = GLES20.glCreateShader(FRAGMENT_SHADER)
+			val program = GLES20.glCreateProgram()
+			GLES20.glShaderSource(vertex, vertexSource)
+			GLES20.glCompileShader(vertex)
+			GLES20.glShaderSource(fragment, fragmentSource)
+			GLES20.glCompileShader(fragment)
+			GLES20.glAttachShader(program, vertex)
+			GLES20.glAttachShader(program, fragment)
+			for ((name, index) in bindings) {
+				GLES20.glBindAttribLocation(program, index, name)
+			}
+			GLES30.glProgramParameteri(program, GLES30.GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GLES20.GL_TRUE)
+			GLES20.glLinkProgram(program)
+			val status = IntArray(1)
+			GLES20.glGetProgramiv(program, GLES20.GL_LINK_STATUS, status, 0)
+			if (status[0] == GLES20.GL_TRUE) {
+				cache.store(program, key)
+			}
+			GLES20.glDeleteProgram(program)
+			GLES20.glDeleteShader(vertex)
+			GLES20.glDeleteShader(fragment)
+		}
+	}
+
 	fun pixelStorei(pname: Int, param: Any?) {
 
 		runOnGLThread {
@@ -2861,6 +3045,46 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		}
 	}
 
+	/**
+	 * Reads pixels without blocking the caller. webgl2 contexts read into a pixel pack buffer and
+	 * complete once the GPU is done with it, checked every frame, so neither thread stalls. Other
+	 * contexts read on the GL thread after the calls queued so far. [callback] runs on the GL thread.
+	 */
+	@JvmOverloads
+	fun readPixelsAsync(
+		x: Int,
+		y: Int,
+		width: Int,
+		height: Int,
+		format: Int,
+		type: Int,
+		callback: WebGLReadback.Callback? = null
+	): WebGLReadback {
+		val readback = WebGLReadback(width, height, format, type)
+		callback?.let { readback.then(it) }
+		val useBuffers = canvas.actualContextType == "webgl2"
+		runOnGLThread {
+			canvas.readbacks.read(readback, x, y, useBuffers)
+		}
+		return readback
+	}
+
+	/**
+	 * Times the calls made until [endGpuPass] separately as [label], reported in
+	 * [TNSAnimationFrame.FrameStats.gpuPassTimes] while GPU timing is enabled.
+	 */
+	fun beginGpuPass(label: String) {
+		runOnGLThread {
+			canvas.gpuTimers?.beginPass(label)
+		}
+	}
+
+	fun endGpuPass() {
+		runOnGLThread {
+			canvas.gpuTimers?.endPass()
+		}
+	}
+
 	fun readPixelsByte(
 		x: Int,
 		y: Int,
@@ -2962,6 +3186,11 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 
+	// with the default pack alignment, the actual one isn't worth a glGet per read
+	private fun countReadBack(width: Int, height: Int, format: Int, type: Int) {
+		TNSStats.add(TNSStats.BYTES_READ_BACK, PixelReadbacks.byteSize(width, height, format, type, 4).toLong())
+	}
+
 	fun readPixels(
 		x: Int,
 		y: Int,
@@ -2975,6 +3204,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, pixels)
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -2997,6 +3227,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			// clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, pixels)
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3019,6 +3250,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, pixels)
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3042,6 +3274,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, pixels)
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3065,6 +3298,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, ByteBuffer.wrap(pixels))
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3087,6 +3321,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, ShortBuffer.wrap(pixels))
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3109,6 +3344,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, FloatBuffer.wrap(pixels))
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3131,6 +3367,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		runOnGLThread {
 			//	clearIfComposited()
 			GLES20.glReadPixels(x, y, width, height, format, type, IntBuffer.wrap(pixels))
+			countReadBack(width, height, format, type)
 			lock.countDown()
 		}
 		try {
@@ -3180,8 +3417,13 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun shaderSource(shader: Int, source: String?) {
+		// a compile deferred earlier still has to see the old source
+		val compile = programSources.shaderSource(shader, source)
 
 		runOnGLThread {
+			if (compile) {
+				GLES20.glCompileShader(shader)
+			}
 			GLES20.glShaderSource(shader, source)
 			lock.countDown()
 		}
@@ -4562,6 +4804,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1f(location: Int, v0: Float) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform1f(location, v0)
@@ -4575,10 +4818,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1fv(location: Int, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(1) ?: 1
-			GLES20.glUniform1fv(location, count, value, 0)
+			uploadUniform(location, FLOAT, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4589,10 +4832,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1fvBuffer(location: Int, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(1) ?: 1
-			GLES20.glUniform1fv(location, count, value)
+			uploadUniform(location, FLOAT, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4603,6 +4846,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1i(location: Int, v0: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform1i(location, v0)
@@ -4616,10 +4860,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1iv(location: Int, value: IntArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(1) ?: 1
-			GLES20.glUniform1iv(location, count, value, 0)
+			uploadUniform(location, INT, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4630,10 +4874,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform1ivBuffer(location: Int, value: IntBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(1) ?: 1
-			GLES20.glUniform1iv(location, count, value)
+			uploadUniform(location, INT, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4644,6 +4888,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2f(location: Int, v0: Float, v1: Float) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform2f(location, v0, v1)
@@ -4657,10 +4902,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2fv(location: Int, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(2) ?: 2
-			GLES20.glUniform2fv(location, count, value, 0)
+			uploadUniform(location, FLOAT_VEC2, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4671,10 +4916,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2fvBuffer(location: Int, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(2) ?: 2
-			GLES20.glUniform2fv(location, count, value)
+			uploadUniform(location, FLOAT_VEC2, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4685,6 +4930,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2i(location: Int, v0: Int, v1: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform2i(location, v0, v1)
@@ -4698,10 +4944,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2iv(location: Int, value: IntArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(2) ?: 2
-			GLES20.glUniform2iv(location, count, value, 0)
+			uploadUniform(location, INT_VEC2, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4712,10 +4958,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform2ivBuffer(location: Int, value: IntBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(2) ?: 2
-			GLES20.glUniform2iv(location, count, value)
+			uploadUniform(location, INT_VEC2, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4726,6 +4972,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3f(location: Int, v0: Float, v1: Float, v2: Float) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform3f(location, v0, v1, v2)
@@ -4739,10 +4986,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3fv(location: Int, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(3) ?: 3
-			GLES20.glUniform3fv(location, count, value, 0)
+			uploadUniform(location, FLOAT_VEC3, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4753,10 +5000,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3fvBuffer(location: Int, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(3) ?: 3
-			GLES20.glUniform3fv(location, count, value)
+			uploadUniform(location, FLOAT_VEC3, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4767,6 +5014,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3i(location: Int, v0: Int, v1: Int, v2: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform3i(location, v0, v1, v2)
@@ -4780,10 +5028,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3iv(location: Int, value: IntArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(3) ?: 3
-			GLES20.glUniform3iv(location, count, value, 0)
+			uploadUniform(location, INT_VEC3, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4794,10 +5042,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform3ivBuffer(location: Int, value: IntBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(3) ?: 3
-			GLES20.glUniform3iv(location, count, value)
+			uploadUniform(location, INT_VEC3, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4808,6 +5056,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4f(location: Int, v0: Float, v1: Float, v2: Float, v3: Float) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform4f(location, v0, v1, v2, v3)
@@ -4821,10 +5070,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4fv(location: Int, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(4) ?: 4
-			GLES20.glUniform4fv(location, count, value, 0)
+			uploadUniform(location, FLOAT_VEC4, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4835,10 +5084,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4fvBuffer(location: Int, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(4) ?: 4
-			GLES20.glUniform4fv(location, count, value)
+			uploadUniform(location, FLOAT_VEC4, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4849,6 +5098,7 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4i(location: Int, v0: Int, v1: Int, v2: Int, v3: Int) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
 			GLES20.glUniform4i(location, v0, v1, v2, v3)
@@ -4862,10 +5112,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4iv(location: Int, value: IntArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(4) ?: 4
-			GLES20.glUniform4iv(location, count, value, 0)
+			uploadUniform(location, INT_VEC4, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4876,10 +5126,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniform4ivBuffer(location: Int, value: IntBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(4) ?: 4
-			GLES20.glUniform4iv(location, count, value)
+			uploadUniform(location, INT_VEC4, false, value)
 			lock.countDown()
 		}
 		try {
@@ -4890,10 +5140,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix2fv(location: Int, transpose: Boolean, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(4) ?: 4
-			GLES20.glUniformMatrix2fv(location, count, transpose, value, 0)
+			uploadUniform(location, FLOAT_MAT2, transpose, value)
 			lock.countDown()
 		}
 		try {
@@ -4904,10 +5154,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix2fvBuffer(location: Int, transpose: Boolean, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(4) ?: 4
-			GLES20.glUniformMatrix2fv(location, count, transpose, value)
+			uploadUniform(location, FLOAT_MAT2, transpose, value)
 			lock.countDown()
 		}
 		try {
@@ -4918,10 +5168,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix3fv(location: Int, transpose: Boolean, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(9) ?: 9
-			GLES20.glUniformMatrix3fv(location, count, transpose, value, 0)
+			uploadUniform(location, FLOAT_MAT3, transpose, value)
 			lock.countDown()
 		}
 		try {
@@ -4932,10 +5182,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix3fvBuffer(location: Int, transpose: Boolean, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.capacity()?.div(9) ?: 9
-			GLES20.glUniformMatrix3fv(location, count, transpose, value)
+			uploadUniform(location, FLOAT_MAT3, transpose, value)
 			lock.countDown()
 		}
 		try {
@@ -4946,10 +5196,10 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix4fv(location: Int, transpose: Boolean, value: FloatArray?) {
+		forgetBatchedUniform(location)
 
 		runOnGLThread {
-			val count = value?.size?.div(16) ?: 16
-			GLES20.glUniformMatrix4fv(location, count, transpose, value, 0)
+			uploadUniform(location, FLOAT_MAT4, transpose, value)
 			lock.countDown()
 		}
 		try {
@@ -4960,10 +5210,42 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun uniformMatrix4fvBuffer(location: Int, transpose: Boolean, value: FloatBuffer?) {
+		forgetBatchedUniform(location)
+
+		runOnGLThread {
+			uploadUniform(location, FLOAT_MAT4, transpose, value)
+			lock.countDown()
+		}
+		try {
+			lock.await(2, TimeUnit.SECONDS)
+			lock.reset()
+		} catch (ignored: InterruptedException) {
+		}
+	}
+
+	/**
+	 * Makes [program] current and applies [batch] in one round trip, values unchanged since the
+	 * last batch for [program] are skipped. Returns the number of uniforms actually set.
+	 */
+	fun uniformBatch(program: Int, batch: WebGLUniformBatch): Int {
+		val data = batch.buffer
+		return uniformBatch(program, data, 0, data.position())
+	}
 
+	/**
+	 * Same as the [WebGLUniformBatch] overload for a direct buffer in that layout, [offset] and
+	 * [length] are in bytes.
+	 */
+	fun uniformBatch(program: Int, data: ByteBuffer, offset: Int, length: Int): Int {
+		if (!data.isDirect) {
+			return 0
+		}
+		useProgram(program)
+		batchedPrograms.add(program)
+
+		val applied = IntArray(1)
 		runOnGLThread {
-			val count = value?.capacity()?.div(16) ?: 16
-			GLES20.glUniformMatrix4fv(location, count, transpose, value)
+			applied[0] = nativeUniformBatch(program, data, offset, length)
 			lock.countDown()
 		}
 		try {
@@ -4971,9 +5253,39 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 			lock.reset()
 		} catch (ignored: InterruptedException) {
 		}
+		return applied[0]
+	}
+
+	/**
+	 * A uniform set outside a batch makes the value remembered for its location stale.
+	 */
+	internal fun forgetBatchedUniform(location: Int) {
+		if (batchedPrograms.isEmpty()) {
+			return
+		}
+		val program = canvas.glState.currentProgram()
+		if (program != GLStateCache.UNKNOWN && !batchedPrograms.contains(program)) {
+			return
+		}
+		runOnGLThread {
+			nativeUniformBatchForget(program, location)
+		}
+	}
+
+	// linking resets every uniform of the program
+	private fun forgetBatchedUniforms(program: Int, deleted: Boolean) {
+		val batched = if (deleted) batchedPrograms.remove(program) else batchedPrograms.contains(program)
+		if (batched) {
+			runOnGLThread {
+				nativeUniformBatchForget(program, -1)
+			}
+		}
 	}
 
 	fun useProgram(program: Int) {
+		if (!canvas.glState.useProgram(program)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glUseProgram(program)
@@ -5163,9 +5475,37 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		stride: Int,
 		offset: Int
 	) {
+		val vertexArrays = canvas.vertexArrays
+		val buffer = canvas.glState.arrayBuffer()
+		if (!vertexArrays.vertexAttribPointer(index, buffer, size, type, normalized, stride, offset)) {
+			return
+		}
 
+		val queried = IntArray(1)
 		runOnGLThread { // GLES20.glVertexAttribPointer(index, size, type, normalized, stride, offset);
 			nativeVertexAttribPointer(index, size, type, normalized, stride, offset)
+			if (buffer == GLStateCache.UNKNOWN) {
+				GLES20.glGetIntegerv(GLES20.GL_ARRAY_BUFFER_BINDING, queried, 0)
+			}
+			lock.countDown()
+		}
+		try {
+			lock.await(2, TimeUnit.SECONDS)
+			lock.reset()
+		} catch (ignored: InterruptedException) {
+		}
+		if (buffer == GLStateCache.UNKNOWN) {
+			// the pointer records the buffer it was set with
+			vertexArrays.vertexAttribPointer(index, queried[0], size, type, normalized, stride, offset)
+		}
+	}
+
+	/**
+	 * Applies a replay from [VertexArrayCache] on the GL thread.
+	 */
+	internal fun applyVertexArray(state: IntArray) {
+		runOnGLThread {
+			nativeApplyVertexArray(state)
 			lock.countDown()
 		}
 		try {
@@ -5176,6 +5516,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 	}
 
 	fun viewport(x: Int, y: Int, width: Int, height: Int) {
+		if (!canvas.glState.viewport(x, y, width, height)) {
+			return
+		}
 
 		runOnGLThread {
 			GLES20.glViewport(x, y, width, height)
@@ -5542,6 +5885,91 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 		const val SIZE_OF_DOUBLE = 8
 		const val SIZE_OF_CHAR = 2
 
+		// Typed uploads pin arrays and read direct buffers in place on the native side, so
+		// nothing is wrapped or copied here. Heap buffers go through their backing array.
+
+		private fun elementSize(data: Buffer): Int {
+			return when (data) {
+				is ShortBuffer, is CharBuffer -> SIZE_OF_SHORT
+				is IntBuffer -> SIZE_OF_INT
+				is FloatBuffer -> SIZE_OF_FLOAT
+				is LongBuffer -> SIZE_OF_LONG
+				is DoubleBuffer -> SIZE_OF_DOUBLE
+				else -> SIZE_OF_BYTE
+			}
+		}
+
+		internal fun uploadBufferData(target: Int, data: Buffer, usage: Int) {
+			val elementSize = elementSize(data)
+			TNSStats.add(TNSStats.BYTES_UPLOADED, data.remaining().toLong() * elementSize)
+			if (data.isDirect) {
+				nativeBufferDataBuffer(target, data, data.position(), data.remaining(), elementSize, usage)
+			} else if (data.hasArray()) {
+				nativeBufferDataArray(target, data.array(), data.arrayOffset() + data.position(), data.remaining(), elementSize, usage)
+			} else {
+				GLES20.glBufferData(target, data.remaining() * elementSize, data, usage)
+			}
+		}
+
+		internal fun uploadBufferSubData(target: Int, offset: Int, data: Buffer) {
+			val elementSize = elementSize(data)
+			TNSStats.add(TNSStats.BYTES_UPLOADED, data.remaining().toLong() * elementSize)
+			if (data.isDirect) {
+				nativeBufferSubDataBuffer(target, offset, data, data.position(), data.remaining(), elementSize)
+			} else if (data.hasArray()) {
+				nativeBufferSubDataArray(target, offset, data.array(), data.arrayOffset() + data.position(), data.remaining(), elementSize)
+			} else {
+				GLES20.glBufferSubData(target, offset, data.remaining() * elementSize, data)
+			}
+		}
+
+		/**
+		 * [type] is the GL type of the uniform, e.g. FLOAT_VEC4 or FLOAT_MAT3, which picks the
+		 * glUniform* variant and the element count.
+		 */
+		internal fun uploadUniform(location: Int, type: Int, transpose: Boolean, value: FloatArray?) {
+			value ?: return
+			nativeUniformArray(location, type, transpose, value, 0, value.size)
+		}
+
+		internal fun uploadUniform(location: Int, type: Int, transpose: Boolean, value: IntArray?) {
+			value ?: return
+			nativeUniformArray(location, type, transpose, value, 0, value.size)
+		}
+
+		internal fun uploadUniform(location: Int, type: Int, transpose: Boolean, value: Buffer?) {
+			value ?: return
+			if (value.isDirect) {
+				nativeUniformBuffer(location, type, transpose, value, value.position(), value.remaining())
+			} else if (value.hasArray()) {
+				nativeUniformArray(location, type, transpose, value.array(), value.arrayOffset() + value.position(), value.remaining())
+			}
+		}
+
+		@JvmStatic
+		private external fun nativeBufferDataArray(target: Int, data: Any, offset: Int, length: Int, elementSize: Int, usage: Int)
+
+		@JvmStatic
+		private external fun nativeBufferDataBuffer(target: Int, data: Buffer, offset: Int, length: Int, elementSize: Int, usage: Int)
+
+		@JvmStatic
+		private external fun nativeBufferSubDataArray(target: Int, dstByteOffset: Int, data: Any, offset: Int, length: Int, elementSize: Int)
+
+		@JvmStatic
+		private external fun nativeBufferSubDataBuffer(target: Int, dstByteOffset: Int, data: Buffer, offset: Int, length: Int, elementSize: Int)
+
+		@JvmStatic
+		private external fun nativeUniformArray(location: Int, type: Int, transpose: Boolean, data: Any, offset: Int, length: Int)
+
+		@JvmStatic
+		private external fun nativeUniformBatch(program: Int, data: ByteBuffer, offset: Int, length: Int): Int
+
+		@JvmStatic
+		private external fun nativeUniformBatchForget(program: Int, location: Int)
+
+		@JvmStatic
+		private external fun nativeUniformBuffer(location: Int, type: Int, transpose: Boolean, data: Buffer, offset: Int, length: Int)
+
 		@JvmStatic
 		external fun nativeReadPixels(
 			x: Int,
@@ -5562,6 +5990,9 @@ open class TNSWebGLRenderingContext : TNSCanvasRenderingContext {
 			offset: Int
 		)
 
+		@JvmStatic
+		private external fun nativeApplyVertexArray(state: IntArray)
+
 		@JvmStatic
 		private external fun nativeGetVertexAttribOffset(index: Int, pname: Int, buffer: ByteBuffer?)
 
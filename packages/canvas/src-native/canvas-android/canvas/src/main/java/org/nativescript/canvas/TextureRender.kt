@@ -27,11 +27,13 @@ class TextureRender {
 		height: Int,
 		internalFormat: Int,
 		format: Int,
-		flipYWebGL: Boolean
+		flipYWebGL: Boolean,
+		trackedState: IntArray
 	) {
 		nativeDrawFrame(
 			st,
 			flipYWebGL,
+			trackedState,
 			fbo,
 			rbo,
 			mProgram,
@@ -141,6 +143,7 @@ class TextureRender {
 		private external fun nativeDrawFrame(
 			surfaceTexture: SurfaceTexture,
 			flipYWebGL: Boolean,
+			trackedState: IntArray,
 			fbo: Int,
 			rbo: Int,
 			program: Int,
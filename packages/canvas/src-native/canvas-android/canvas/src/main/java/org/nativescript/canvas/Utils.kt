@@ -123,6 +123,8 @@ object Utils {
 	fun createSurfaceTexture(context: TNSWebGLRenderingContext): Array<Any> {
 		val render = TextureRender()
 		val lock = context.lock
+		// surfaceCreated leaves its vertex buffer bound
+		context.canvas.glState.invalidateArrayBuffer()
 		context.canvas.queueEvent {
 			render.surfaceCreated()
 			lock.countDown()
@@ -145,6 +147,8 @@ object Utils {
 	): TextureRender {
 		val render = TextureRender()
 		val lock = context.lock
+		// surfaceCreated leaves its vertex buffer bound
+		context.canvas.glState.invalidateArrayBuffer()
 		context.canvas.queueEvent {
 			render.surfaceCreated()
 			texture.attachToGLContext(render.textureId)
@@ -206,8 +210,9 @@ object Utils {
 		format: Int,
 	) {
 		val lock = context.lock
+		val state = context.canvas.glState.textureRenderState()
 		context.runOnGLThread {
-			render.drawFrame(texture, width, height, internalFormat, format, context.flipYWebGL)
+			render.drawFrame(texture, width, height, internalFormat, format, context.flipYWebGL, state)
 
 			if (render.width != width || render.height != width) {
 				render.width = width
@@ -222,6 +227,10 @@ object Utils {
 		} catch (ignored: InterruptedException) {
 		}
 
+		// drawFrame points and enables its own attribute without restoring it
+		context.canvas.vertexArrays.invalidate(context.canvas.glState.arrayBuffer())?.let {
+			context.applyVertexArray(it)
+		}
 	}
 
 
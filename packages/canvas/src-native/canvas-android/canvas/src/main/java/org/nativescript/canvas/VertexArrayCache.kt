@@ -0,0 +1,398 @@
+package org.nativescript.canvas
+
+import android.opengl.GLES20
+
+/**
+ * Vertex attribute state of a WebGL context's vertex arrays, kept on the calling thread like
+ * [GLStateCache]. Lets redundant enableVertexAttribArray, disableVertexAttribArray and
+ * vertexAttribPointer calls return without a round trip to the GL thread and lets getVertexAttrib
+ * answer without glGet.
+ *
+ * On ES 2 contexts, where the vertex array entry points can't be called, OES_vertex_array_object
+ * is emulated: each array records the attribute state set while it is bound, divisors included,
+ * and binding one replays only what differs from what GL has in a single native call. On ES 3
+ * contexts the driver owns the arrays and this only mirrors the bound one.
+ *
+ * Entries start out as a new context's defaults, anything changing attributes behind the WebGL
+ * calls has to [invalidate].
+ */
+internal class VertexArrayCache {
+	private class Attribute {
+		var enabled = false
+		var buffer = 0
+		var size = 4
+		var type = GLES20.GL_FLOAT
+		var normalized = false
+		var stride = 0
+		var offset = 0
+		var divisor = 0
+
+		// false once GL may have changed it without us knowing
+		var enabledKnown = true
+		var pointerKnown = true
+		var divisorKnown = true
+
+		fun samePointer(other: Attribute): Boolean {
+			return buffer == other.buffer && size == other.size && type == other.type &&
+				normalized == other.normalized && stride == other.stride && offset == other.offset
+		}
+
+		fun setPointer(buffer: Int, size: Int, type: Int, normalized: Boolean, stride: Int, offset: Int) {
+			this.buffer = buffer
+			this.size = size
+			this.type = type
+			this.normalized = normalized
+			this.stride = stride
+			this.offset = offset
+			pointerKnown = buffer != UNKNOWN
+		}
+
+		fun copyPointer(other: Attribute) {
+			setPointer(other.buffer, other.size, other.type, other.normalized, other.stride, other.offset)
+		}
+
+		fun forget() {
+			enabledKnown = false
+			pointerKnown = false
+			divisorKnown = false
+		}
+	}
+
+	private class VertexArray {
+		val attributes = Array(MAX_ATTRIBUTES) { Attribute() }
+		var elementArrayBuffer = 0
+
+		fun forget() {
+			for (attribute in attributes) {
+				attribute.forget()
+			}
+		}
+	}
+
+	// 0 is the default array
+	private val arrays = HashMap<Int, VertexArray>().apply { put(0, VertexArray()) }
+	private var current = 0
+	private var nextId = 1
+
+	// what GL has while emulating, the bound array is what the context asked for
+	private var gl: VertexArray? = null
+
+	// set from the GL thread when it creates a new context
+	@Volatile
+	private var resetPending = false
+
+	val isEmulated: Boolean
+		get() = gl != null
+
+	/**
+	 * Switches to emulated arrays, GL keeps the state the default array has so far.
+	 */
+	fun emulate() {
+		sync()
+		if (gl != null) {
+			return
+		}
+		val state = VertexArray()
+		val default = arrays.getValue(0)
+		for (i in 0 until MAX_ATTRIBUTES) {
+			val attribute = state.attributes[i]
+			val from = default.attributes[i]
+			attribute.enabled = from.enabled
+			attribute.enabledKnown = from.enabledKnown
+			attribute.copyPointer(from)
+			attribute.pointerKnown = from.pointerKnown
+			attribute.divisor = from.divisor
+			attribute.divisorKnown = from.divisorKnown
+		}
+		state.elementArrayBuffer = default.elementArrayBuffer
+		gl = state
+	}
+
+	/**
+	 * Forgets what GL has for every array, safe to call from any thread. For a new GL context,
+	 * which doesn't have the state of the old one.
+	 */
+	fun reset() {
+		resetPending = true
+	}
+
+	private fun sync() {
+		if (resetPending) {
+			resetPending = false
+			for (array in arrays.values) {
+				array.forget()
+			}
+			gl?.forget()
+		}
+	}
+
+	private fun actual(): VertexArray {
+		sync()
+		return gl ?: arrays.getValue(current)
+	}
+
+	private fun bound(): VertexArray {
+		sync()
+		return arrays.getValue(current)
+	}
+
+	/**
+	 * Creates an emulated array and returns its id.
+	 */
+	fun createVertexArray(): Int {
+		val id = nextId++
+		arrays[id] = VertexArray()
+		return id
+	}
+
+	/**
+	 * Starts tracking an array the driver created.
+	 */
+	fun created(id: Int) {
+		arrays[id] = VertexArray()
+	}
+
+	fun isVertexArray(id: Int): Boolean {
+		return id != 0 && arrays.containsKey(id)
+	}
+
+	/**
+	 * Makes [id] the bound array. While emulating, returns what has to be applied to GL for it, see
+	 * [TNSWebGLRenderingContext.applyVertexArray], null when the driver owns the arrays or [id]
+	 * isn't one. [arrayBuffer] is the array buffer binding to restore after the replay,
+	 * [GLStateCache.UNKNOWN] to have it queried.
+	 */
+	fun bind(id: Int, arrayBuffer: Int): IntArray? {
+		sync()
+		val gl = gl
+		if (gl == null) {
+			// an array we didn't see created, its state is whatever GL has
+			current = id
+			arrays.getOrPut(id) { VertexArray().apply { forget() } }
+			return null
+		}
+		val array = arrays[id] ?: return null
+		current = id
+		return replay(array, gl, arrayBuffer)
+	}
+
+	/**
+	 * Forgets [id], rebinding the default array when it's bound. Returns the replay of the
+	 * rebinding while emulating, see [bind].
+	 */
+	fun delete(id: Int, arrayBuffer: Int): IntArray? {
+		sync()
+		if (id == 0 || arrays.remove(id) == null) {
+			return null
+		}
+		if (current != id) {
+			return null
+		}
+		current = 0
+		val gl = gl ?: return null
+		return replay(arrays.getValue(0), gl, arrayBuffer)
+	}
+
+	/**
+	 * The element array buffer of the bound array as set through [bindElementArrayBuffer].
+	 */
+	fun elementArrayBuffer(): Int {
+		return bound().elementArrayBuffer
+	}
+
+	fun bindElementArrayBuffer(buffer: Int) {
+		bound().elementArrayBuffer = buffer
+		gl?.elementArrayBuffer = buffer
+	}
+
+	// Each setter records the new value and returns false when GL already has it.
+
+	fun enableVertexAttribArray(index: Int, enabled: Boolean): Boolean {
+		if (index !in 0 until MAX_ATTRIBUTES) {
+			return true
+		}
+		bound().attributes[index].let {
+			it.enabled = enabled
+			it.enabledKnown = true
+		}
+		val actual = actual().attributes[index]
+		if (actual.enabledKnown && actual.enabled == enabled) {
+			return false
+		}
+		actual.enabled = enabled
+		actual.enabledKnown = true
+		return true
+	}
+
+	fun vertexAttribDivisor(index: Int, divisor: Int): Boolean {
+		if (index !in 0 until MAX_ATTRIBUTES) {
+			return true
+		}
+		bound().attributes[index].let {
+			it.divisor = divisor
+			it.divisorKnown = true
+		}
+		val actual = actual().attributes[index]
+		if (actual.divisorKnown && actual.divisor == divisor) {
+			return false
+		}
+		actual.divisor = divisor
+		actual.divisorKnown = true
+		return true
+	}
+
+	/**
+	 * [buffer] is the array buffer bound when the call is made, [GLStateCache.UNKNOWN] records the
+	 * pointer as unknown until it's called again with the queried binding.
+	 */
+	fun vertexAttribPointer(index: Int, buffer: Int, size: Int, type: Int, normalized: Boolean, stride: Int, offset: Int): Boolean {
+		if (index !in 0 until MAX_ATTRIBUTES) {
+			return true
+		}
+		bound().attributes[index].setPointer(buffer, size, type, normalized, stride, offset)
+		val actual = actual().attributes[index]
+		if (buffer != UNKNOWN && actual.pointerKnown && actual.buffer == buffer && actual.size == size &&
+			actual.type == type && actual.normalized == normalized && actual.stride == stride && actual.offset == offset
+		) {
+			return false
+		}
+		actual.setPointer(buffer, size, type, normalized, stride, offset)
+		return true
+	}
+
+	/**
+	 * GL unbinds a deleted buffer from the bound array, mirror that. Other arrays keep it.
+	 */
+	fun deleteBuffer(buffer: Int) {
+		for (array in listOfNotNull(bound(), gl)) {
+			if (array.elementArrayBuffer == buffer) {
+				array.elementArrayBuffer = 0
+			}
+			for (attribute in array.attributes) {
+				if (attribute.buffer == buffer) {
+					attribute.buffer = 0
+				}
+			}
+		}
+	}
+
+	/**
+	 * Attribute state was changed behind the context's calls, e.g. by TextureRender. While
+	 * emulating, returns the replay that puts the bound array back, to run once the change is
+	 * done, otherwise the bound array's state is forgotten and null is returned.
+	 */
+	fun invalidate(arrayBuffer: Int): IntArray? {
+		sync()
+		val gl = gl
+		if (gl == null) {
+			bound().forget()
+			return null
+		}
+		gl.forget()
+		return replay(bound(), gl, arrayBuffer)
+	}
+
+	/**
+	 * Returns true when [getVertexAttrib] can answer [pname] for [index] without asking GL.
+	 */
+	fun isTracked(index: Int, pname: Int): Boolean {
+		if (index !in 0 until MAX_ATTRIBUTES) {
+			return false
+		}
+		val attribute = bound().attributes[index]
+		return when (pname) {
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_ENABLED -> attribute.enabledKnown
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_SIZE, GLES20.GL_VERTEX_ATTRIB_ARRAY_TYPE,
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, GLES20.GL_VERTEX_ATTRIB_ARRAY_STRIDE,
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, GLES20.GL_VERTEX_ATTRIB_ARRAY_POINTER -> attribute.pointerKnown
+			GL_VERTEX_ATTRIB_ARRAY_DIVISOR -> attribute.divisorKnown
+			else -> false
+		}
+	}
+
+	/**
+	 * Answers a tracked [pname] the way getVertexAttrib does, check [isTracked] first.
+	 * VERTEX_ATTRIB_ARRAY_POINTER answers getVertexAttribOffset.
+	 */
+	fun getVertexAttrib(index: Int, pname: Int): Any {
+		val attribute = bound().attributes[index]
+		return when (pname) {
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_ENABLED -> attribute.enabled
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_SIZE -> attribute.size
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_TYPE -> attribute.type
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_NORMALIZED -> attribute.normalized
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_STRIDE -> attribute.stride
+			GLES20.GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING -> attribute.buffer
+			GL_VERTEX_ATTRIB_ARRAY_DIVISOR -> attribute.divisor
+			else -> attribute.offset
+		}
+	}
+
+	/**
+	 * Brings [gl] to [array]'s state. The layout matches VERTEX_ARRAY_* in
+	 * android/gl/webgl_rendering_context.rs: the array buffer to restore and the element array
+	 * buffer to bind, then per attribute that changed its index, flags, enabled, buffer, size,
+	 * type, normalized, stride, offset and divisor.
+	 */
+	private fun replay(array: VertexArray, gl: VertexArray, arrayBuffer: Int): IntArray {
+		val state = ArrayList<Int>(HEADER_SIZE + ENTRY_SIZE * 4)
+		state.add(arrayBuffer)
+		state.add(array.elementArrayBuffer)
+		gl.elementArrayBuffer = array.elementArrayBuffer
+		for (i in 0 until MAX_ATTRIBUTES) {
+			val wanted = array.attributes[i]
+			val actual = gl.attributes[i]
+			var flags = 0
+			if (!wanted.enabledKnown) {
+				actual.enabledKnown = false
+			} else if (!actual.enabledKnown || actual.enabled != wanted.enabled) {
+				flags = flags or ENABLED_CHANGED
+				actual.enabled = wanted.enabled
+				actual.enabledKnown = true
+			}
+			if (!wanted.pointerKnown) {
+				actual.pointerKnown = false
+			} else if (!actual.pointerKnown || !actual.samePointer(wanted)) {
+				flags = flags or POINTER_CHANGED
+				actual.copyPointer(wanted)
+			}
+			// only ever differs once divisors were set, ES 2 without instancing never sees the call
+			if (!wanted.divisorKnown) {
+				actual.divisorKnown = false
+			} else if (!actual.divisorKnown || actual.divisor != wanted.divisor) {
+				flags = flags or DIVISOR_CHANGED
+				actual.divisor = wanted.divisor
+				actual.divisorKnown = true
+			}
+			if (flags != 0) {
+				state.add(i)
+				state.add(flags)
+				state.add(if (wanted.enabled) 1 else 0)
+				state.add(wanted.buffer)
+				state.add(wanted.size)
+				state.add(wanted.type)
+				state.add(if (wanted.normalized) 1 else 0)
+				state.add(wanted.stride)
+				state.add(wanted.offset)
+				state.add(wanted.divisor)
+			}
+		}
+		return state.toIntArray()
+	}
+
+	companion object {
+		const val UNKNOWN = GLStateCache.UNKNOWN
+
+		// GLES guarantees 8, most devices have 16
+		private const val MAX_ATTRIBUTES = 16
+
+		private const val HEADER_SIZE = 2
+		private const val ENTRY_SIZE = 10
+		private const val ENABLED_CHANGED = 1
+		private const val POINTER_CHANGED = 2
+		private const val DIVISOR_CHANGED = 4
+
+		// GLES30.GL_VERTEX_ATTRIB_ARRAY_DIVISOR, the same value as ANGLE's
+		private const val GL_VERTEX_ATTRIB_ARRAY_DIVISOR = 0x88FE
+	}
+}
@@ -0,0 +1,281 @@
+package org.nativescript.canvas
+
+import android.opengl.GLES20
+import android.opengl.GLES30
+import android.os.Build
+import androidx.annotation.RequiresApi
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Pending result of [TNSWebGLRenderingContext.readPixelsAsync]. [data] holds the pixels, rows
+ * bottom up as glReadPixels returns them, once [isDone] and there was no [error].
+ */
+class WebGLReadback internal constructor(
+	val width: Int,
+	val height: Int,
+	val format: Int,
+	val type: Int
+) {
+	interface Callback {
+		fun onSuccess(value: Any?)
+		fun onError(error: String?)
+	}
+
+	@Volatile
+	var isDone = false
+		private set
+
+	@Volatile
+	var data: ByteBuffer? = null
+		private set
+
+	@Volatile
+	var error: String? = null
+		private set
+
+	private var callbacks: ArrayList<Callback>? = ArrayList(1)
+
+	/**
+	 * Calls [callback] once the read completes, right away when it already has. Callbacks run on
+	 * the GL thread.
+	 */
+	fun then(callback: Callback) {
+		synchronized(this) {
+			val pending = callbacks
+			if (pending != null) {
+				pending.add(callback)
+				return
+			}
+		}
+		deliver(callback)
+	}
+
+	internal fun resolve(data: ByteBuffer) {
+		this.data = data
+		complete()
+	}
+
+	internal fun reject(error: String) {
+		this.error = error
+		complete()
+	}
+
+	private fun complete() {
+		val pending = synchronized(this) {
+			isDone = true
+			val pending = callbacks
+			callbacks = null
+			pending
+		} ?: return
+		for (callback in pending) {
+			deliver(callback)
+		}
+	}
+
+	private fun deliver(callback: Callback) {
+		val error = error
+		if (error != null) {
+			callback.onError(error)
+		} else {
+			callback.onSuccess(data)
+		}
+	}
+}
+
+/**
+ * Readbacks of a context in flight. On ES 3 contexts pixels are read into a pixel pack buffer and a
+ * fence is inserted, [poll] maps the buffer once the fence has signalled so neither thread waits on
+ * the GPU. Without ES 3 the read happens synchronously on the GL thread, in order with the calls
+ * queued before it, which still keeps the calling thread from blocking.
+ *
+ * Everything but [hasPending] runs on the GL thread.
+ */
+internal class PixelReadbacks {
+	private class Pending(
+		val readback: WebGLReadback,
+		val buffer: Int,
+		val size: Int,
+		val fence: Long
+	)
+
+	private val pending = ArrayList<Pending>()
+	private val pendingCount = AtomicInteger()
+
+	// pack buffers with their size, reused between reads of the same size
+	private val freeBuffers = ArrayList<IntArray>()
+
+	val hasPending: Boolean
+		get() = pendingCount.get() > 0
+
+	fun read(readback: WebGLReadback, x: Int, y: Int, useBuffers: Boolean) {
+		val alignment = IntArray(1)
+		GLES20.glGetIntegerv(GLES20.GL_PACK_ALIGNMENT, alignment, 0)
+		val size = byteSize(readback, alignment[0])
+		if (size <= 0) {
+			readback.reject("Unsupported format or type")
+			return
+		}
+		TNSStats.add(TNSStats.BYTES_READ_BACK, size.toLong())
+		if (useBuffers && Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN_MR2) {
+			readIntoBuffer(readback, x, y, size)
+		} else {
+			val data = allocate(size)
+			GLES20.glReadPixels(x, y, readback.width, readback.height, readback.format, readback.type, data)
+			readback.resolve(data)
+		}
+	}
+
+	@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+	private fun readIntoBuffer(readback: WebGLReadback, x: Int, y: Int, size: Int) {
+		val buffer = obtainBuffer(size)
+		val previous = packBufferBinding()
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, buffer)
+		GLES30.glReadPixels(x, y, readback.width, readback.height, readback.format, readback.type, 0)
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, previous)
+		val fence = GLES30.glFenceSync(GLES30.GL_SYNC_GPU_COMMANDS_COMPLETE, 0)
+		// make sure the fence reaches the GPU, otherwise it may never signal
+		GLES20.glFlush()
+		pending.add(Pending(readback, buffer, size, fence))
+		pendingCount.incrementAndGet()
+	}
+
+	/**
+	 * Completes the reads whose fence has signalled, called once per frame while [hasPending].
+	 */
+	fun poll() {
+		if (pending.isEmpty() || Build.VERSION.SDK_INT < Build.VERSION_CODES.JELLY_BEAN_MR2) {
+			return
+		}
+		val iterator = pending.iterator()
+		while (iterator.hasNext()) {
+			val read = iterator.next()
+			val status = GLES30.glClientWaitSync(read.fence, 0, 0)
+			if (status == GLES30.GL_TIMEOUT_EXPIRED) {
+				continue
+			}
+			iterator.remove()
+			pendingCount.decrementAndGet()
+			GLES30.glDeleteSync(read.fence)
+			if (status == GLES30.GL_WAIT_FAILED) {
+				recycleBuffer(read.buffer, read.size)
+				read.readback.reject("Failed waiting for the pixels")
+				continue
+			}
+			val data = map(read)
+			recycleBuffer(read.buffer, read.size)
+			if (data != null) {
+				read.readback.resolve(data)
+			} else {
+				read.readback.reject("Failed mapping the pixels")
+			}
+		}
+	}
+
+	/**
+	 * Drops everything, e.g. when the context goes away. Reads in flight fail.
+	 */
+	fun release() {
+		if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN_MR2) {
+			for (read in pending) {
+				GLES30.glDeleteSync(read.fence)
+				GLES20.glDeleteBuffers(1, intArrayOf(read.buffer), 0)
+				read.readback.reject("Context released")
+			}
+		}
+		pending.clear()
+		pendingCount.set(0)
+		for (buffer in freeBuffers) {
+			GLES20.glDeleteBuffers(1, buffer, 0)
+		}
+		freeBuffers.clear()
+	}
+
+	@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+	private fun map(read: Pending): ByteBuffer? {
+		val previous = packBufferBinding()
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, read.buffer)
+		val mapped = GLES30.glMapBufferRange(GLES30.GL_PIXEL_PACK_BUFFER, 0, read.size, GLES30.GL_MAP_READ_BIT) as ByteBuffer?
+		var data: ByteBuffer? = null
+		if (mapped != null) {
+			// the mapping is only valid until unmapped, hand out a copy
+			data = allocate(read.size)
+			data.put(mapped.order(ByteOrder.nativeOrder()))
+			data.rewind()
+			GLES30.glUnmapBuffer(GLES30.GL_PIXEL_PACK_BUFFER)
+		}
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, previous)
+		return data
+	}
+
+	private fun packBufferBinding(): Int {
+		val binding = IntArray(1)
+		GLES20.glGetIntegerv(GLES30.GL_PIXEL_PACK_BUFFER_BINDING, binding, 0)
+		return binding[0]
+	}
+
+	@RequiresApi(Build.VERSION_CODES.JELLY_BEAN_MR2)
+	private fun obtainBuffer(size: Int): Int {
+		val index = freeBuffers.indexOfFirst { it[1] == size }
+		if (index >= 0) {
+			return freeBuffers.removeAt(index)[0]
+		}
+		val buffer = IntArray(1)
+		GLES20.glGenBuffers(1, buffer, 0)
+		val previous = packBufferBinding()
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, buffer[0])
+		GLES30.glBufferData(GLES30.GL_PIXEL_PACK_BUFFER, size, null, GLES30.GL_STREAM_READ)
+		GLES30.glBindBuffer(GLES30.GL_PIXEL_PACK_BUFFER, previous)
+		return buffer[0]
+	}
+
+	private fun recycleBuffer(buffer: Int, size: Int) {
+		if (freeBuffers.size >= MAX_FREE_BUFFERS) {
+			GLES20.glDeleteBuffers(1, intArrayOf(freeBuffers.removeAt(0)[0]), 0)
+		}
+		freeBuffers.add(intArrayOf(buffer, size))
+	}
+
+	companion object {
+		private const val MAX_FREE_BUFFERS = 4
+
+		private fun allocate(size: Int): ByteBuffer {
+			return ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder())
+		}
+
+		private fun byteSize(readback: WebGLReadback, alignment: Int): Int {
+			return byteSize(readback.width, readback.height, readback.format, readback.type, alignment)
+		}
+
+		/**
+		 * Bytes glReadPixels writes for a [width] by [height] read with rows padded to [alignment],
+		 * 0 for an unsupported [format] or [type].
+		 */
+		internal fun byteSize(width: Int, height: Int, format: Int, type: Int, alignment: Int): Int {
+			val components = when (format) {
+				GLES20.GL_RGBA, GLES30.GL_RGBA_INTEGER -> 4
+				GLES20.GL_RGB, GLES30.GL_RGB_INTEGER -> 3
+				GLES30.GL_RG, GLES30.GL_RG_INTEGER, GLES20.GL_LUMINANCE_ALPHA -> 2
+				GLES30.GL_RED, GLES30.GL_RED_INTEGER, GLES20.GL_ALPHA, GLES20.GL_LUMINANCE -> 1
+				else -> return 0
+			}
+			val pixelSize = when (type) {
+				GLES20.GL_UNSIGNED_BYTE, GLES20.GL_BYTE -> components
+				GLES20.GL_UNSIGNED_SHORT_4_4_4_4, GLES20.GL_UNSIGNED_SHORT_5_5_5_1,
+				GLES20.GL_UNSIGNED_SHORT_5_6_5 -> 2
+				GLES20.GL_UNSIGNED_SHORT, GLES20.GL_SHORT, GLES30.GL_HALF_FLOAT -> components * 2
+				GLES20.GL_UNSIGNED_INT, GLES20.GL_INT, GLES20.GL_FLOAT -> components * 4
+				GLES30.GL_UNSIGNED_INT_2_10_10_10_REV, GLES30.GL_UNSIGNED_INT_10F_11F_11F_REV,
+				GLES30.GL_UNSIGNED_INT_5_9_9_9_REV -> 4
+				else -> return 0
+			}
+			if (width <= 0 || height <= 0) {
+				return 0
+			}
+			val padding = maxOf(alignment, 1) - 1
+			val rowSize = (width * pixelSize + padding) and padding.inv()
+			return rowSize * (height - 1) + width * pixelSize
+		}
+	}
+}
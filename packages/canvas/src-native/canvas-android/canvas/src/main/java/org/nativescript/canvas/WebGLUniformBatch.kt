@@ -0,0 +1,112 @@
+package org.nativescript.canvas
+
+import android.opengl.GLES20
+import android.opengl.GLES30
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Packs uniform values for [TNSWebGLRenderingContext.uniformBatch], which applies them to a program
+ * in one GL thread round trip and skips the ones unchanged since the last batch for that program.
+ *
+ * Each entry is a native order header of four ints, location, GL uniform type (e.g. FLOAT_VEC4 or
+ * FLOAT_MAT4), element count and flags (1 = transpose), followed by the 32 bit values. Reuse the
+ * batch across frames with [clear].
+ */
+class WebGLUniformBatch @JvmOverloads constructor(initialCapacity: Int = 4096) {
+	internal var buffer: ByteBuffer = allocate(initialCapacity)
+		private set
+
+	val size: Int
+		get() = buffer.position()
+
+	fun clear() {
+		buffer.clear()
+	}
+
+	@JvmOverloads
+	fun uniform(location: Int, type: Int, values: FloatArray, transpose: Boolean = false) {
+		val count = count(type, values.size) ?: return
+		header(location, type, count, transpose, values.size)
+		buffer.asFloatBuffer().put(values)
+		buffer.position(buffer.position() + values.size * SIZE_OF_VALUE)
+	}
+
+	fun uniform(location: Int, type: Int, values: IntArray) {
+		val count = count(type, values.size) ?: return
+		header(location, type, count, false, values.size)
+		buffer.asIntBuffer().put(values)
+		buffer.position(buffer.position() + values.size * SIZE_OF_VALUE)
+	}
+
+	fun uniform1f(location: Int, x: Float) {
+		header(location, GLES20.GL_FLOAT, 1, false, 1)
+		buffer.putFloat(x)
+	}
+
+	fun uniform1i(location: Int, x: Int) {
+		header(location, GLES20.GL_INT, 1, false, 1)
+		buffer.putInt(x)
+	}
+
+	private fun count(type: Int, length: Int): Int? {
+		val components = components(type)
+		if (components == 0 || length == 0 || length % components != 0) {
+			return null
+		}
+		return length / components
+	}
+
+	private fun header(location: Int, type: Int, count: Int, transpose: Boolean, length: Int) {
+		ensureCapacity(HEADER_SIZE + length * SIZE_OF_VALUE)
+		buffer.putInt(location)
+		buffer.putInt(type)
+		buffer.putInt(count)
+		buffer.putInt(if (transpose) 1 else 0)
+	}
+
+	private fun ensureCapacity(extra: Int) {
+		if (buffer.remaining() >= extra) {
+			return
+		}
+		val grown = allocate(maxOf(buffer.capacity() * 2, buffer.position() + extra))
+		buffer.flip()
+		grown.put(buffer)
+		buffer = grown
+	}
+
+	companion object {
+		private const val HEADER_SIZE = 16
+		private const val SIZE_OF_VALUE = 4
+
+		private fun allocate(capacity: Int): ByteBuffer {
+			return ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder())
+		}
+
+		/**
+		 * 32 bit values per element of a uniform of GL [type], 0 when it is not a uniform type.
+		 */
+		@JvmStatic
+		fun components(type: Int): Int {
+			return when (type) {
+				GLES20.GL_FLOAT, GLES20.GL_INT, GLES20.GL_UNSIGNED_INT, GLES20.GL_BOOL,
+				GLES20.GL_SAMPLER_2D, GLES20.GL_SAMPLER_CUBE, GLES30.GL_SAMPLER_3D,
+				GLES30.GL_SAMPLER_2D_SHADOW, GLES30.GL_SAMPLER_2D_ARRAY, GLES30.GL_SAMPLER_2D_ARRAY_SHADOW,
+				GLES30.GL_SAMPLER_CUBE_SHADOW, GLES30.GL_INT_SAMPLER_2D, GLES30.GL_INT_SAMPLER_3D,
+				GLES30.GL_INT_SAMPLER_CUBE, GLES30.GL_INT_SAMPLER_2D_ARRAY, GLES30.GL_UNSIGNED_INT_SAMPLER_2D,
+				GLES30.GL_UNSIGNED_INT_SAMPLER_3D, GLES30.GL_UNSIGNED_INT_SAMPLER_CUBE,
+				GLES30.GL_UNSIGNED_INT_SAMPLER_2D_ARRAY -> 1
+				GLES20.GL_FLOAT_VEC2, GLES20.GL_INT_VEC2, GLES30.GL_UNSIGNED_INT_VEC2, GLES20.GL_BOOL_VEC2 -> 2
+				GLES20.GL_FLOAT_VEC3, GLES20.GL_INT_VEC3, GLES30.GL_UNSIGNED_INT_VEC3, GLES20.GL_BOOL_VEC3 -> 3
+				GLES20.GL_FLOAT_VEC4, GLES20.GL_INT_VEC4, GLES30.GL_UNSIGNED_INT_VEC4, GLES20.GL_BOOL_VEC4,
+				GLES20.GL_FLOAT_MAT2 -> 4
+				GLES30.GL_FLOAT_MAT2x3, GLES30.GL_FLOAT_MAT3x2 -> 6
+				GLES30.GL_FLOAT_MAT2x4, GLES30.GL_FLOAT_MAT4x2 -> 8
+				GLES20.GL_FLOAT_MAT3 -> 9
+				GLES30.GL_FLOAT_MAT3x4, GLES30.GL_FLOAT_MAT4x3 -> 12
+				GLES20.GL_FLOAT_MAT4 -> 16
+				else -> 0
+			}
+		}
+	}
+}
@@ -3,22 +3,40 @@ package org.nativescript.canvas.extensions
 import android.opengl.GLES30
 import android.os.Build
 import androidx.annotation.RequiresApi
+import org.nativescript.canvas.TNSCanvas
+import org.nativescript.canvas.TNSStats
+import java.util.concurrent.TimeUnit
 
 /**
  * Created by triniwiz on 5/8/20
  */
 @RequiresApi(api = Build.VERSION_CODES.JELLY_BEAN_MR2)
-class ANGLE_instanced_arrays {
+class ANGLE_instanced_arrays(var canvas: TNSCanvas) {
 	val VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE = GLES30.GL_VERTEX_ATTRIB_ARRAY_DIVISOR
 	fun drawArraysInstancedANGLE(mode: Int, first: Int, count: Int, primcount: Int) {
 		GLES30.glDrawArraysInstanced(mode, first, count, primcount)
+		TNSStats.increment(TNSStats.GL_DRAW_ARRAYS)
 	}
 
 	fun drawElementsInstancedANGLE(mode: Int, count: Int, type: Int, offset: Int, primcount: Int) {
 		GLES30.glDrawElementsInstanced(mode, count, type, offset, primcount)
+		TNSStats.increment(TNSStats.GL_DRAW_ELEMENTS)
 	}
 
 	fun vertexAttribDivisorANGLE(index: Int, divisor: Int) {
-		GLES30.glVertexAttribDivisor(index, divisor)
+		// divisors belong to the bound vertex array, emulated ones replay them on bind
+		if (!canvas.vertexArrays.vertexAttribDivisor(index, divisor)) {
+			return
+		}
+		val lock = canvas.webGLRenderingContext?.lock ?: canvas.webGL2RenderingContext?.lock
+		canvas.queueEvent {
+			GLES30.glVertexAttribDivisor(index, divisor)
+			lock?.countDown()
+		}
+		try {
+			lock?.await(2, TimeUnit.SECONDS)
+			lock?.reset()
+		} catch (ignored: InterruptedException) {
+		}
 	}
 }
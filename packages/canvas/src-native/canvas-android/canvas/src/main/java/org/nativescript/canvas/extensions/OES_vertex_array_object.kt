@@ -1,20 +1,37 @@
 package org.nativescript.canvas.extensions
 
+import android.opengl.GLES20
 import android.opengl.GLES30
 import android.os.Build
 import androidx.annotation.RequiresApi
 import org.nativescript.canvas.Constants
+import org.nativescript.canvas.GLStateCache
 import org.nativescript.canvas.TNSCanvas
-import java.util.concurrent.CountDownLatch
+import org.nativescript.canvas.VertexArrayCache
 import java.util.concurrent.TimeUnit
 
 /**
  * Created by triniwiz on 5/1/20
+ *
+ * When [emulated], arrays live in [VertexArrayCache] and binding one replays its attribute state,
+ * otherwise they are the driver's.
  */
 @RequiresApi(api = Build.VERSION_CODES.JELLY_BEAN_MR2)
-class OES_vertex_array_object(var canvas: TNSCanvas) {
+class OES_vertex_array_object(var canvas: TNSCanvas, private val emulated: Boolean = false) {
 	var VERTEX_ARRAY_BINDING_OES = Constants.GL_VERTEX_ARRAY_BINDING_OES
+
+	// switched here rather than on creation, the extension is created on the GL thread
+	private val vertexArrays: VertexArrayCache
+		get() = canvas.vertexArrays.also {
+			if (emulated) {
+				it.emulate()
+			}
+		}
+
 	fun createVertexArrayOES(): Int {
+		if (emulated) {
+			return vertexArrays.createVertexArray()
+		}
 		val array = IntArray(1)
 		val lock = canvas.webGLRenderingContext?.lock ?: canvas.webGL2RenderingContext?.lock
 		canvas.queueEvent {
@@ -23,12 +40,20 @@ class OES_vertex_array_object(var canvas: TNSCanvas) {
 		}
 		try {
 			lock?.await(2, TimeUnit.SECONDS)
+			lock?.reset()
 		} catch (ignored: InterruptedException) {
 		}
+		vertexArrays.created(array[0])
 		return array[0]
 	}
 
 	fun deleteVertexArrayOES(arrayObject: Int) {
+		canvas.glState.deleteVertexArray(arrayObject)
+		if (emulated) {
+			apply(vertexArrays.delete(arrayObject, canvas.glState.arrayBuffer()))
+			return
+		}
+		vertexArrays.delete(arrayObject, GLStateCache.UNKNOWN)
 		val array = intArrayOf(arrayObject)
 		val lock = canvas.webGLRenderingContext?.lock ?: canvas.webGL2RenderingContext?.lock
 		canvas.queueEvent {
@@ -37,11 +62,15 @@ class OES_vertex_array_object(var canvas: TNSCanvas) {
 		}
 		try {
 			lock?.await(2, TimeUnit.SECONDS)
+			lock?.reset()
 		} catch (ignored: InterruptedException) {
 		}
 	}
 
 	fun isVertexArrayOES(arrayObject: Int): Boolean {
+		if (emulated) {
+			return vertexArrays.isVertexArray(arrayObject)
+		}
 		val value = BooleanArray(1)
 		val lock = canvas.webGLRenderingContext?.lock ?: canvas.webGL2RenderingContext?.lock
 		canvas.queueEvent {
@@ -50,12 +79,24 @@ class OES_vertex_array_object(var canvas: TNSCanvas) {
 		}
 		try {
 			lock?.await(2, TimeUnit.SECONDS)
+			lock?.reset()
 		} catch (ignored: InterruptedException) {
 		}
 		return value[0]
 	}
 
 	fun bindVertexArrayOES(arrayObject: Int) {
+		if (emulated && arrayObject != 0 && !vertexArrays.isVertexArray(arrayObject)) {
+			return
+		}
+		if (!canvas.glState.bindVertexArray(arrayObject)) {
+			return
+		}
+		if (emulated) {
+			apply(vertexArrays.bind(arrayObject, canvas.glState.arrayBuffer()))
+			return
+		}
+		vertexArrays.bind(arrayObject, GLStateCache.UNKNOWN)
 		val lock = canvas.webGLRenderingContext?.lock ?: canvas.webGL2RenderingContext?.lock
 		canvas.queueEvent {
 			GLES30.glBindVertexArray(arrayObject)
@@ -63,7 +104,16 @@ class OES_vertex_array_object(var canvas: TNSCanvas) {
 		}
 		try {
 			lock?.await(2, TimeUnit.SECONDS)
+			lock?.reset()
 		} catch (ignored: InterruptedException) {
 		}
 	}
+
+	private fun apply(state: IntArray?) {
+		state ?: return
+		// the replay binds the array's element buffer
+		canvas.glState.bindBuffer(GLES20.GL_ELEMENT_ARRAY_BUFFER, vertexArrays.elementArrayBuffer())
+		val context = canvas.webGLRenderingContext ?: canvas.webGL2RenderingContext
+		context?.applyVertexArray(state)
+	}
 }
@@ -7,65 +7,201 @@
 
 import Foundation
 import UIKit
+
+/// Runs once per frame after the animation frame callbacks, e.g. a canvas flushing what they drew.
+@objc(TNSFrameListener)
+public protocol TNSFrameListener: AnyObject {
+    /// interval is the seconds between display refreshes at the current frame rate.
+    func onFrame(_ interval: Double)
+}
+
+/// Timings of the frames run since the last reset, times are in milliseconds.
+@objcMembers
+@objc(TNSFrameStats)
+public class TNSFrameStats: NSObject {
+    public let frames: Int
+    public let droppedFrames: Int
+    public let callbackTime: Double
+    public let averageCallbackTime: Double
+    public let maxCallbackTime: Double
+    public let flushTime: Double
+    public let averageFlushTime: Double
+    public let maxFlushTime: Double
+    public let frameInterval: Double
+
+    init(frames: Int, droppedFrames: Int, callbackTime: Double, averageCallbackTime: Double, maxCallbackTime: Double, flushTime: Double, averageFlushTime: Double, maxFlushTime: Double, frameInterval: Double) {
+        self.frames = frames
+        self.droppedFrames = droppedFrames
+        self.callbackTime = callbackTime
+        self.averageCallbackTime = averageCallbackTime
+        self.maxCallbackTime = maxCallbackTime
+        self.flushTime = flushTime
+        self.averageFlushTime = averageFlushTime
+        self.maxFlushTime = maxFlushTime
+        self.frameInterval = frameInterval
+    }
+}
+
+/// requestAnimationFrame on one display link shared with the canvases. Callbacks run in the order
+/// they were requested with the vsync timestamp of the frame, the ones requested while a frame runs
+/// wait for the next one. The display link pauses while there is nothing to run.
+///
+/// Everything runs on the main thread.
 @objcMembers
 @objc(TNSAnimationFrame)
 public class TNSAnimationFrame: NSObject {
-    static var displayLink: CADisplayLink?
-    static var callbacks: [String: (Float) -> Void] = [:]
-    static var exitObserver: Any?
-    static var enterObserver: Any?
-    static var lastTime = 0.0
-    @objc static func handleAnimation(displayLink: CADisplayLink){
-        var ts: Float = 0
-        let currentTime = displayLink.timestamp * 1000
-        if(lastTime != 0.0){
-            ts = Float(currentTime)
-        }
-        for (_,callback) in callbacks.enumerated() {
-            callback.value(ts)
-            callbacks.removeValue(forKey: callback.key)
+    private struct Callback {
+        let id: Int
+        let callback: (Float) -> Void
+    }
+
+    private class WeakListener {
+        weak var listener: TNSFrameListener?
+        init(_ listener: TNSFrameListener) {
+            self.listener = listener
         }
-        lastTime = currentTime
-        if(callbacks.count == 0){
-            self.displayLink?.invalidate()
-            self.displayLink = nil
+    }
+
+    private static var displayLink: CADisplayLink?
+    private static var observers: [Any] = []
+    private static var isActive = true
+    private static var nextId = 1
+    private static var callbacks: [Callback] = []
+    // callbacks of the running frame that haven't run yet, last to run first
+    private static var running: [Callback] = []
+    private static var listeners: [WeakListener] = []
+    // timestamp of the previous frame while running continuously, 0 after a pause
+    private static var lastTimestamp: CFTimeInterval = 0
+
+    private static var frames = 0
+    private static var droppedFrames = 0
+    private static var callbackTime = 0.0
+    private static var totalCallbackTime = 0.0
+    private static var maxCallbackTime = 0.0
+    private static var flushTime = 0.0
+    private static var totalFlushTime = 0.0
+    private static var maxFlushTime = 0.0
+    private static var frameInterval = 0.0
+
+    /// Frames per second callbacks run at, 0 for the display's rate.
+    public static var targetFrameRate = 0 {
+        didSet {
+            displayLink?.preferredFramesPerSecond = targetFrameRate
+            lastTimestamp = 0
         }
     }
-    
-    public static func requestAnimationFrame(toLoop: @escaping (Float) -> Void){
-        callbacks[UUID().uuidString] = toLoop
-        if(displayLink == nil){
-            displayLink = CADisplayLink(target: self, selector: #selector(handleAnimation))
-            //displayLink?.preferredFramesPerSecond = 60
-            displayLink?.add(to: .main, forMode: .common)
-            
-            exitObserver = NotificationCenter.default.addObserver(forName: UIApplication.didEnterBackgroundNotification, object: nil, queue: nil) { _ in
-                self.displayLink?.invalidate()
-                self.displayLink = nil
-                self.lastTime = 0.0
-            }
-            
-            enterObserver = NotificationCenter.default.addObserver(forName: UIApplication.didBecomeActiveNotification, object: nil, queue: nil) { _ in
-                displayLink = CADisplayLink(target: self, selector: #selector(handleAnimation))
-                //displayLink?.preferredFramesPerSecond = 60
-                displayLink?.add(to: .current, forMode: .common)
+
+    @objc static func handleAnimation(displayLink: CADisplayLink){
+        let interval = displayLink.targetTimestamp - displayLink.timestamp
+        if lastTimestamp != 0 && interval > 0 {
+            let missed = Int(((displayLink.timestamp - lastTimestamp) / interval).rounded()) - 1
+            if missed > 0 {
+                droppedFrames += missed
             }
-            
         }
+        lastTimestamp = displayLink.timestamp
+        frameInterval = interval * 1000
+
+        let start = CACurrentMediaTime()
+        let ts = Float(displayLink.timestamp * 1000)
+        running = callbacks.reversed()
+        callbacks.removeAll(keepingCapacity: true)
+        while let entry = running.popLast() {
+            entry.callback(ts)
+        }
+        let callbacksDone = CACurrentMediaTime()
+
+        listeners.removeAll { $0.listener == nil }
+        for entry in listeners {
+            entry.listener?.onFrame(interval)
+        }
+        let end = CACurrentMediaTime()
+        if TNSCanvas.profilerEnabled {
+            profiler_record("frame", UInt64((end - start) * 1_000_000_000))
+        }
+        stats_end_frame()
+
+        frames += 1
+        callbackTime = (callbacksDone - start) * 1000
+        totalCallbackTime += callbackTime
+        maxCallbackTime = max(maxCallbackTime, callbackTime)
+        flushTime = (end - callbacksDone) * 1000
+        totalFlushTime += flushTime
+        maxFlushTime = max(maxFlushTime, flushTime)
+
+        updatePaused()
     }
-    
-    public static func cancelAnimationFrame(id: String){
-        callbacks.removeValue(forKey: id)
-        if(callbacks.count == 0){
-            displayLink?.invalidate()
-            displayLink = nil
-            lastTime = 0.0
-            if(exitObserver != nil){
-                NotificationCenter.default.removeObserver(exitObserver!)
-            }
-            if(enterObserver != nil){
-                NotificationCenter.default.removeObserver(enterObserver!)
-            }
+
+    /// Runs toLoop with the timestamp of the next frame in milliseconds, returns the id to cancel it with.
+    @discardableResult
+    public static func requestAnimationFrame(toLoop: @escaping (Float) -> Void) -> Int {
+        let id = nextId
+        nextId += 1
+        callbacks.append(Callback(id: id, callback: toLoop))
+        updatePaused()
+        return id
+    }
+
+    public static func cancelAnimationFrame(id: Int){
+        // also cancels a callback of the running frame that hasn't run yet
+        callbacks.removeAll { $0.id == id }
+        running.removeAll { $0.id == id }
+        updatePaused()
+    }
+
+    public static func addFrameListener(_ listener: TNSFrameListener) {
+        if listeners.contains(where: { $0.listener === listener }) {return}
+        listeners.append(WeakListener(listener))
+        updatePaused()
+    }
+
+    public static func removeFrameListener(_ listener: TNSFrameListener) {
+        listeners.removeAll { $0.listener == nil || $0.listener === listener }
+        updatePaused()
+    }
+
+    public static func stats() -> TNSFrameStats {
+        let count = Double(max(frames, 1))
+        return TNSFrameStats(frames: frames, droppedFrames: droppedFrames, callbackTime: callbackTime, averageCallbackTime: totalCallbackTime / count, maxCallbackTime: maxCallbackTime, flushTime: flushTime, averageFlushTime: totalFlushTime / count, maxFlushTime: maxFlushTime, frameInterval: frameInterval)
+    }
+
+    public static func resetStats() {
+        frames = 0
+        droppedFrames = 0
+        callbackTime = 0
+        totalCallbackTime = 0
+        maxCallbackTime = 0
+        flushTime = 0
+        totalFlushTime = 0
+        maxFlushTime = 0
+    }
+
+    // the display link is created once and paused while idle or in the background
+    private static func updatePaused() {
+        let idle = !isActive || (callbacks.isEmpty && listeners.isEmpty)
+        if displayLink == nil {
+            if idle {return}
+            let link = CADisplayLink(target: self, selector: #selector(handleAnimation))
+            link.preferredFramesPerSecond = targetFrameRate
+            link.add(to: .main, forMode: .common)
+            displayLink = link
+            observeApplicationState()
+        }
+        if idle {
+            lastTimestamp = 0
         }
+        displayLink?.isPaused = idle
+    }
+
+    private static func observeApplicationState() {
+        if !observers.isEmpty {return}
+        observers.append(NotificationCenter.default.addObserver(forName: UIApplication.didEnterBackgroundNotification, object: nil, queue: .main) { _ in
+            isActive = false
+            updatePaused()
+        })
+        observers.append(NotificationCenter.default.addObserver(forName: UIApplication.didBecomeActiveNotification, object: nil, queue: .main) { _ in
+            isActive = true
+            updatePaused()
+        })
     }
 }
@@ -12,7 +12,7 @@ import MetalKit
 
 @objcMembers
 @objc(TNSCanvas)
-public class TNSCanvas: UIView, RenderListener {
+public class TNSCanvas: UIView, RenderListener, TNSFrameListener {
     
     internal static let INVALIDATE_STATE_NONE = 0
     internal static let INVALIDATE_STATE_PENDING = 1
@@ -24,7 +24,6 @@ public class TNSCanvas: UIView, RenderListener {
         return views
     }
     
-    var displayLink: CADisplayLink?
     var ptr: UnsafeMutableRawPointer?
     
     public func getViewPtr() -> UnsafeMutableRawPointer? {
@@ -77,6 +76,63 @@ public class TNSCanvas: UIView, RenderListener {
         TNSDOMMatrix()
     }
     
+    // Custom fonts are shared by every 2D context and matched by family before the system fonts,
+    // a nil family registers the font under the family name stored in the file.
+    public static func registerFont(_ path: String,_ family: String?) -> Bool {
+        return font_registry_register_path(path, family)
+    }
+    
+    public static func registerFont(data: Data,_ family: String?) -> Bool {
+        return data.withUnsafeBytes { (ptr: UnsafeRawBufferPointer) -> Bool in
+            let bytes = ptr.bindMemory(to: UInt8.self)
+            return font_registry_register_bytes(bytes.baseAddress, UInt(bytes.count), family)
+        }
+    }
+    
+    public static func unregisterFont(_ family: String) -> Bool {
+        return font_registry_unregister(family)
+    }
+    
+    public static func clearFonts() {
+        font_registry_clear()
+    }
+    
+    // Native timings dumped as Chrome trace JSON, only recorded when the library was built with
+    // the profiler feature, setProfilerEnabled returns false otherwise.
+    static var profilerEnabled = false
+    
+    public static func setProfilerEnabled(_ enabled: Bool) -> Bool {
+        profilerEnabled = profiler_set_enabled(enabled)
+        return profilerEnabled
+    }
+    
+    public static func profilerDump() -> String {
+        guard let cStr = profiler_dump() else {return ""}
+        let trace = String(cString: cStr)
+        destroy_string(cStr)
+        return trace
+    }
+    
+    public static func clearProfiler() {
+        profiler_clear()
+    }
+    
+    // Draw calls, state changes, copies, bytes moved, cache hits and native objects alive,
+    // lastFrame returns what the last frame added rather than the totals since resetStats.
+    public static func stats(lastFrame: Bool = false) -> CanvasStats {
+        var stats = CanvasStats()
+        stats_get(&stats, lastFrame)
+        return stats
+    }
+    
+    public static func resetStats() {
+        stats_reset()
+    }
+    
+    static func count(_ counter: Counter, _ value: Int = 1) {
+        stats_add(counter.rawValue, UInt64(max(value, 0)))
+    }
+    
     var isContextLost: Bool = false
     var _handleInvalidationManually: Bool = false
     public var handleInvalidationManually: Bool {
@@ -86,12 +142,9 @@ public class TNSCanvas: UIView, RenderListener {
         set {
             _handleInvalidationManually = newValue
             if(newValue){
-                displayLink?.invalidate()
-                displayLink = nil
-                _fps = 0
+                stopFrames()
             }else {
-                displayLink = CADisplayLink(target: self, selector: #selector(handleAnimation))
-                displayLink?.add(to: .main, forMode: .common)
+                startFrames()
             }
         }
     }
@@ -190,6 +243,16 @@ public class TNSCanvas: UIView, RenderListener {
     }
     
     
+    // Native image handle of a 2D canvas for drawing into another context without copying the
+    // pixels out, 0 for other context types. Consumed by context_draw_image_snapshot.
+    func snapshotImage() -> Int64 {
+        if(renderer.contextType != ContextType.twoD){
+            return 0
+        }
+        renderer.ensureIsContextIsCurrent()
+        return context_snapshot_image(self.context)
+    }
+    
     public func snapshotEncoded() -> [UInt8]{
         renderer.ensureIsContextIsCurrent()
         if(renderer.contextType == ContextType.twoD){
@@ -279,22 +342,8 @@ public class TNSCanvas: UIView, RenderListener {
     func realInit() {
         setup()
         self.isOpaque = false
-        self.displayLink = CADisplayLink(target: self, selector: #selector(handleAnimation))
-        self.displayLink?.preferredFramesPerSecond = 60
-        self.displayLink?.add(to: .main, forMode: .common)
-        
-        NotificationCenter.default.addObserver(forName: UIApplication.didEnterBackgroundNotification, object: nil, queue: nil) { _ in
-            self.displayLink?.invalidate()
-            self.displayLink = nil
-            self._fps = 0
-        }
-        
-        NotificationCenter.default.addObserver(forName: UIApplication.didBecomeActiveNotification, object: nil, queue: nil) { _ in
-            if(self.displayLink == nil){
-                self.displayLink = CADisplayLink(target: self, selector: #selector(self.handleAnimation))
-                self.displayLink?.add(to: .main, forMode: .common)
-            }
-        }
+        // TNSAnimationFrame pauses its display link in the background
+        startFrames()
     }
     
     private var useCpu: Bool
@@ -318,8 +367,18 @@ public class TNSCanvas: UIView, RenderListener {
         }
     }
     
-    @objc func handleAnimation(displayLink: CADisplayLink){
-        self._fps = Float(1 / (displayLink.targetTimestamp - displayLink.timestamp))
+    // flushes on the display link shared with requestAnimationFrame, after this frame's callbacks ran
+    func startFrames(){
+        TNSAnimationFrame.addFrameListener(self)
+    }
+    
+    func stopFrames(){
+        TNSAnimationFrame.removeFrameListener(self)
+        _fps = 0
+    }
+    
+    public func onFrame(_ interval: Double){
+        self._fps = interval > 0 ? Float(1 / interval) : 0
         
         if((renderer.invalidateState & TNSCanvas.INVALIDATE_STATE_INVALIDATING) == TNSCanvas.INVALIDATE_STATE_INVALIDATING){
             renderer.invalidateState = renderer.invalidateState & TNSCanvas.INVALIDATE_STATE_PENDING
@@ -417,14 +476,11 @@ public class TNSCanvas: UIView, RenderListener {
     }
     
     public func resume(){
-        self.displayLink = CADisplayLink(target: self, selector: #selector(self.handleAnimation))
-        self.displayLink?.add(to: .main, forMode: .common)
+        startFrames()
         renderer.resume()
     }
     public func pause(){
-        displayLink?.invalidate()
-        displayLink = nil
-        _fps = 0
+        stopFrames()
         renderer.pause()
     }
     
@@ -441,14 +497,12 @@ public class TNSCanvas: UIView, RenderListener {
     }
     
     public func handleMoveOffMain(){
-        self.displayLink = CADisplayLink(target: self, selector: #selector(self.handleAnimation))
-        self.displayLink?.add(to: .main, forMode: .common)
+        startFrames()
         renderer.resume()
     }
     
     public func handleMoveToMain(){
-        self.displayLink = CADisplayLink(target: self, selector: #selector(self.handleAnimation))
-        self.displayLink?.add(to: .main, forMode: .common)
+        startFrames()
         renderer.resume()
     }
     
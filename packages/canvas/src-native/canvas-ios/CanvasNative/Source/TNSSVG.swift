@@ -13,6 +13,9 @@ public class TNSSVG: UIView {
     var data_size: CGSize = .zero
     var buf_size: UInt = 0
     var context: Int64 = 0
+    // retained document of src, created by the first edit and only touched on queue.
+    // Until then src is drawn through the shared native cache
+    var document: Int64 = 0
     var didInitDrawing = false
     var forceResize = false
     public var ignorePixelScaling = false {
@@ -22,6 +25,9 @@ public class TNSSVG: UIView {
     }
     public var src: String? = nil {
         didSet {
+            queue.async { [weak self] in
+                self?.releaseDocument()
+            }
             doDraw()
         }
     }
@@ -66,7 +72,11 @@ public class TNSSVG: UIView {
                     
                     guard let src = self.src else{return}
                     let source = src as NSString
-                    svg_draw_from_string(self.context, source.utf8String)
+                    if(self.document != 0){
+                        svg_draw_document(self.context, self.document)
+                    }else {
+                        svg_draw_from_string(self.context, source.utf8String)
+                    }
                     guard let buf = self.data?.assumingMemoryBound(to: UInt8.self) else {return}
                     context_custom_with_buffer_flush(self.context, buf, self.buf_size, Float(self.data_size.width), Float(self.data_size.height))
                     
@@ -83,6 +93,83 @@ public class TNSSVG: UIView {
         queue.async(execute: workItem!)
     }
     
+    private func releaseDocument() {
+        if document != 0 {
+            svg_document_destroy(document)
+            document = 0
+        }
+    }
+    
+    private func retainedDocument() -> Int64 {
+        if document == 0, let src = src {
+            document = svg_document_create((src as NSString).utf8String)
+        }
+        return document
+    }
+    
+    /// Bytes the native cache of parsed svgs and their recorded pictures may use, shared by every
+    /// TNSSVG. 0 disables the cache.
+    public static func setCacheBudget(_ bytes: Int64) {
+        svg_set_cache_budget(bytes)
+    }
+    
+    private func node(_ document: Int64, _ id: String?) -> Int32 {
+        return svg_document_element_by_id(document, (id as NSString?)?.utf8String)
+    }
+    
+    // runs block against the retained document and redraws when it changed something
+    private func edit(_ block: @escaping (Int64) -> Bool) {
+        queue.async { [weak self] in
+            guard let self = self else {return}
+            let document = self.retainedDocument()
+            if document != 0 && block(document) {
+                DispatchQueue.main.async { [weak self] in
+                    self?.doDraw()
+                }
+            }
+        }
+    }
+    
+    /// Sets an attribute of the element with id in src, or of the root when id is nil, without
+    /// parsing src again. A nil value removes the attribute.
+    public func setAttribute(_ id: String?, _ name: String, _ value: String?) {
+        edit { document in
+            let node = self.node(document, id)
+            if node < 0 {return false}
+            return svg_document_set_attribute(document, node, (name as NSString).utf8String, (value as NSString?)?.utf8String)
+        }
+    }
+    
+    public func setText(_ id: String?, _ text: String) {
+        edit { document in
+            let node = self.node(document, id)
+            if node < 0 {return false}
+            return svg_document_set_text(document, node, (text as NSString).utf8String)
+        }
+    }
+    
+    /// Parses xml and appends it to the element with parentId, or to the root when it is nil.
+    public func appendChild(_ parentId: String?, _ xml: String) {
+        edit { document in
+            let node = self.node(document, parentId)
+            if node < 0 {return false}
+            return svg_document_append_child(document, node, (xml as NSString).utf8String) >= 0
+        }
+    }
+    
+    public func removeElement(_ id: String) {
+        edit { document in
+            let node = self.node(document, id)
+            if node < 0 {return false}
+            return svg_document_remove(document, node)
+        }
+    }
+    
+    deinit {
+        if document != 0 {
+            svg_document_destroy(document)
+        }
+    }
 
     func update(){
         let size = layer.frame.size
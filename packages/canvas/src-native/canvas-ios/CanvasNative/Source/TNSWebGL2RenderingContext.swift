@@ -323,6 +323,7 @@ public class TNSWebGL2RenderingContext: TNSWebGLRenderingContext {
         let _ = canvas.renderer.ensureIsContextIsCurrent()
         clearIfComposited()
         glDrawArraysInstanced(mode, first, count, instanceCount)
+        TNSCanvas.count(GlDrawArrays)
         canvas.doDraw()
     }
     
@@ -331,6 +332,7 @@ public class TNSWebGL2RenderingContext: TNSWebGLRenderingContext {
         var indices = offset
         clearIfComposited()
         glDrawElementsInstanced(mode, count, type, &indices, instanceCount)
+        TNSCanvas.count(GlDrawElements)
         canvas.doDraw()
     }
     
@@ -339,6 +341,7 @@ public class TNSWebGL2RenderingContext: TNSWebGLRenderingContext {
         var indices = offset
         clearIfComposited()
         glDrawRangeElements(mode, start, end, count, type, &indices)
+        TNSCanvas.count(GlDrawElements)
         canvas.doDraw()
     }
     
@@ -489,6 +492,7 @@ public class TNSWebGL2RenderingContext: TNSWebGLRenderingContext {
         
         // var offset = srcByteOffset * SIZE_OF_BYTE
         glBufferSubData(target, byteOffset, byteLength, dstData.advanced(by: offset))
+        TNSCanvas.count(BytesUploaded, byteLength)
     }
     
     
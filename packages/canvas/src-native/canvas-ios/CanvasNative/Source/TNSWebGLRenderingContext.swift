@@ -216,6 +216,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_BYTE, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_BYTE)
     }
     
     
@@ -226,6 +227,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
     public func bufferData(_ target: UInt32, srcData: UnsafeMutableRawPointer, size: Int, _ usage: UInt32, offset: Int){
         canvas.renderer.ensureIsContextIsCurrent()
         glBufferData(target, size , srcData.advanced(by: offset), usage)
+        TNSCanvas.count(BytesUploaded, size)
     }
     
     
@@ -234,6 +236,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_BYTE, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_BYTE)
     }
     
     
@@ -242,12 +245,14 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_SHORT, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_SHORT)
     }
     
     public func bufferData(_ target: UInt32, u16 srcData: [UInt16], _ usage: UInt32){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_SHORT, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_SHORT)
     }
     
     
@@ -255,12 +260,14 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_INT, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_INT)
     }
     
     public func bufferData(_ target: UInt32, u32 srcData: [UInt32], _ usage: UInt32){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_INT, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_INT)
     }
     
     
@@ -268,12 +275,14 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_FLOAT, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_FLOAT)
     }
     
     public func bufferData(_ target: UInt32, f64 srcData: [Float64], _ usage: UInt32){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferData(target, buffer.count * SIZE_OF_DOUBLE, &buffer, usage)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_DOUBLE)
     }
     
     
@@ -287,6 +296,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count)
     }
     
     
@@ -297,6 +307,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
     public func bufferSubData(_ target: UInt32,_ offset: Int, srcData: UnsafeMutableRawPointer, size: Int, os: Int){
         canvas.renderer.ensureIsContextIsCurrent()
         glBufferSubData(target, offset, size, srcData.advanced(by: os))
+        TNSCanvas.count(BytesUploaded, size)
     }
     
     
@@ -305,6 +316,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count)
     }
     
     
@@ -312,36 +324,42 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_SHORT, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_SHORT)
     }
     
     public func bufferSubData(_ target: UInt32,_ offset: Int,u16 srcData: [UInt16]){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_SHORT, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_SHORT)
     }
     
     public func bufferSubData(_ target: UInt32,_ offset: Int,i32 srcData: [Int32]){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_INT, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_INT)
     }
     
     public func bufferSubData(_ target: UInt32,_ offset: Int,u32 srcData: [UInt32]){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_INT, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_INT)
     }
     
     public func bufferSubData(_ target: UInt32,_ offset: Int,f32 srcData: [Float32]){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_FLOAT, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_FLOAT)
     }
     
     public func bufferSubData(_ target: UInt32,_ offset: Int,f64 srcData: [Float64]){
         canvas.renderer.ensureIsContextIsCurrent()
         var buffer = srcData
         glBufferSubData(target, offset, buffer.count * SIZE_OF_DOUBLE, &buffer)
+        TNSCanvas.count(BytesUploaded, buffer.count * SIZE_OF_DOUBLE)
     }
     
     
@@ -613,6 +631,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         clearIfComposited()
         glDrawArrays(mode, first, count)
+        TNSCanvas.count(GlDrawArrays)
         canvas.doDraw()
     }
     
@@ -629,6 +648,7 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         let ptr = BUFFER_OFFSET(n: offset)
         clearIfComposited()
         glDrawElements(mode, count, type, ptr)
+        TNSCanvas.count(GlDrawElements)
         canvas.doDraw()
     }
     
@@ -1396,6 +1416,8 @@ public class TNSWebGLRenderingContext: TNSCanvasRenderingContext {
         canvas.renderer.ensureIsContextIsCurrent()
         clearIfComposited()
         glReadPixels(x, y, width, height, format, type, pixels.advanced(by: offset))
+        // RGBA and UNSIGNED_BYTE, the read every implementation supports
+        TNSCanvas.count(BytesReadBack, Int(width) * Int(height) * 4)
         
     }
     
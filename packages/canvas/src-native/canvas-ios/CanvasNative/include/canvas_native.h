@@ -37,6 +37,31 @@ typedef enum CompositeOperationType {
   Luminosity = 25,
 } CompositeOperationType;
 
+typedef enum Counter {
+  DrawRect = 0,
+  DrawPath = 1,
+  DrawImage = 2,
+  DrawText = 3,
+  DrawOther = 4,
+  GlDrawArrays = 5,
+  GlDrawElements = 6,
+  StateChanges = 7,
+  PathClones = 8,
+  PaintClones = 9,
+  BytesUploaded = 10,
+  BytesReadBack = 11,
+  FontCacheHits = 12,
+  FontCacheMisses = 13,
+  TextCacheHits = 14,
+  TextCacheMisses = 15,
+  ShaderCacheHits = 16,
+  ShaderCacheMisses = 17,
+  ImageCacheHits = 18,
+  ImageCacheMisses = 19,
+  HandlesAlive = 20,
+  Frames = 21,
+} Counter;
+
 typedef enum FillRule {
   NonZero = 0,
   EvenOdd = 1,
@@ -95,6 +120,34 @@ typedef enum TextDirection {
   RTL = 1,
 } TextDirection;
 
+/**
+ * Every counter, in [`Counter`] order so the platforms can read it as an array of u64.
+ */
+typedef struct CanvasStats {
+  uint64_t draw_rect;
+  uint64_t draw_path;
+  uint64_t draw_image;
+  uint64_t draw_text;
+  uint64_t draw_other;
+  uint64_t gl_draw_arrays;
+  uint64_t gl_draw_elements;
+  uint64_t state_changes;
+  uint64_t path_clones;
+  uint64_t paint_clones;
+  uint64_t bytes_uploaded;
+  uint64_t bytes_read_back;
+  uint64_t font_cache_hits;
+  uint64_t font_cache_misses;
+  uint64_t text_cache_hits;
+  uint64_t text_cache_misses;
+  uint64_t shader_cache_hits;
+  uint64_t shader_cache_misses;
+  uint64_t image_cache_hits;
+  uint64_t image_cache_misses;
+  uint64_t handles_alive;
+  uint64_t frames;
+} CanvasStats;
+
 typedef struct Context Context;
 
 typedef struct F32Array {
@@ -225,6 +278,12 @@ typedef uint32_t AndroidBitmapFormat;
 #define AndroidBitmapFormat_ANDROID_BITMAP_FORMAT_A_8 8
 #endif
 
+/**
+ * Floats per sprite in a `draw_image_batch` array: the source rect's x, y, width and height, the
+ * destination rect's, a rotation in radians about the destination's center and an alpha.
+ */
+#define IMAGE_BATCH_SPRITE_SIZE 10
+
 void destroy_f32_array(struct F32Array *array);
 
 void destroy_f64_array(struct F64Array *array);
@@ -343,6 +402,42 @@ void context_resize_surface(long long context,
 const char *context_data_url(long long context, const char *format, float quality);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+/**
+ * Returns a native image handle of the canvas contents, drawn and released by
+ * `context_draw_image_snapshot`.
+ */
+long long context_snapshot_image(long long context);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+/**
+ * Draws a snapshot taken with `context_snapshot_image` and releases it.
+ */
+void context_draw_image_snapshot(long long context,
+                                 long long snapshot,
+                                 float sx,
+                                 float sy,
+                                 float s_width,
+                                 float s_height,
+                                 float dx,
+                                 float dy,
+                                 float d_width,
+                                 float d_height);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void context_draw_image_self(long long context,
+                             float sx,
+                             float sy,
+                             float s_width,
+                             float s_height,
+                             float dx,
+                             float dy,
+                             float d_width,
+                             float d_height);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 struct U8Array *context_snapshot_canvas(long long context);
 #endif
@@ -712,6 +807,27 @@ void context_draw_image_asset(long long context,
                               float d_height);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+/**
+ * Draws `sprites_length / IMAGE_BATCH_SPRITE_SIZE` sprites of the image, see
+ * `Context::draw_image_batch` for the layout.
+ */
+void context_draw_image_batch(long long context,
+                              const uint8_t *image_data,
+                              uintptr_t image_len,
+                              float width,
+                              float height,
+                              const float *sprites,
+                              uintptr_t sprites_length);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void context_draw_image_batch_asset(long long context,
+                                    long long asset,
+                                    const float *sprites,
+                                    uintptr_t sprites_length);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 void context_ellipse(long long context,
                      float x,
@@ -736,6 +852,16 @@ void context_fill_rect(long long context, float x, float y, float width, float h
 void context_fill_text(long long context, const char *text, float x, float y, float width);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void context_draw_svg(long long context,
+                      const char *svg,
+                      float x,
+                      float y,
+                      float width,
+                      float height,
+                      uint32_t tint);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 long long context_get_image_data(long long context, float sx, float sy, float sw, float sh);
 #endif
@@ -768,6 +894,34 @@ void context_line_to(long long context, float x, float y);
 long long context_measure_text(long long context, const char *text);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+/**
+ * Measures the strings packed in `text`, a UTF-8 buffer where string `i` starts at `offsets[i]`
+ * and ends at the next offset (or `text_len` for the last one).
+ */
+struct F32Array *context_measure_text_batch(long long context,
+                                            const uint8_t *text,
+                                            uintptr_t text_len,
+                                            const uintptr_t *offsets,
+                                            uintptr_t offsets_len);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void context_fill_paragraph(long long context,
+                            const char *text,
+                            float x,
+                            float y,
+                            float max_width,
+                            float line_height);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+struct F32Array *context_measure_paragraph(long long context,
+                                           const char *text,
+                                           float max_width,
+                                           float line_height);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 void context_move_to(long long context, float x, float y);
 #endif
@@ -855,6 +1009,22 @@ void context_transform(long long context, float a, float b, float c, float d, fl
 void context_translate(long long context, float x, float y);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool font_registry_register_path(const char *path, const char *alias);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool font_registry_register_bytes(const uint8_t *bytes, uintptr_t size, const char *alias);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool font_registry_unregister(const char *family);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void font_registry_clear(void);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 void gl_tex_image_2D_asset(unsigned int target,
                            int level,
@@ -1399,6 +1569,78 @@ void svg_draw_from_string(long long context, const int8_t *svg);
 void svg_draw_from_path(long long context, const int8_t *path);
 #endif
 
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void svg_set_cache_budget(long long bytes);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool profiler_set_enabled(bool enabled);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void profiler_record(const char *name, unsigned long long duration_ns);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void profiler_clear(void);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+const char *profiler_dump(void);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void stats_get(struct CanvasStats *stats, bool last_frame);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void stats_add(uint32_t counter, unsigned long long value);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void stats_end_frame(void);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void stats_reset(void);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void svg_draw_document(long long context, long long document);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+long long svg_document_create(const char *svg);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+void svg_document_destroy(long long document);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+int svg_document_element_by_id(long long document, const char *id);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool svg_document_set_attribute(long long document, int node, const char *name, const char *value);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool svg_document_set_text(long long document, int node, const char *text);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+int svg_document_append_child(long long document, int parent, const char *xml);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+bool svg_document_remove(long long document, int node);
+#endif
+
+#if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
+const char *svg_document_to_string(long long document);
+#endif
+
 #if (defined(TARGET_OS_IOS) || defined(TARGET_OS_MACOS))
 long long text_decoder_create(const char *decoding);
 #endif
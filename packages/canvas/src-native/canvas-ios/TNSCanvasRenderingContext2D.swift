@@ -297,6 +297,17 @@
             canvas.doDraw()
         }
         
+        public func drawSVG(_ svg: String,_ x: Float,_ y: Float,_ width: Float,_ height: Float) {
+            drawSVG(svg, x, y, width, height, 0)
+        }
+        
+        /// Draws svg from the shared svg atlas, tint is ARGB and 0 for none.
+        public func drawSVG(_ svg: String,_ x: Float,_ y: Float,_ width: Float,_ height: Float,_ tint: UInt32) {
+            ensureIsContextIsCurrent()
+            context_draw_svg(canvas.context, svg, x, y, width, height, tint)
+            canvas.doDraw()
+        }
+        
         public func strokeText(_ text: String,_ x: Float,_ y:Float) {
             strokeText(text, x, y, 0)
         }
@@ -624,7 +635,30 @@
         
     
         
+        // Draws a 2D canvas from its native surface, returns false when the source is not a 2D canvas
+        @nonobjc func drawCanvas(_ canvas: TNSCanvas, _ sx: Float, _ sy: Float, _ sWidth: Float, _ sHeight: Float, _ dx: Float, _ dy: Float, _ dWidth: Float, _ dHeight: Float) -> Bool {
+            if canvas === self.canvas {
+                ensureIsContextIsCurrent()
+                context_draw_image_self(self.canvas.context, sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight)
+                self.canvas.doDraw()
+                return true
+            }
+            let snapshot = canvas.snapshotImage()
+            if snapshot == 0 {
+                return false
+            }
+            ensureIsContextIsCurrent()
+            context_draw_image_snapshot(self.canvas.context, snapshot, sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight)
+            self.canvas.doDraw()
+            return true
+        }
+        
         @nonobjc func drawImage(canvas : TNSCanvas, dx: Float,dy: Float){
+                   let width = Float32(canvas.renderer.drawingBufferWidth)
+                   let height = Float32(canvas.renderer.drawingBufferHeight)
+                   if drawCanvas(canvas, 0, 0, width, height, dx, dy, width, height) {
+                       return
+                   }
                    var ss = canvas.snapshot()
                    ensureIsContextIsCurrent()
             context_draw_image_dx_dy(self.canvas.context, &ss, UInt(ss.count), Float32(canvas.renderer.drawingBufferWidth), Float32(canvas.renderer.drawingBufferHeight),dx, dy)
@@ -659,6 +693,11 @@
         
         
         @nonobjc func drawImage(canvas: TNSCanvas, dx: Float, dy: Float, dWidth: Float, dHeight: Float){
+            let width = Float32(canvas.renderer.drawingBufferWidth)
+            let height = Float32(canvas.renderer.drawingBufferHeight)
+            if drawCanvas(canvas, 0, 0, width, height, dx, dy, dWidth, dHeight) {
+                return
+            }
             ensureIsContextIsCurrent()
             var ss = canvas.snapshot()
             self.canvas.renderer.ensureIsContextIsCurrent()
@@ -690,6 +729,38 @@
             }
         }
         
+        public func drawImageBatch(_ image: Any,_ sprites: [Float32]) {
+            drawImageBatch(image, sprites, sprites.count / Int(IMAGE_BATCH_SPRITE_SIZE))
+        }
+        
+        /// Draws count sprites of image in as few draws as possible, IMAGE_BATCH_SPRITE_SIZE floats each: the source rect's x, y,
+        /// width and height, the destination rect's, a rotation in radians about the destination's center and an alpha.
+        /// A negative destination width or height mirrors the sprite.
+        public func drawImageBatch(_ image: Any,_ sprites: [Float32],_ count: Int) {
+            if let image = image as? TNSImageAsset {
+                drawImageBatch(asset: image.asset, sprites, count)
+            }else if let image = image as? TNSImageBitmap {
+                drawImageBatch(asset: image.asset, sprites, count)
+            }else if let image = image as? UIImage {
+                let asset = TNSImageAsset()
+                if asset.loadImageFromImage(image: image) {
+                    withExtendedLifetime(asset) {
+                        drawImageBatch(asset: asset.asset, sprites, count)
+                    }
+                }
+            }
+        }
+        
+        @nonobjc func drawImageBatch(asset: Int64,_ sprites: [Float32],_ count: Int) {
+            let length = min(count, sprites.count / Int(IMAGE_BATCH_SPRITE_SIZE)) * Int(IMAGE_BATCH_SPRITE_SIZE)
+            if length <= 0 {
+                return
+            }
+            ensureIsContextIsCurrent()
+            context_draw_image_batch_asset(canvas.context, asset, sprites, UInt(length))
+            canvas.doDraw()
+        }
+        
         @nonobjc func drawImage(image: TNSImageAsset, sx: Float, sy: Float, sWidth: Float, sHeight: Float, dx: Float, dy: Float, dWidth: Float, dHeight: Float){
             ensureIsContextIsCurrent()
             context_draw_image_asset(canvas.context, image.asset,sx, sy,sWidth, sHeight, dx, dy, dWidth, dHeight)
@@ -705,6 +776,9 @@
         
         
         @nonobjc func drawImage(canvas: TNSCanvas, sx: Float, sy: Float, sWidth: Float, sHeight: Float, dx: Float, dy: Float, dWidth: Float, dHeight: Float){
+            if drawCanvas(canvas, sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight) {
+                return
+            }
             var ss = canvas.snapshot()
            ensureIsContextIsCurrent()
             context_draw_image(self.canvas.context, &ss, UInt(ss.count), Float32(canvas.renderer.width),Float32(canvas.renderer.height), sx, sy, sWidth, sHeight, dx, dy, dWidth, dHeight)
@@ -770,6 +844,58 @@
         public func measureText(_ text: String) -> TNSTextMetrics {
             return TNSTextMetrics(metrics: context_measure_text(canvas.context, text))
         }
+        
+        // 12 floats per string in TNSTextMetrics property order, starting with width
+        public func measureTextBatch(_ texts: [String]) -> [Float32] {
+            var buffer = [UInt8]()
+            var offsets = [UInt]()
+            offsets.reserveCapacity(texts.count)
+            for text in texts {
+                offsets.append(UInt(buffer.count))
+                buffer.append(contentsOf: text.utf8)
+            }
+            let metrics = buffer.withUnsafeBufferPointer { text in
+                offsets.withUnsafeBufferPointer { offsets in
+                    context_measure_text_batch(canvas.context, text.baseAddress, UInt(text.count), offsets.baseAddress, UInt(offsets.count))
+                }
+            }
+            if metrics != nil {
+                let ptr = metrics!.pointee
+                let result = Array(UnsafeBufferPointer(start: ptr.data, count: Int(ptr.data_len)))
+                destroy_f32_array(metrics)
+                return result
+            }
+            return []
+        }
+        
+        public func fillParagraph(_ text: String,_ x: Float,_ y: Float,_ maxWidth: Float) {
+            fillParagraph(text, x, y, maxWidth, 0)
+        }
+        
+        public func fillParagraph(_ text: String,_ x: Float,_ y: Float,_ maxWidth: Float,_ lineHeight: Float) {
+            ensureIsContextIsCurrent()
+            context_fill_paragraph(canvas.context, text, x, y, maxWidth, lineHeight)
+            canvas.doDraw()
+        }
+        
+        public func measureParagraph(_ text: String,_ maxWidth: Float) -> [Float32] {
+            return measureParagraph(text, maxWidth, 0)
+        }
+        
+        // width, height, longestLine, minIntrinsicWidth, maxIntrinsicWidth, alphabeticBaseline,
+        // ideographicBaseline, lineCount followed by startIndex, endIndex, ascent, descent, height,
+        // width, left and baseline for each line
+        public func measureParagraph(_ text: String,_ maxWidth: Float,_ lineHeight: Float) -> [Float32] {
+            let metrics = context_measure_paragraph(canvas.context, text, maxWidth, lineHeight)
+            if metrics != nil {
+                let ptr = metrics!.pointee
+                let buffer = UnsafeBufferPointer(start: ptr.data, count: Int(ptr.data_len))
+                let result = Array(buffer)
+                destroy_f32_array(metrics)
+                return result
+            }
+            return []
+        }
         public func resetTransform(){
             context_reset_transform(canvas.context)
         }
@@ -1,15 +1,16 @@
-use std::str::FromStr;
 
 
 use jni::JNIEnv;
 use jni::objects::{JClass, JObject, JString, ReleaseMode};
 use jni::sys::{
-    jboolean, jbyteArray, jfloat, jfloatArray, jint, jlong, JNI_FALSE, JNI_TRUE, jobject, jstring,
+    jboolean, jbyteArray, jfloat, jfloatArray, jint, jlong, JNI_FALSE, JNI_TRUE, jobject,
+    jobjectArray, jstring,
 };
 use skia_safe::Rect;
 
 use crate::common::context::compositing::composite_operation_type::CompositeOperationType;
 use crate::common::context::Context;
+use crate::common::context::drawing_images::IMAGE_BATCH_SPRITE_SIZE;
 use crate::common::context::drawing_paths::fill_rule::FillRule;
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
 use crate::common::context::fill_and_stroke_styles::pattern::Repetition;
@@ -24,7 +25,7 @@ use crate::common::context::text_styles::text_align::TextAlign;
 use crate::common::context::text_styles::text_baseline::TextBaseLine;
 use crate::common::context::text_styles::text_direction::TextDirection;
 use crate::common::ffi::paint_style_value::{PaintStyleValueType};
-use crate::common::utils::color::to_parsed_color;
+use crate::common::utils::color::{parse_color, to_parsed_color};
 use crate::common::utils::image::{from_image_slice, from_image_slice_encoded};
 
 use ndk::{
@@ -522,13 +523,8 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_
         let context = &mut *context;
         if let Ok(color) = env.get_string(color) {
             let color = color.to_string_lossy();
-            if let Ok(color) = css_color_parser::Color::from_str(color.as_ref()) {
-                context.set_shadow_color(skia_safe::Color::from_argb(
-                    (color.a * 255.0) as u8,
-                    color.r,
-                    color.g,
-                    color.b,
-                ))
+            if let Some(color) = parse_color(color.as_ref()) {
+                context.set_shadow_color(color)
             }
         }
     }
@@ -1150,6 +1146,70 @@ fn draw_image_with_image(
     }
 }
 
+/// Draws a snapshot taken with `TNSCanvas.nativeSnapshotImage` and releases it.
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawImageWithSnapshot(
+    _: JNIEnv,
+    _: JClass,
+    context: jlong,
+    snapshot: jlong,
+    sx: jfloat,
+    sy: jfloat,
+    s_width: jfloat,
+    s_height: jfloat,
+    dx: jfloat,
+    dy: jfloat,
+    d_width: jfloat,
+    d_height: jfloat,
+) {
+    if snapshot == 0 {
+        return;
+    }
+    unsafe {
+        let snapshot: *mut skia_safe::Image = snapshot as _;
+        let snapshot = Box::from_raw(snapshot);
+        draw_image_with_image(
+            context,
+            Some(&snapshot),
+            sx,
+            sy,
+            s_width,
+            s_height,
+            dx,
+            dy,
+            d_width,
+            d_height,
+        );
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawImageWithSelf(
+    _: JNIEnv,
+    _: JClass,
+    context: jlong,
+    sx: jfloat,
+    sy: jfloat,
+    s_width: jfloat,
+    s_height: jfloat,
+    dx: jfloat,
+    dy: jfloat,
+    d_width: jfloat,
+    d_height: jfloat,
+) {
+    unsafe {
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        context.draw_snapshot(
+            Rect::from_xywh(sx, sy, s_width, s_height),
+            Rect::from_xywh(dx, dy, d_width, d_height),
+        );
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawImageDxDyWithBitmap(
     env: JNIEnv,
@@ -1487,6 +1547,73 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_
     }
 }
 
+fn draw_image_batch(context: jlong, image: &skia_safe::image::Image, sprites: &[f32], count: jint) {
+    unsafe {
+        if context == 0 || count <= 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let length = sprites.len().min(count as usize * IMAGE_BATCH_SPRITE_SIZE);
+        context.draw_image_batch(image, &sprites[..length])
+    }
+}
+
+/// Draws `count` sprites of the asset, packed as `IMAGE_BATCH_SPRITE_SIZE` floats each.
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawImageBatchWithAsset(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    asset: jlong,
+    sprites: jfloatArray,
+    count: jint,
+) {
+    if asset == 0 {
+        return;
+    }
+    unsafe {
+        let asset: *mut ImageAsset = asset as _;
+        let asset = &mut *asset;
+        let image = match asset.skia_image() {
+            Some(image) => Some(image),
+            None => asset.get_bytes().and_then(|bytes| {
+                from_image_slice(bytes, asset.width() as i32, asset.height() as i32)
+            }),
+        };
+        if let Some(image) = image {
+            if let Ok(val) = env.get_float_array_elements(sprites, ReleaseMode::NoCopyBack) {
+                let length = val.size().unwrap_or(0).max(0) as usize;
+                let buf = std::slice::from_raw_parts(val.as_ptr() as *const f32, length);
+                draw_image_batch(context, &image, buf, count);
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawImageBatchWithBitmap(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    bitmap: JObject,
+    width: jfloat,
+    height: jfloat,
+    sprites: jfloatArray,
+    count: jint,
+) {
+    let length = env.get_array_length(sprites).unwrap_or(0).max(0) as usize;
+    let mut buf = vec![0f32; length];
+    if env.get_float_array_region(sprites, 0, &mut buf).is_err() {
+        return;
+    }
+    if let Some((bytes, _)) = crate::android::utils::image::get_bytes_from_bitmap(env, bitmap) {
+        if let Some(image) = from_image_slice(bytes.as_slice(), width as i32, height as i32) {
+            draw_image_batch(context, &image, buf.as_slice(), count);
+        }
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeEllipse(
     _: JNIEnv,
@@ -1587,6 +1714,39 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_
     }
 }
 
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeDrawSVG(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    svg: JString,
+    x: jfloat,
+    y: jfloat,
+    width: jfloat,
+    height: jfloat,
+    tint: jint,
+) {
+    unsafe {
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        if let Ok(svg) = env.get_string(svg) {
+            let svg = svg.to_string_lossy();
+            crate::common::svg::atlas::draw_svg_sprite(
+                context,
+                svg.as_ref(),
+                x,
+                y,
+                width,
+                height,
+                tint as u32,
+            )
+        }
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeGetImageData(
     _: JNIEnv,
@@ -1726,6 +1886,92 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_
     }
 }
 
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeMeasureTextBatch(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    texts: jobjectArray,
+) -> jfloatArray {
+    unsafe {
+        if context == 0 || texts.is_null() {
+            return env.new_float_array(0).unwrap();
+        }
+        let context: *const Context = context as _;
+        let context = &*context;
+        let count = env.get_array_length(texts).unwrap_or(0);
+        let mut strings = Vec::with_capacity(count as usize);
+        for i in 0..count {
+            let text = env
+                .get_object_array_element(texts, i)
+                .unwrap_or(JObject::null());
+            if text.is_null() {
+                strings.push(String::new());
+                continue;
+            }
+            match env.get_string(JString::from(text)) {
+                Ok(text) => strings.push(text.to_string_lossy().to_string()),
+                Err(_) => strings.push(String::new()),
+            }
+            let _ = env.delete_local_ref(text);
+        }
+        let metrics = context.measure_text_batch(strings.iter().map(|text| text.as_str()));
+        let array = env.new_float_array(metrics.len() as i32).unwrap();
+        env.set_float_array_region(array, 0, metrics.as_slice())
+            .unwrap_or(());
+        array
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeFillParagraph(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    text: JString,
+    x: jfloat,
+    y: jfloat,
+    max_width: jfloat,
+    line_height: jfloat,
+) {
+    unsafe {
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        if let Ok(txt) = env.get_string(text) {
+            let txt = txt.to_string_lossy();
+            context.fill_paragraph(txt.as_ref(), x, y, max_width, line_height)
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeMeasureParagraph(
+    env: JNIEnv,
+    _: JClass,
+    context: jlong,
+    text: JString,
+    max_width: jfloat,
+    line_height: jfloat,
+) -> jfloatArray {
+    unsafe {
+        if context == 0 {
+            return env.new_float_array(0).unwrap();
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let text = env.get_string(text).unwrap();
+        let text = text.to_string_lossy();
+        let metrics = context.measure_paragraph(text.as_ref(), max_width, line_height);
+        let array = env.new_float_array(metrics.len() as i32).unwrap();
+        env.set_float_array_region(array, 0, metrics.as_slice())
+            .unwrap_or(());
+        array
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasRenderingContext2D_nativeMoveTo(
     _: JNIEnv,
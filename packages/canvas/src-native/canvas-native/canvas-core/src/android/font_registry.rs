@@ -0,0 +1,71 @@
+use jni::JNIEnv;
+use jni::objects::{JClass, JString};
+use jni::sys::{jboolean, jbyteArray, JNI_FALSE, JNI_TRUE};
+
+use crate::common::context::drawing_text::font_registry::FontRegistry;
+
+fn get_alias(env: &JNIEnv, alias: JString) -> Option<String> {
+    if alias.is_null() {
+        return None;
+    }
+    env.get_string(alias)
+        .ok()
+        .map(|alias| alias.to_string_lossy().to_string())
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSFontRegistry_nativeRegisterFontFromPath(
+    env: JNIEnv,
+    _: JClass,
+    path: JString,
+    alias: JString,
+) -> jboolean {
+    if let Ok(path) = env.get_string(path) {
+        let alias = get_alias(&env, alias);
+        if FontRegistry::shared()
+            .register_path(path.to_string_lossy().as_ref(), alias.as_deref())
+            .is_some()
+        {
+            return JNI_TRUE;
+        }
+    }
+    JNI_FALSE
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSFontRegistry_nativeRegisterFontFromBytes(
+    env: JNIEnv,
+    _: JClass,
+    bytes: jbyteArray,
+    alias: JString,
+) -> jboolean {
+    if let Ok(bytes) = env.convert_byte_array(bytes) {
+        let alias = get_alias(&env, alias);
+        if FontRegistry::shared()
+            .register_bytes(bytes.as_slice(), alias.as_deref())
+            .is_some()
+        {
+            return JNI_TRUE;
+        }
+    }
+    JNI_FALSE
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSFontRegistry_nativeUnregisterFont(
+    env: JNIEnv,
+    _: JClass,
+    family: JString,
+) -> jboolean {
+    if let Ok(family) = env.get_string(family) {
+        if FontRegistry::shared().unregister(family.to_string_lossy().as_ref()) {
+            return JNI_TRUE;
+        }
+    }
+    JNI_FALSE
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSFontRegistry_nativeClear(_: JNIEnv, _: JClass) {
+    FontRegistry::shared().clear();
+}
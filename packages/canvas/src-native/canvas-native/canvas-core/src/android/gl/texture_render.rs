@@ -2,7 +2,27 @@ use std::os::raw::c_void;
 
 use jni::JNIEnv;
 use jni::objects::{JClass, JObject, ReleaseMode};
-use jni::sys::{jfloatArray, jint};
+use jni::sys::{jfloatArray, jint, jintArray};
+
+// Layout of the state TextureRender passes from GLStateCache, negative entries are unknown.
+const TRACKED_STATE_VIEWPORT: usize = 0;
+const TRACKED_STATE_ACTIVE_TEXTURE: usize = 4;
+const TRACKED_STATE_TEXTURE_2D: usize = 5;
+const TRACKED_STATE_PROGRAM: usize = 6;
+const TRACKED_STATE_FRAMEBUFFER: usize = 7;
+const TRACKED_STATE_RENDERBUFFER: usize = 8;
+const TRACKED_STATE_ARRAY_BUFFER: usize = 9;
+const TRACKED_STATE_SIZE: usize = 10;
+
+/// Returns the tracked binding, only asking GL when it is unknown.
+unsafe fn tracked_or_query(tracked: i32, pname: u32) -> i32 {
+    if tracked >= 0 {
+        return tracked;
+    }
+    let mut value = [0_i32; 1];
+    gl_bindings::glGetIntegerv(pname, value.as_mut_ptr());
+    value[0]
+}
 
 #[no_mangle]
 pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeDrawFrame(
@@ -10,6 +30,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
     _: JClass,
     surface_texture_object: JObject,
     flip_y_web_gl: bool,
+    tracked_state: jintArray,
     fbo: jint,
     rbo: jint,
     program: jint,
@@ -27,40 +48,40 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
     format: jint,
     draw_count: jint,
 ) {
+    let mut tracked = [-1_i32; TRACKED_STATE_SIZE];
+    let _ = env.get_int_array_region(tracked_state, 0, &mut tracked);
+
+    // the WebGL context shadows most of what we touch, glGet stalls so only query the rest
     let mut previous_view_port = [0_i32; 4];
-    let mut previous_active_texture = [-1_i32; 1];
-    let mut previous_texture = [-1_i32; 1];
-    let mut previous_program = [-1_i32; 1];
-    let mut previous_frame_buffer = [-1_i32; 1];
-    let mut previous_render_buffer = [-1_i32; 1];
-    let mut previous_vertex_array = [-1_i32; 1];
-
-    gl_bindings::glGetIntegerv(gl_bindings::GL_VIEWPORT, previous_view_port.as_mut_ptr());
-    gl_bindings::glGetIntegerv(
+    if tracked[TRACKED_STATE_VIEWPORT + 2] >= 0 {
+        previous_view_port
+            .copy_from_slice(&tracked[TRACKED_STATE_VIEWPORT..TRACKED_STATE_VIEWPORT + 4]);
+    } else {
+        gl_bindings::glGetIntegerv(gl_bindings::GL_VIEWPORT, previous_view_port.as_mut_ptr());
+    }
+    let previous_active_texture = tracked_or_query(
+        tracked[TRACKED_STATE_ACTIVE_TEXTURE],
         gl_bindings::GL_ACTIVE_TEXTURE,
-        previous_active_texture.as_mut_ptr(),
     );
-    gl_bindings::glGetIntegerv(
+    let previous_texture = tracked_or_query(
+        tracked[TRACKED_STATE_TEXTURE_2D],
         gl_bindings::GL_TEXTURE_BINDING_2D,
-        previous_texture.as_mut_ptr(),
     );
-    gl_bindings::glGetIntegerv(
+    let previous_program = tracked_or_query(
+        tracked[TRACKED_STATE_PROGRAM],
         gl_bindings::GL_CURRENT_PROGRAM,
-        previous_program.as_mut_ptr(),
     );
-    gl_bindings::glGetIntegerv(
+    let previous_frame_buffer = tracked_or_query(
+        tracked[TRACKED_STATE_FRAMEBUFFER],
         gl_bindings::GL_FRAMEBUFFER_BINDING,
-        previous_frame_buffer.as_mut_ptr(),
     );
-
-    gl_bindings::glGetIntegerv(
+    let previous_render_buffer = tracked_or_query(
+        tracked[TRACKED_STATE_RENDERBUFFER],
         gl_bindings::GL_RENDERBUFFER_BINDING,
-        previous_render_buffer.as_mut_ptr(),
     );
-
-    gl_bindings::glGetIntegerv(
-        gl_bindings::GL_VERTEX_ARRAY_BINDING,
-        previous_vertex_array.as_mut_ptr(),
+    let previous_array_buffer = tracked_or_query(
+        tracked[TRACKED_STATE_ARRAY_BUFFER],
+        gl_bindings::GL_ARRAY_BUFFER_BINDING,
     );
 
     gl_bindings::glBindFramebuffer(gl_bindings::GL_FRAMEBUFFER, fbo as u32);
@@ -79,7 +100,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
             gl_bindings::GL_RENDERBUFFER,
             rbo as u32,
         );
-        gl_bindings::glBindTexture(gl_bindings::GL_TEXTURE_2D, previous_texture[0] as u32);
+        gl_bindings::glBindTexture(gl_bindings::GL_TEXTURE_2D, previous_texture as u32);
 
         gl_bindings::glTexImage2D(
             gl_bindings::GL_TEXTURE_2D,
@@ -125,7 +146,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
             gl_bindings::GL_FRAMEBUFFER,
             gl_bindings::GL_COLOR_ATTACHMENT0,
             gl_bindings::GL_TEXTURE_2D,
-            previous_texture[0] as u32,
+            previous_texture as u32,
             0,
         );
 
@@ -186,7 +207,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
 
         gl_bindings::glUniform1i(
             sampler_pos,
-            previous_active_texture[0] - gl_bindings::GL_TEXTURE0 as i32,
+            previous_active_texture - gl_bindings::GL_TEXTURE0 as i32,
         );
 
         gl_bindings::glUniformMatrix4fv(matrix_pos, 1, 0, mtx.as_ptr() as _);
@@ -230,15 +251,15 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
                 external_texture as u32,
             );
 
-            //      previous_active_texture[0] - gl_bindings::GL_TEXTURE0
+            //      previous_active_texture - gl_bindings::GL_TEXTURE0
             // gl_bindings::glUniform1i(
             //     sampler_pos,
-            //     0, // previous_active_texture[0] - gl_bindings::GL_TEXTURE0 as i32,
+            //     0, // previous_active_texture - gl_bindings::GL_TEXTURE0 as i32,
             // );
 
             gl_bindings::glUniform1i(
                 sampler_pos,
-                previous_active_texture[0] - gl_bindings::GL_TEXTURE0 as i32,
+                previous_active_texture - gl_bindings::GL_TEXTURE0 as i32,
             );
 
             /*  let name = std::ffi::CString::new("aTexCoord").unwrap();
@@ -265,16 +286,16 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
 
             //gl_bindings::glBindTexture(gl_bindings::GL_TEXTURE_EXTERNAL_OES, 0);
 
-            //  gl_bindings::glBindRenderbuffer(gl_bindings::GL_RENDERBUFFER, previous_render_buffer[0] as u32);
+            //  gl_bindings::glBindRenderbuffer(gl_bindings::GL_RENDERBUFFER, previous_render_buffer as u32);
         }
     }
 
 
     gl_bindings::glBindRenderbuffer(
         gl_bindings::GL_RENDERBUFFER,
-        previous_render_buffer[0] as u32,
+        previous_render_buffer as u32,
     );
-    gl_bindings::glBindFramebuffer(gl_bindings::GL_FRAMEBUFFER, previous_frame_buffer[0] as u32);
+    gl_bindings::glBindFramebuffer(gl_bindings::GL_FRAMEBUFFER, previous_frame_buffer as u32);
 
     gl_bindings::glViewport(
         previous_view_port[0],
@@ -283,11 +304,11 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TextureRender_nativeD
         previous_view_port[3],
     );
 
-    gl_bindings::glBindTexture(gl_bindings::GL_TEXTURE_2D, previous_texture[0] as u32);
+    gl_bindings::glBindTexture(gl_bindings::GL_TEXTURE_2D, previous_texture as u32);
 
-    gl_bindings::glUseProgram(previous_program[0] as u32);
+    gl_bindings::glUseProgram(previous_program as u32);
 
-    gl_bindings::glBindVertexArray(previous_vertex_array[0] as u32);
+    gl_bindings::glBindBuffer(gl_bindings::GL_ARRAY_BUFFER, previous_array_buffer as u32);
 }
 
 #[inline(always)]
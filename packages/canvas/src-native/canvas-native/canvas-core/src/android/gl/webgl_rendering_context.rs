@@ -2,17 +2,21 @@
 #![allow(non_camel_case_types)]
 #![allow(non_snake_case)]
 
+use std::cell::RefCell;
+use std::collections::HashMap;
 use std::os::raw::c_void;
 
 
 use jni::JNIEnv;
 use jni::objects::{JByteBuffer, JClass, JObject, ReleaseMode};
 use jni::sys::{
-    jboolean, jbyteArray, jfloatArray, jint, jintArray, jlong, JNI_TRUE, jshortArray,
+    jarray, jboolean, jbyteArray, jfloatArray, jint, jintArray, jlong, JNI_TRUE, jshortArray,
 };
 
 
 use crate::common::context::image_asset::ImageAsset;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 const RGB: u32 = 0x1907;
 const RGBA: u32 = 0x1908;
@@ -94,6 +98,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     format: jint,
     pixel_type: jint,
 ) {
+    profile_scope!("gl.read_pixels");
     gl_bindings::glReadPixels(
         x,
         y,
@@ -117,6 +122,7 @@ fn texImage2D(
     flipY: bool,
     buf: &mut [u8],
 ) {
+    stats::add(Counter::BytesUploaded, buf.len() as u64);
     unsafe {
         if flipY {
             crate::common::utils::gl::flip_in_place(
@@ -352,10 +358,12 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     asset: jlong,
     flipY: jboolean,
 ) {
+    profile_scope!("gl.tex_image_2d");
     let asset: *mut ImageAsset = asset as _;
     let asset = &mut *asset;
 
     if let Some(bytes) = asset.get_bytes() {
+        stats::add(Counter::BytesUploaded, bytes.len() as u64);
 
         // force RGBA for assets
         let internalformat = RGBA as i32;
@@ -413,7 +421,9 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     bitmap: JObject,
     flipY: jboolean,
 ) {
+    profile_scope!("gl.tex_image_2d");
     if let Some((mut data, info)) = super::super::utils::image::get_bytes_from_bitmap(env, bitmap) {
+        stats::add(Counter::BytesUploaded, data.len() as u64);
 
         let mut channels = 4;
 
@@ -469,6 +479,7 @@ fn texSubImage2D(
     flip_y: bool,
     buf: &mut [u8],
 ) {
+    stats::add(Counter::BytesUploaded, buf.len() as u64);
     if flip_y {
         crate::common::utils::gl::flip_in_place(
             buf.as_mut_ptr(),
@@ -712,6 +723,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     asset: jlong,
     flip_y: jboolean,
 ) {
+    profile_scope!("gl.tex_sub_image_2d");
     let asset: *mut ImageAsset = asset as _;
     let asset = &mut *asset;
 
@@ -721,6 +733,7 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     };
 
     if let Some(bytes) = asset.get_bytes() {
+        stats::add(Counter::BytesUploaded, bytes.len() as u64);
         if flip_y == JNI_TRUE {
             let mut bytes = bytes.to_vec();
             crate::common::utils::gl::flip_in_place(
@@ -773,7 +786,9 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
     bitmap: JObject,
     flip_y: jboolean,
 ) {
+    profile_scope!("gl.tex_sub_image_2d");
     if let Some((mut data, info)) = super::super::utils::image::get_bytes_from_bitmap(env, bitmap) {
+        stats::add(Counter::BytesUploaded, data.len() as u64);
 
         let mut channels = 4;
 
@@ -832,3 +847,401 @@ pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingCont
         offset as *const c_void,
     )
 }
+
+const VERTEX_ARRAY_HEADER_SIZE: usize = 2;
+const VERTEX_ARRAY_ENTRY_SIZE: usize = 10;
+const VERTEX_ARRAY_ENABLED_CHANGED: jint = 1;
+const VERTEX_ARRAY_POINTER_CHANGED: jint = 2;
+const VERTEX_ARRAY_DIVISOR_CHANGED: jint = 4;
+
+/// Replays the attribute changes packed by VertexArrayCache when an emulated vertex array is
+/// bound. The header is the array buffer binding to restore after the pointers, -1 to query it,
+/// and the element array buffer to bind, -1 to leave it. Each entry is index, flags, enabled,
+/// buffer, size, type, normalized, stride, offset and divisor.
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeApplyVertexArray(
+    env: JNIEnv,
+    _: JClass,
+    state: jintArray,
+) {
+    let len = env.get_array_length(state).unwrap_or(0).max(0) as usize;
+    if len < VERTEX_ARRAY_HEADER_SIZE {
+        return;
+    }
+    let mut values = vec![0 as jint; len];
+    if env.get_int_array_region(state, 0, &mut values).is_err() {
+        return;
+    }
+
+    let element_array_buffer = values[1];
+    if element_array_buffer >= 0 {
+        gl_bindings::glBindBuffer(
+            gl_bindings::GL_ELEMENT_ARRAY_BUFFER,
+            element_array_buffer as u32,
+        );
+    }
+
+    let entries = values[VERTEX_ARRAY_HEADER_SIZE..].chunks_exact(VERTEX_ARRAY_ENTRY_SIZE);
+    let mut array_buffer = None;
+    for entry in entries {
+        let index = entry[0] as u32;
+        let flags = entry[1];
+        if flags & VERTEX_ARRAY_POINTER_CHANGED != 0 {
+            if array_buffer.is_none() {
+                let mut previous = values[0];
+                if previous < 0 {
+                    gl_bindings::glGetIntegerv(gl_bindings::GL_ARRAY_BUFFER_BINDING, &mut previous);
+                }
+                array_buffer = Some(previous);
+            }
+            gl_bindings::glBindBuffer(gl_bindings::GL_ARRAY_BUFFER, entry[3] as u32);
+            gl_bindings::glVertexAttribPointer(
+                index,
+                entry[4],
+                entry[5] as u32,
+                entry[6] as jboolean,
+                entry[7],
+                entry[8] as isize as *const c_void,
+            );
+        }
+        if flags & VERTEX_ARRAY_ENABLED_CHANGED != 0 {
+            if entry[2] != 0 {
+                gl_bindings::glEnableVertexAttribArray(index);
+            } else {
+                gl_bindings::glDisableVertexAttribArray(index);
+            }
+        }
+        if flags & VERTEX_ARRAY_DIVISOR_CHANGED != 0 {
+            gl_bindings::glVertexAttribDivisor(index, entry[9] as u32);
+        }
+    }
+    if let Some(array_buffer) = array_buffer {
+        gl_bindings::glBindBuffer(gl_bindings::GL_ARRAY_BUFFER, array_buffer as u32);
+    }
+}
+
+// Typed uploads. Arrays are pinned with get_primitive_array_critical and direct buffers are read
+// in place, so bufferData, bufferSubData and uniform*v never wrap or copy on the Java side.
+// Offsets and lengths are in elements of element_size bytes.
+
+fn element_range(offset: jint, length: jint, element_size: jint, capacity: usize) -> Option<(usize, usize)> {
+    if offset < 0 || length < 0 || element_size <= 0 {
+        return None;
+    }
+    let (offset, length) = (offset as usize, length as usize);
+    if offset + length > capacity {
+        return None;
+    }
+    let element_size = element_size as usize;
+    Some((offset * element_size, length * element_size))
+}
+
+unsafe fn with_array_bytes<F: FnOnce(*const c_void, usize)>(
+    env: &JNIEnv,
+    array: jarray,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+    f: F,
+) {
+    if array.is_null() {
+        return;
+    }
+    // no JNI calls are allowed while the array is pinned, so size it first
+    let capacity = env.get_array_length(array).unwrap_or(0) as usize;
+    let (start, len) = match element_range(offset, length, element_size, capacity) {
+        Some(range) => range,
+        None => return,
+    };
+    match env.get_primitive_array_critical(array, ReleaseMode::NoCopyBack) {
+        Ok(elements) => {
+            f((elements.as_ptr() as *const u8).add(start) as *const c_void, len);
+        }
+        Err(e) => {
+            log::debug!("get_primitive_array_critical error {:?}", e);
+        }
+    }
+}
+
+unsafe fn with_buffer_bytes<F: FnOnce(*const c_void, usize)>(
+    env: &JNIEnv,
+    buffer: JByteBuffer,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+    f: F,
+) {
+    match (env.get_direct_buffer_address(buffer), env.get_direct_buffer_capacity(buffer)) {
+        (Ok(address), Ok(capacity)) => {
+            if let Some((start, len)) = element_range(offset, length, element_size, capacity) {
+                f(address.add(start) as *const c_void, len);
+            }
+        }
+        (Err(e), _) | (_, Err(e)) => {
+            log::debug!("get_direct_buffer_address error {:?}", e);
+        }
+    }
+}
+
+/// 32 bit values per element of a uniform of GL `uniform_type`.
+fn uniform_components(uniform_type: u32) -> Option<usize> {
+    use gl_bindings::*;
+    match uniform_type {
+        GL_FLOAT | GL_INT | GL_UNSIGNED_INT | GL_BOOL | GL_SAMPLER_2D | GL_SAMPLER_CUBE
+        | GL_SAMPLER_3D | GL_SAMPLER_2D_SHADOW | GL_SAMPLER_2D_ARRAY | GL_SAMPLER_2D_ARRAY_SHADOW
+        | GL_SAMPLER_CUBE_SHADOW | GL_INT_SAMPLER_2D | GL_INT_SAMPLER_3D | GL_INT_SAMPLER_CUBE
+        | GL_INT_SAMPLER_2D_ARRAY | GL_UNSIGNED_INT_SAMPLER_2D | GL_UNSIGNED_INT_SAMPLER_3D
+        | GL_UNSIGNED_INT_SAMPLER_CUBE | GL_UNSIGNED_INT_SAMPLER_2D_ARRAY => Some(1),
+        GL_FLOAT_VEC2 | GL_INT_VEC2 | GL_UNSIGNED_INT_VEC2 | GL_BOOL_VEC2 => Some(2),
+        GL_FLOAT_VEC3 | GL_INT_VEC3 | GL_UNSIGNED_INT_VEC3 | GL_BOOL_VEC3 => Some(3),
+        GL_FLOAT_VEC4 | GL_INT_VEC4 | GL_UNSIGNED_INT_VEC4 | GL_BOOL_VEC4 | GL_FLOAT_MAT2 => Some(4),
+        GL_FLOAT_MAT2x3 | GL_FLOAT_MAT3x2 => Some(6),
+        GL_FLOAT_MAT2x4 | GL_FLOAT_MAT4x2 => Some(8),
+        GL_FLOAT_MAT3 => Some(9),
+        GL_FLOAT_MAT3x4 | GL_FLOAT_MAT4x3 => Some(12),
+        GL_FLOAT_MAT4 => Some(16),
+        _ => None,
+    }
+}
+
+unsafe fn uniform(location: jint, uniform_type: jint, transpose: jboolean, data: *const c_void, len: usize) {
+    use gl_bindings::*;
+    let uniform_type = uniform_type as u32;
+    let count = match uniform_components(uniform_type) {
+        Some(components) => (len / (components * 4)) as GLsizei,
+        None => return,
+    };
+    if count == 0 {
+        return;
+    }
+    let floats = data as *const GLfloat;
+    let ints = data as *const GLint;
+    let uints = data as *const GLuint;
+    match uniform_type {
+        GL_FLOAT => glUniform1fv(location, count, floats),
+        GL_FLOAT_VEC2 => glUniform2fv(location, count, floats),
+        GL_FLOAT_VEC3 => glUniform3fv(location, count, floats),
+        GL_FLOAT_VEC4 => glUniform4fv(location, count, floats),
+        GL_INT_VEC2 | GL_BOOL_VEC2 => glUniform2iv(location, count, ints),
+        GL_INT_VEC3 | GL_BOOL_VEC3 => glUniform3iv(location, count, ints),
+        GL_INT_VEC4 | GL_BOOL_VEC4 => glUniform4iv(location, count, ints),
+        GL_UNSIGNED_INT => glUniform1uiv(location, count, uints),
+        GL_UNSIGNED_INT_VEC2 => glUniform2uiv(location, count, uints),
+        GL_UNSIGNED_INT_VEC3 => glUniform3uiv(location, count, uints),
+        GL_UNSIGNED_INT_VEC4 => glUniform4uiv(location, count, uints),
+        GL_FLOAT_MAT2 => glUniformMatrix2fv(location, count, transpose, floats),
+        GL_FLOAT_MAT3 => glUniformMatrix3fv(location, count, transpose, floats),
+        GL_FLOAT_MAT4 => glUniformMatrix4fv(location, count, transpose, floats),
+        GL_FLOAT_MAT2x3 => glUniformMatrix2x3fv(location, count, transpose, floats),
+        GL_FLOAT_MAT2x4 => glUniformMatrix2x4fv(location, count, transpose, floats),
+        GL_FLOAT_MAT3x2 => glUniformMatrix3x2fv(location, count, transpose, floats),
+        GL_FLOAT_MAT3x4 => glUniformMatrix3x4fv(location, count, transpose, floats),
+        GL_FLOAT_MAT4x2 => glUniformMatrix4x2fv(location, count, transpose, floats),
+        GL_FLOAT_MAT4x3 => glUniformMatrix4x3fv(location, count, transpose, floats),
+        // int, bool and samplers
+        _ => glUniform1iv(location, count, ints),
+    }
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeBufferDataArray(
+    env: JNIEnv,
+    _: JClass,
+    target: jint,
+    data: jarray,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+    usage: jint,
+) {
+    with_array_bytes(&env, data, offset, length, element_size, |ptr, len| {
+        gl_bindings::glBufferData(target as u32, len as gl_bindings::GLsizeiptr, ptr, usage as u32);
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeBufferDataBuffer(
+    env: JNIEnv,
+    _: JClass,
+    target: jint,
+    data: JByteBuffer,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+    usage: jint,
+) {
+    with_buffer_bytes(&env, data, offset, length, element_size, |ptr, len| {
+        gl_bindings::glBufferData(target as u32, len as gl_bindings::GLsizeiptr, ptr, usage as u32);
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeBufferSubDataArray(
+    env: JNIEnv,
+    _: JClass,
+    target: jint,
+    dst_byte_offset: jint,
+    data: jarray,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+) {
+    with_array_bytes(&env, data, offset, length, element_size, |ptr, len| {
+        gl_bindings::glBufferSubData(
+            target as u32,
+            dst_byte_offset as gl_bindings::GLintptr,
+            len as gl_bindings::GLsizeiptr,
+            ptr,
+        );
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeBufferSubDataBuffer(
+    env: JNIEnv,
+    _: JClass,
+    target: jint,
+    dst_byte_offset: jint,
+    data: JByteBuffer,
+    offset: jint,
+    length: jint,
+    element_size: jint,
+) {
+    with_buffer_bytes(&env, data, offset, length, element_size, |ptr, len| {
+        gl_bindings::glBufferSubData(
+            target as u32,
+            dst_byte_offset as gl_bindings::GLintptr,
+            len as gl_bindings::GLsizeiptr,
+            ptr,
+        );
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeUniformArray(
+    env: JNIEnv,
+    _: JClass,
+    location: jint,
+    uniform_type: jint,
+    transpose: jboolean,
+    data: jarray,
+    offset: jint,
+    length: jint,
+) {
+    with_array_bytes(&env, data, offset, length, 4, |ptr, len| {
+        uniform(location, uniform_type, transpose, ptr, len);
+    });
+}
+
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeUniformBuffer(
+    env: JNIEnv,
+    _: JClass,
+    location: jint,
+    uniform_type: jint,
+    transpose: jboolean,
+    data: JByteBuffer,
+    offset: jint,
+    length: jint,
+) {
+    with_buffer_bytes(&env, data, offset, length, 4, |ptr, len| {
+        uniform(location, uniform_type, transpose, ptr, len);
+    });
+}
+
+thread_local! {
+    /// Values last applied by nativeUniformBatch, per program and location. Lives on the GL
+    /// thread, which owns the context the program ids belong to.
+    static BATCHED_UNIFORMS: RefCell<HashMap<u32, HashMap<jint, Vec<u8>>>> = RefCell::new(HashMap::new());
+}
+
+const UNIFORM_BATCH_HEADER_SIZE: usize = 16;
+
+fn read_int(bytes: &[u8], at: usize) -> jint {
+    jint::from_ne_bytes([bytes[at], bytes[at + 1], bytes[at + 2], bytes[at + 3]])
+}
+
+/// Applies the entries packed by WebGLUniformBatch to the current program, skipping values
+/// unchanged since the last batch for `program`. Returns the number of glUniform calls made.
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeUniformBatch(
+    env: JNIEnv,
+    _: JClass,
+    program: jint,
+    data: JByteBuffer,
+    offset: jint,
+    length: jint,
+) -> jint {
+    let mut applied = 0;
+    with_buffer_bytes(&env, data, offset, length, 1, |ptr, len| {
+        let bytes = std::slice::from_raw_parts(ptr as *const u8, len);
+        BATCHED_UNIFORMS.with(|cache| {
+            let mut cache = cache.borrow_mut();
+            let values = cache.entry(program as u32).or_default();
+            let mut cursor = 0;
+            while cursor + UNIFORM_BATCH_HEADER_SIZE <= len {
+                let location = read_int(bytes, cursor);
+                let uniform_type = read_int(bytes, cursor + 4);
+                let count = read_int(bytes, cursor + 8);
+                let flags = read_int(bytes, cursor + 12);
+                let components = match uniform_components(uniform_type as u32) {
+                    Some(components) if count >= 0 => components,
+                    _ => break,
+                };
+                let start = cursor + UNIFORM_BATCH_HEADER_SIZE;
+                let end = start + count as usize * components * 4;
+                if end > len {
+                    break;
+                }
+                cursor = end;
+
+                // -1 is what getUniformLocation gives for inactive uniforms
+                if location < 0 {
+                    continue;
+                }
+                let value = &bytes[start..end];
+                match values.get_mut(&location) {
+                    Some(previous) if previous.as_slice() == value => continue,
+                    Some(previous) => {
+                        previous.clear();
+                        previous.extend_from_slice(value);
+                    }
+                    None => {
+                        values.insert(location, value.to_vec());
+                    }
+                }
+                uniform(
+                    location,
+                    uniform_type,
+                    (flags & 1) as jboolean,
+                    value.as_ptr() as *const c_void,
+                    value.len(),
+                );
+                applied += 1;
+            }
+        });
+    });
+    applied
+}
+
+/// Drops the values remembered for `location` of `program`, or for all of `program` when
+/// `location` is -1, or for every program when `program` is -1. Used when uniforms are set
+/// outside a batch, the program is relinked or it is deleted.
+#[no_mangle]
+pub unsafe extern "system" fn Java_org_nativescript_canvas_TNSWebGLRenderingContext_nativeUniformBatchForget(
+    _env: JNIEnv,
+    _: JClass,
+    program: jint,
+    location: jint,
+) {
+    BATCHED_UNIFORMS.with(|cache| {
+        let mut cache = cache.borrow_mut();
+        if program < 0 {
+            cache.clear();
+        } else if location < 0 {
+            cache.remove(&(program as u32));
+        } else if let Some(values) = cache.get_mut(&(program as u32)) {
+            values.remove(&location);
+        }
+    });
+}
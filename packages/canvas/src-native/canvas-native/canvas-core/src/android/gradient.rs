@@ -5,6 +5,7 @@ use jni::JNIEnv;
 use jni::objects::{JClass, JString};
 
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
+use crate::common::utils::color::parse_color;
 
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasGradient_nativeAddColorStop(
@@ -24,16 +25,8 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvasGradient_nativeAddC
             PaintStyle::Gradient(gradient) => {
                 if let Ok(color) = env.get_string(color) {
                     let color = color.to_string_lossy();
-                    if let Ok(color) = color.as_ref().parse::<css_color_parser::Color>() {
-                        gradient.add_color_stop(
-                            stop,
-                            skia_safe::Color::from_argb(
-                                (color.a * 255.0) as u8,
-                                color.r,
-                                color.g,
-                                color.b,
-                            ),
-                        )
+                    if let Some(color) = parse_color(color.as_ref()) {
+                        gradient.add_color_stop(stop, color)
                     }
                 }
             }
@@ -12,7 +12,7 @@ use std::ffi::c_void;
 
 use jni::JavaVM;
 
-use crate::common::context::{Context, Device, State};
+use crate::common::context::{Context, Device};
 use crate::common::context::paths::path::Path;
 use crate::common::context::text_styles::text_direction::TextDirection;
 use crate::common::{image_to_data_url, to_data_url};
@@ -25,6 +25,7 @@ use jni::signature::{Primitive, ReturnType};
 
 
 pub mod context;
+pub mod font_registry;
 pub mod gl;
 pub mod gradient;
 pub mod image_asset;
@@ -34,6 +35,8 @@ pub mod matrix;
 pub mod paint;
 pub mod path;
 pub mod pattern;
+pub mod profiler;
+pub mod stats;
 pub mod svg;
 pub mod text_decoder;
 pub mod text_encoder;
@@ -426,15 +429,12 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeInitContext(
         Some(&surface_props),
     );
 
-    Box::into_raw(Box::new(Context {
-        surface: surface_holder.unwrap(),
-        path: Path::default(),
-        state: State::from_device(device, TextDirection::from(direction)),
-        state_stack: vec![],
-        font_color: Color::new(font_color as u32),
+    Box::into_raw(Box::new(Context::new(
+        surface_holder.unwrap(),
         device,
-        enable_scaling: false
-    })) as jlong
+        TextDirection::from(direction),
+        Color::new(font_color as u32),
+    ))) as jlong
 }
 
 pub(crate) fn init_with_custom_surface(
@@ -463,15 +463,12 @@ pub(crate) fn init_with_custom_surface(
         None,
     );
 
-    Box::into_raw(Box::new(Context {
-        surface: Surface::new_raster(&info, None, None).unwrap(),
-        path: Path::default(),
-        state: State::from_device(device, TextDirection::from(direction)),
-        state_stack: vec![],
-        font_color: Color::new(font_color as u32),
+    Box::into_raw(Box::new(Context::new(
+        Surface::new_raster(&info, None, None).unwrap(),
         device,
-        enable_scaling: false
-    })) as jlong
+        TextDirection::from(direction),
+        Color::new(font_color as u32),
+    ))) as jlong
 }
 
 #[no_mangle]
@@ -669,6 +666,42 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeDataURL(
     }
 }
 
+/// Returns a native image handle of the canvas contents, drawn and released by
+/// `TNSCanvasRenderingContext2D.nativeDrawImageWithSnapshot`.
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeSnapshotImage(
+    _: JNIEnv,
+    _: JClass,
+    context: jlong,
+) -> jlong {
+    if context == 0 {
+        return 0;
+    }
+    unsafe {
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        match context.snapshot_image() {
+            Some(image) => Box::into_raw(Box::new(image)) as jlong,
+            None => 0,
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeDestroySnapshotImage(
+    _: JNIEnv,
+    _: JClass,
+    image: jlong,
+) {
+    if image == 0 {
+        return;
+    }
+    unsafe {
+        let image: *mut skia_safe::Image = image as _;
+        let _ = Box::from_raw(image);
+    }
+}
+
 #[no_mangle]
 pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeSnapshotCanvas(
     env: JNIEnv,
@@ -818,19 +851,37 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSCanvas_nativeWriteCurrent
             bitmap,
             Box::new(move |cb| {
                 if let Some((image_data, info)) = cb {
-                    let mut buf = vec![0u8; (info.width() * info.height() * 4) as usize];
-                    gl_bindings::glFlush();
-                    gl_bindings::glReadPixels(
-                        0,
-                        0,
-                        info.width() as i32,
-                        info.height() as i32,
-                        gl_bindings::GL_RGBA as std::os::raw::c_uint,
-                        gl_bindings::GL_UNSIGNED_BYTE as std::os::raw::c_uint,
-                        buf.as_mut_ptr() as *mut c_void,
-                    );
-
-                    image_data.copy_from_slice(buf.as_slice());
+                    let row_bytes = (info.width() * 4) as usize;
+                    let height = info.height() as usize;
+                    let stride = info.stride() as usize;
+                    // glReadPixels already waits for the pending draws, no flush needed
+                    if stride == row_bytes {
+                        // read straight into the locked bitmap pixels
+                        gl_bindings::glReadPixels(
+                            0,
+                            0,
+                            info.width() as i32,
+                            info.height() as i32,
+                            gl_bindings::GL_RGBA as std::os::raw::c_uint,
+                            gl_bindings::GL_UNSIGNED_BYTE as std::os::raw::c_uint,
+                            image_data.as_mut_ptr() as *mut c_void,
+                        );
+                    } else {
+                        let mut buf = vec![0u8; row_bytes * height];
+                        gl_bindings::glReadPixels(
+                            0,
+                            0,
+                            info.width() as i32,
+                            info.height() as i32,
+                            gl_bindings::GL_RGBA as std::os::raw::c_uint,
+                            gl_bindings::GL_UNSIGNED_BYTE as std::os::raw::c_uint,
+                            buf.as_mut_ptr() as *mut c_void,
+                        );
+                        for (row, pixels) in buf.chunks_exact(row_bytes).enumerate() {
+                            let start = row * stride;
+                            image_data[start..start + row_bytes].copy_from_slice(pixels);
+                        }
+                    }
                 }
             })
         )
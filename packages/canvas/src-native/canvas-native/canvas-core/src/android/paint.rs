@@ -1,4 +1,3 @@
-use std::str::FromStr;
 
 
 use jni::JNIEnv;
@@ -8,7 +7,7 @@ use jni::sys::{jlong, jstring};
 
 use crate::common::context::Context;
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
-use crate::common::utils::color::to_parsed_color;
+use crate::common::utils::color::{parse_color, to_parsed_color};
 
 pub(crate) fn paint_style_set_color_with_string(
     env: JNIEnv,
@@ -24,13 +23,8 @@ pub(crate) fn paint_style_set_color_with_string(
         let context = &mut *context;
         if let Ok(color) = env.get_string(color) {
             let color = color.to_string_lossy();
-            if let Ok(color) = css_color_parser::Color::from_str(color.as_ref()) {
-                let style = PaintStyle::Color(skia_safe::Color::from_argb(
-                    (color.a * 255.0) as u8,
-                    color.r,
-                    color.g,
-                    color.b,
-                ));
+            if let Some(color) = parse_color(color.as_ref()) {
+                let style = PaintStyle::Color(color);
                 if is_fill {
                     context.set_fill_style(style);
                 } else {
@@ -0,0 +1,43 @@
+use jni::JNIEnv;
+use jni::objects::{JClass, JString};
+use jni::sys::{jboolean, jlong, jstring, JNI_FALSE, JNI_TRUE};
+
+use crate::common::profiler;
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSProfiler_nativeSetEnabled(
+    _: JNIEnv,
+    _: JClass,
+    enabled: jboolean,
+) -> jboolean {
+    if profiler::set_enabled(enabled == JNI_TRUE) {
+        JNI_TRUE
+    } else {
+        JNI_FALSE
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSProfiler_nativeRecord(
+    env: JNIEnv,
+    _: JClass,
+    name: JString,
+    duration: jlong,
+) {
+    if let Ok(name) = env.get_string(name) {
+        profiler::record(name.to_string_lossy().as_ref(), duration.max(0) as u64);
+    }
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSProfiler_nativeClear(_: JNIEnv, _: JClass) {
+    profiler::clear();
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSProfiler_nativeDump(
+    env: JNIEnv,
+    _: JClass,
+) -> jstring {
+    env.new_string(profiler::dump()).unwrap().into_raw()
+}
@@ -0,0 +1,47 @@
+use jni::JNIEnv;
+use jni::objects::JClass;
+use jni::sys::{jboolean, jlong, jlongArray, JNI_TRUE};
+
+use crate::common::stats::{self, Counter, COUNTER_COUNT};
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSStats_nativeGetStats(
+    env: JNIEnv,
+    _: JClass,
+    last_frame: jboolean,
+) -> jlongArray {
+    let values = stats::get_stats(last_frame == JNI_TRUE).to_array();
+    let values: Vec<jlong> = values.iter().map(|value| *value as jlong).collect();
+    let array = env.new_long_array(values.len() as i32).unwrap();
+    env.set_long_array_region(array, 0, values.as_slice())
+        .unwrap_or(());
+    array
+}
+
+/// Adds the counts gathered on the Java side since the last frame, indexed like [`Counter`], and
+/// ends the frame.
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSStats_nativeEndFrame(
+    env: JNIEnv,
+    _: JClass,
+    pending: jlongArray,
+) {
+    let mut values = [0 as jlong; COUNTER_COUNT];
+    let len = env.get_array_length(pending).unwrap_or(0).max(0) as usize;
+    let len = len.min(COUNTER_COUNT);
+    if len > 0 && env.get_long_array_region(pending, 0, &mut values[..len]).is_ok() {
+        for (index, value) in values[..len].iter().enumerate() {
+            if *value > 0 {
+                if let Some(counter) = Counter::from_u32(index as u32) {
+                    stats::add(counter, *value as u64);
+                }
+            }
+        }
+    }
+    stats::end_frame();
+}
+
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSStats_nativeReset(_: JNIEnv, _: JClass) {
+    stats::reset();
+}
@@ -1,8 +1,69 @@
 use jni::JNIEnv;
 use jni::objects::{JClass, JString};
-use jni::sys::jlong;
+use jni::sys::{jboolean, jint, jlong, JNI_FALSE, JNI_TRUE};
 
 use crate::common::context::Context;
+use crate::common::svg::cancel::{Cancellation, RenderToken};
+use crate::common::svg::document::SvgDocument;
+
+// renders of a view stop early once it asks for a newer one, 0 for renders without a token
+unsafe fn start_render<'a>(token: jlong) -> Cancellation<'a> {
+    if token == 0 {
+        return Cancellation::none();
+    }
+    let token: *const RenderToken = token as _;
+    (&*token).start()
+}
+
+fn to_jboolean(value: bool) -> jboolean {
+    if value {
+        JNI_TRUE
+    } else {
+        JNI_FALSE
+    }
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeCreateRenderToken(
+    _: JNIEnv,
+    _: JClass,
+) -> jlong {
+    Box::into_raw(Box::new(RenderToken::new())) as jlong
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeCancelRender(
+    _: JNIEnv,
+    _: JClass,
+    token: jlong,
+) {
+    if token == 0 {
+        return;
+    }
+    unsafe {
+        let token: *const RenderToken = token as _;
+        (&*token).cancel();
+    }
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDestroyRenderToken(
+    _: JNIEnv,
+    _: JClass,
+    token: jlong,
+) {
+    if token == 0 {
+        return;
+    }
+    unsafe {
+        let token: *mut RenderToken = token as _;
+        let _ = Box::from_raw(token);
+    }
+}
+
 
 #[allow(non_snake_case)]
 #[no_mangle]
@@ -11,15 +72,18 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDrawSVG(
     _: JClass,
     context: jlong,
     svg: JString,
-) {
+    token: jlong,
+) -> jboolean {
     unsafe {
         let context: *mut Context = context as _;
         let context = &mut *context;
         if let Ok(svg) = env.get_string(svg) {
             let svg = svg.to_string_lossy();
-            crate::common::svg::draw_svg(context, svg.as_ref());
+            let cancellation = start_render(token);
+            return to_jboolean(crate::common::svg::draw_svg(context, svg.as_ref(), &cancellation));
         }
     }
+    JNI_FALSE
 }
 
 #[allow(non_snake_case)]
@@ -29,13 +93,223 @@ pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDrawSVGFromPath
     _: JClass,
     context: jlong,
     path: JString,
-) {
+    token: jlong,
+) -> jboolean {
     unsafe {
         let context: *mut Context = context as _;
         let context = &mut *context;
         if let Ok(path) = env.get_string(path) {
             let path = path.to_string_lossy();
-            crate::common::svg::draw_svg_from_path(context, path.as_ref());
+            let cancellation = start_render(token);
+            return to_jboolean(crate::common::svg::draw_svg_from_path(
+                context,
+                path.as_ref(),
+                &cancellation,
+            ));
+        }
+    }
+    JNI_FALSE
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeSetCacheBudget(
+    _: JNIEnv,
+    _: JClass,
+    bytes: jlong,
+) {
+    crate::common::svg::cache::set_budget(bytes.max(0) as usize);
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDrawSVGDocument(
+    _: JNIEnv,
+    _: JClass,
+    context: jlong,
+    document: jlong,
+    token: jlong,
+) -> jboolean {
+    if context == 0 || document == 0 {
+        return JNI_FALSE;
+    }
+    unsafe {
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        let cancellation = start_render(token);
+        to_jboolean(crate::common::svg::draw_svg_document(context, document, &cancellation))
+    }
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentCreate(
+    env: JNIEnv,
+    _: JClass,
+    svg: JString,
+) -> jlong {
+    if let Ok(svg) = env.get_string(svg) {
+        let svg = svg.to_string_lossy();
+        match SvgDocument::from_str(svg.as_ref()) {
+            Ok(document) => return Box::into_raw(Box::new(document)) as jlong,
+            Err(e) => {
+                log::debug!("svg document parse error: {}", e);
+            }
+        }
+    }
+    0
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentDestroy(
+    _: JNIEnv,
+    _: JClass,
+    document: jlong,
+) {
+    if document == 0 {
+        return;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let _ = Box::from_raw(document);
+    }
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentElementById(
+    env: JNIEnv,
+    _: JClass,
+    document: jlong,
+    id: JString,
+) -> jint {
+    if document == 0 {
+        return -1;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &*document;
+        if id.is_null() {
+            return document.root() as jint;
+        }
+        if let Ok(id) = env.get_string(id) {
+            let id = id.to_string_lossy();
+            if let Some(node) = document.element_by_id(id.as_ref()) {
+                return node as jint;
+            }
+        }
+    }
+    -1
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentSetAttribute(
+    env: JNIEnv,
+    _: JClass,
+    document: jlong,
+    node: jint,
+    name: JString,
+    value: JString,
+) -> jboolean {
+    if document == 0 || node < 0 {
+        return JNI_FALSE;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        if let Ok(name) = env.get_string(name) {
+            let name = name.to_string_lossy();
+            let value = if value.is_null() {
+                None
+            } else {
+                match env.get_string(value) {
+                    Ok(value) => Some(value.to_string_lossy().to_string()),
+                    Err(_) => return JNI_FALSE,
+                }
+            };
+            if document.set_attribute(node as usize, name.as_ref(), value.as_deref()) {
+                return JNI_TRUE;
+            }
+        }
+    }
+    JNI_FALSE
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentSetText(
+    env: JNIEnv,
+    _: JClass,
+    document: jlong,
+    node: jint,
+    text: JString,
+) -> jboolean {
+    if document == 0 || node < 0 {
+        return JNI_FALSE;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        if let Ok(text) = env.get_string(text) {
+            let text = text.to_string_lossy();
+            if document.set_text(node as usize, text.as_ref()) {
+                return JNI_TRUE;
+            }
+        }
+    }
+    JNI_FALSE
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentAppendChild(
+    env: JNIEnv,
+    _: JClass,
+    document: jlong,
+    parent: jint,
+    xml: JString,
+) -> jint {
+    if document == 0 || parent < 0 {
+        return -1;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        if let Ok(xml) = env.get_string(xml) {
+            let xml = xml.to_string_lossy();
+            match document.append_child(parent as usize, xml.as_ref()) {
+                Ok(Some(node)) => return node as jint,
+                Ok(None) => {}
+                Err(e) => {
+                    log::debug!("svg append error: {}", e);
+                }
+            }
+        }
+    }
+    -1
+}
+
+#[allow(non_snake_case)]
+#[no_mangle]
+pub extern "system" fn Java_org_nativescript_canvas_TNSSVG_nativeDocumentRemove(
+    _: JNIEnv,
+    _: JClass,
+    document: jlong,
+    node: jint,
+) -> jboolean {
+    if document == 0 || node < 0 {
+        return JNI_FALSE;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        if document.remove(node as usize) {
+            return JNI_TRUE;
         }
     }
+    JNI_FALSE
 }
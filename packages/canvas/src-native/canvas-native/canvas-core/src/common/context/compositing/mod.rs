@@ -2,16 +2,19 @@ use std::os::raw::c_float;
 
 use crate::common::context::compositing::composite_operation_type::CompositeOperationType;
 use crate::common::context::Context;
+use crate::common::stats::{self, Counter};
 
 pub mod composite_operation_type;
 
 impl Context {
     pub fn set_global_alpha(&mut self, alpha: c_float) {
+        stats::increment(Counter::StateChanges);
         if alpha <= 1.0 && alpha >= 0.0 {
             self.state.global_alpha = alpha;
-            self.state.paint.fill_paint_mut().set_alpha_f(alpha);
-            self.state.paint.stroke_paint_mut().set_alpha_f(alpha);
-            self.state.paint.image_paint_mut().set_alpha_f(alpha);
+            let paint = self.state.paint_mut();
+            paint.fill_paint_mut().set_alpha_f(alpha);
+            paint.stroke_paint_mut().set_alpha_f(alpha);
+            paint.image_paint_mut().set_alpha_f(alpha);
         }
     }
 
@@ -20,17 +23,16 @@ impl Context {
     }
 
     pub fn set_global_composite_operation(&mut self, operation: CompositeOperationType) {
+        stats::increment(Counter::StateChanges);
         self.state.global_composite_operation = operation;
-        self.state
-            .paint
+        let paint = self.state.paint_mut();
+        paint
             .fill_paint_mut()
             .set_blender(skia_safe::Blender::mode(operation.get_blend_mode()));
-        self.state
-            .paint
+        paint
             .stroke_paint_mut()
             .set_blender(skia_safe::Blender::mode(operation.get_blend_mode()));
-        self.state
-            .paint
+        paint
             .image_paint_mut()
             .set_blender(skia_safe::Blender::mode(operation.get_blend_mode()));
     }
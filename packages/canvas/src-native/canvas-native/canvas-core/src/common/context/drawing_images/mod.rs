@@ -1,7 +1,77 @@
-use skia_safe::{Image, Rect};
+use skia_safe::{BlendMode, Canvas, Color, Image, Paint, RSXform, Rect, SamplingOptions};
 use skia_safe::canvas::SrcRectConstraint;
+use skia_safe::image::CachingHint;
 
 use crate::common::context::Context;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
+
+/// Floats per sprite in a `draw_image_batch` array: the source rect's x, y, width and height, the
+/// destination rect's, a rotation in radians about the destination's center and an alpha.
+pub const IMAGE_BATCH_SPRITE_SIZE: usize = 10;
+
+// a negative size spans back from x or y
+fn normalized_rect(x: f32, y: f32, width: f32, height: f32) -> Rect {
+    Rect::from_xywh(
+        x.min(x + width),
+        y.min(y + height),
+        width.abs(),
+        height.abs(),
+    )
+}
+
+/// Sprites waiting to go out in one `draw_atlas`.
+struct SpriteBatch {
+    xforms: Vec<RSXform>,
+    tex: Vec<Rect>,
+    colors: Vec<Color>,
+    // colors are only passed when a sprite isn't opaque
+    translucent: bool,
+}
+
+impl SpriteBatch {
+    fn with_capacity(capacity: usize) -> Self {
+        Self {
+            xforms: Vec::with_capacity(capacity),
+            tex: Vec::with_capacity(capacity),
+            colors: Vec::with_capacity(capacity),
+            translucent: false,
+        }
+    }
+
+    fn flush(
+        &mut self,
+        canvas: &mut Canvas,
+        image: &Image,
+        sampling: SamplingOptions,
+        paint: &Paint,
+    ) {
+        if self.xforms.is_empty() {
+            return;
+        }
+        stats::increment(Counter::DrawImage);
+        let colors: Option<&[Color]> = if self.translucent {
+            Some(&self.colors)
+        } else {
+            None
+        };
+        // modulate scales each sprite by its color, opaque white with the sprite's alpha
+        canvas.draw_atlas(
+            image,
+            &self.xforms,
+            &self.tex,
+            colors,
+            BlendMode::Modulate,
+            sampling,
+            None,
+            paint,
+        );
+        self.xforms.clear();
+        self.tex.clear();
+        self.colors.clear();
+        self.translucent = false;
+    }
+}
 
 impl Context {
     pub fn draw_image(
@@ -10,13 +80,13 @@ impl Context {
         src_rect: impl Into<Rect>,
         dst_rect: impl Into<Rect>,
     ) {
+        profile_scope!("context.draw_image");
+        stats::increment(Counter::DrawImage);
         self.set_scale_for_device();
         let src_rect = src_rect.into();
         let dst_rect = dst_rect.into();
 
-        self.state
-            .paint
-            .image_smoothing_quality_set(self.state.image_filter_quality());
+        self.state.sync_image_smoothing_quality();
         let paint = self.state.paint.image_paint().clone();
         self.surface.canvas().draw_image_rect_with_sampling_options(
             image,
@@ -28,12 +98,103 @@ impl Context {
         self.clear_scale_for_device();
     }
 
+    /// Draws many sprites of one image or atlas, packed `IMAGE_BATCH_SPRITE_SIZE` floats each, in
+    /// as few draws as possible. Sprites scaled the same way on both axes go out together through
+    /// `draw_atlas`, the others are drawn on their own in order. Atlas sprites aren't clamped to
+    /// their source rect, pad them when smoothing is on.
+    ///
+    /// A negative destination width or height mirrors the sprite about its center, a negative
+    /// source size only spans back from its origin.
+    pub fn draw_image_batch(&mut self, image: &Image, sprites: &[f32]) {
+        profile_scope!("context.draw_image_batch");
+        let count = sprites.len() / IMAGE_BATCH_SPRITE_SIZE;
+        if count == 0 {
+            return;
+        }
+        self.set_scale_for_device();
+        self.state.sync_image_smoothing_quality();
+        let paint = self.state.paint.image_paint().clone();
+        let sampling: SamplingOptions = self.state.image_smoothing_quality.into();
+        let canvas = self.surface.canvas();
+        let mut batch = SpriteBatch::with_capacity(count);
+
+        for sprite in sprites.chunks_exact(IMAGE_BATCH_SPRITE_SIZE) {
+            let src_rect = normalized_rect(sprite[0], sprite[1], sprite[2], sprite[3]);
+            let dst_rect = normalized_rect(sprite[4], sprite[5], sprite[6], sprite[7]);
+            let alpha = sprite[9].max(0.0).min(1.0);
+            if src_rect.is_empty() || dst_rect.is_empty() || alpha <= 0.0 {
+                continue;
+            }
+            let flip_x = sprite[6] < 0.0;
+            let flip_y = sprite[7] < 0.0;
+            // mirroring both axes is a half turn, which an RSXform can do
+            let (rotation, mirrored) = if flip_x && flip_y {
+                (sprite[8] + std::f32::consts::PI, false)
+            } else {
+                (sprite[8], flip_x || flip_y)
+            };
+
+            let scale = dst_rect.width() / src_rect.width();
+            let scale_y = dst_rect.height() / src_rect.height();
+            if mirrored || (scale - scale_y).abs() > scale.abs() * 1e-4 {
+                // an RSXform only scales uniformly and can't mirror, keep the order by flushing
+                // what came before
+                batch.flush(canvas, image, sampling, &paint);
+                stats::increment(Counter::DrawImage);
+                let mut sprite_paint = paint.clone();
+                sprite_paint.set_alpha_f(paint.alpha_f() * alpha);
+                let center = dst_rect.center();
+                canvas.save();
+                canvas.rotate(rotation.to_degrees(), Some(center));
+                if mirrored {
+                    canvas.translate(center);
+                    canvas.scale((
+                        if flip_x { -1.0 } else { 1.0 },
+                        if flip_y { -1.0 } else { 1.0 },
+                    ));
+                    canvas.translate(-center);
+                }
+                canvas.draw_image_rect_with_sampling_options(
+                    image,
+                    Some((&src_rect, SrcRectConstraint::Strict)),
+                    dst_rect,
+                    sampling,
+                    &sprite_paint,
+                );
+                canvas.restore();
+                continue;
+            }
+
+            // maps the source rect onto the destination, rotated about its center
+            let scos = scale * rotation.cos();
+            let ssin = scale * rotation.sin();
+            let half_width = src_rect.width() / 2.0;
+            let half_height = src_rect.height() / 2.0;
+            let center = dst_rect.center();
+            batch.xforms.push(RSXform::new(
+                scos,
+                ssin,
+                (
+                    center.x - (scos * half_width - ssin * half_height),
+                    center.y - (ssin * half_width + scos * half_height),
+                ),
+            ));
+            batch.tex.push(src_rect);
+            let alpha = (alpha * 255.0).round() as u8;
+            batch.colors.push(Color::from_argb(alpha, 255, 255, 255));
+            batch.translucent |= alpha < 255;
+        }
+
+        batch.flush(canvas, image, sampling, &paint);
+        self.clear_scale_for_device();
+    }
+
     pub fn draw_image_with_rect(&mut self, image: &Image, dst_rect: impl Into<Rect>) {
+        profile_scope!("context.draw_image");
+        stats::increment(Counter::DrawImage);
         self.set_scale_for_device();
         let dst_rect = dst_rect.into();
-        self.state
-            .paint
-            .image_smoothing_quality_set(self.state.image_filter_quality());
+        self.state.sync_image_smoothing_quality();
         let paint = self.state.paint.image_paint().clone();
         self.surface.canvas().draw_image_rect_with_sampling_options(
             image,
@@ -47,9 +208,9 @@ impl Context {
     }
 
     pub(crate) fn draw_image_with_points(&mut self, image: &Image, x: f32, y: f32) {
-        self.state
-            .paint
-            .image_smoothing_quality_set(self.state.image_filter_quality());
+        profile_scope!("context.draw_image");
+        stats::increment(Counter::DrawImage);
+        self.state.sync_image_smoothing_quality();
         let paint = self.state.paint.image_paint().clone();
         self.surface.canvas().draw_image_with_sampling_options(
             image,
@@ -58,4 +219,22 @@ impl Context {
             Some(&paint),
         );
     }
+
+    /// Snapshot of the current surface for drawing into another context. GPU snapshots are read
+    /// back into a raster image since every canvas owns its own skia GPU context.
+    pub fn snapshot_image(&mut self) -> Option<Image> {
+        profile_scope!("context.snapshot_image");
+        let image = self.surface.image_snapshot();
+        if image.is_texture_backed() {
+            image.to_raster_image(CachingHint::Allow)
+        } else {
+            Some(image)
+        }
+    }
+
+    /// Draws this context onto itself, the snapshot shares the surface's texture on the GPU.
+    pub fn draw_snapshot(&mut self, src_rect: impl Into<Rect>, dst_rect: impl Into<Rect>) {
+        let image = self.surface.image_snapshot();
+        self.draw_image(&image, src_rect, dst_rect);
+    }
 }
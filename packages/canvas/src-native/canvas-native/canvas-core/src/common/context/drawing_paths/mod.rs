@@ -5,6 +5,8 @@ use skia_safe::{ClipOp, Matrix, Point};
 use crate::common::context::Context;
 use crate::common::context::drawing_paths::fill_rule::FillRule;
 use crate::common::context::paths::path::Path;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 pub mod fill_rule;
 
@@ -54,14 +56,20 @@ impl Context {
     }
 
     pub fn fill(&mut self, path: Option<&mut Path>, fill_rule: FillRule) {
+        profile_scope!("context.fill");
+        stats::increment(Counter::DrawPath);
         self.fill_or_stroke(true, path, Some(fill_rule));
     }
 
     pub fn stroke(&mut self, path: Option<&mut Path>) {
+        profile_scope!("context.stroke");
+        stats::increment(Counter::DrawPath);
         self.fill_or_stroke(false, path, None);
     }
 
     pub fn clip(&mut self, path: Option<&mut Path>, fill_rule: Option<FillRule>) {
+        profile_scope!("context.clip");
+        stats::increment(Counter::StateChanges);
         let rule = fill_rule.unwrap_or(FillRule::NonZero);
         let mut path = path.unwrap_or(self.path.borrow_mut()).clone();
 
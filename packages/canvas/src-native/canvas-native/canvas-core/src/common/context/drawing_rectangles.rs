@@ -4,10 +4,14 @@ use skia_safe::{BlendMode, Paint, Rect};
 use skia_safe::paint::Style;
 
 use crate::common::context::Context;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 
 impl Context {
     pub fn clear_rect(&mut self, x: c_float, y: c_float, width: c_float, height: c_float) {
+        profile_scope!("context.clear_rect");
+        stats::increment(Counter::DrawRect);
         let mut paint = Paint::default();
         paint.set_anti_alias(true);
         paint.set_style(Style::Fill);
@@ -20,6 +24,8 @@ impl Context {
     }
 
     pub fn fill_rect(&mut self, rect: &Rect) {
+        profile_scope!("context.fill_rect");
+        stats::increment(Counter::DrawRect);
         self.set_scale_for_device();
         //let path = skia_safe::Path::rect(rect, None);
 
@@ -41,6 +47,8 @@ impl Context {
     }
 
     pub fn stroke_rect(&mut self, rect: &Rect) {
+        profile_scope!("context.stroke_rect");
+        stats::increment(Counter::DrawRect);
         self.set_scale_for_device();
         // let path = skia_safe::Path::rect(rect, None);
         if let Some(paint) = &mut self.state.paint.stroke_shadow_paint(
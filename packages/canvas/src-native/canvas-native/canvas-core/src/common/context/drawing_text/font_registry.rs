@@ -0,0 +1,144 @@
+use std::collections::HashMap;
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+use lazy_static::lazy_static;
+use parking_lot::RwLock;
+use skia_safe::{Data, FontStyle, Typeface};
+use skia_safe::font_style::Slant;
+
+lazy_static! {
+    static ref FONT_REGISTRY: FontRegistry = FontRegistry::new();
+}
+
+/// Process wide set of app provided typefaces, consulted before the system font manager when
+/// resolving a css font family. Typefaces are shared by every context.
+pub struct FontRegistry {
+    /// Keyed by lower case family name since css family names are case insensitive.
+    families: RwLock<HashMap<String, RegisteredFamily>>,
+    generation: AtomicUsize,
+}
+
+struct RegisteredFamily {
+    name: String,
+    faces: Vec<Typeface>,
+}
+
+impl FontRegistry {
+    fn new() -> Self {
+        Self {
+            families: RwLock::new(HashMap::new()),
+            generation: AtomicUsize::new(0),
+        }
+    }
+
+    pub fn shared() -> &'static FontRegistry {
+        &FONT_REGISTRY
+    }
+
+    fn family_key(family: &str) -> String {
+        family.trim().to_lowercase()
+    }
+
+    /// Registers the font file at `path` under `alias`, or its own family name when `alias` is
+    /// `None`. The file is memory mapped rather than read into memory.
+    pub fn register_path(&self, path: &str, alias: Option<&str>) -> Option<Typeface> {
+        let data = Data::from_filename(path)?;
+        self.register_data(data, alias)
+    }
+
+    /// Registers a copy of the font file contents in `bytes`, see [`FontRegistry::register_path`].
+    pub fn register_bytes(&self, bytes: &[u8], alias: Option<&str>) -> Option<Typeface> {
+        self.register_data(Data::new_copy(bytes), alias)
+    }
+
+    fn register_data(&self, data: Data, alias: Option<&str>) -> Option<Typeface> {
+        let typeface = Typeface::from_data(data, None)?;
+        let family = match alias {
+            Some(alias) if !alias.trim().is_empty() => alias.to_string(),
+            _ => typeface.family_name(),
+        };
+        {
+            let mut families = self.families.write();
+            let registered = families
+                .entry(Self::family_key(&family))
+                .or_insert_with(|| RegisteredFamily {
+                    name: family.clone(),
+                    faces: Vec::new(),
+                });
+            let style = typeface.font_style();
+            registered.faces.retain(|face| face.font_style() != style);
+            registered.faces.push(typeface.clone());
+        }
+        self.generation.fetch_add(1, Ordering::SeqCst);
+        Some(typeface)
+    }
+
+    /// Removes every typeface registered under `family`.
+    pub fn unregister(&self, family: &str) -> bool {
+        let removed = self
+            .families
+            .write()
+            .remove(&Self::family_key(family))
+            .is_some();
+        if removed {
+            self.generation.fetch_add(1, Ordering::SeqCst);
+        }
+        removed
+    }
+
+    pub fn clear(&self) {
+        self.families.write().clear();
+        self.generation.fetch_add(1, Ordering::SeqCst);
+    }
+
+    /// Bumped on every change so caches holding resolved fonts know to drop them.
+    pub fn generation(&self) -> usize {
+        self.generation.load(Ordering::SeqCst)
+    }
+
+    /// Returns the registered typeface of `family` closest to `style`, if any.
+    pub fn match_family_style(&self, family: &str, style: FontStyle) -> Option<Typeface> {
+        let families = self.families.read();
+        let registered = families.get(&Self::family_key(family))?;
+        registered
+            .faces
+            .iter()
+            .min_by_key(|face| style_distance(face.font_style(), style))
+            .cloned()
+    }
+
+    /// Returns the name `family` was registered under, matched case insensitively.
+    pub fn registered_name(&self, family: &str) -> Option<String> {
+        self.families
+            .read()
+            .get(&Self::family_key(family))
+            .map(|registered| registered.name.clone())
+    }
+
+    /// Calls `f` with every registered typeface and the family it was registered under.
+    pub fn for_each<F>(&self, mut f: F)
+    where
+        F: FnMut(&str, &Typeface),
+    {
+        let families = self.families.read();
+        for registered in families.values() {
+            for face in registered.faces.iter() {
+                f(&registered.name, face);
+            }
+        }
+    }
+}
+
+fn style_distance(a: FontStyle, b: FontStyle) -> i32 {
+    let weight = (*a.weight() - *b.weight()).abs();
+    let width = (*a.width() - *b.width()).abs() * 100;
+    let slant = if a.slant() == b.slant() {
+        0
+    } else if a.slant() == Slant::Upright || b.slant() == Slant::Upright {
+        1000
+    } else {
+        // italic and oblique are interchangeable enough
+        100
+    };
+    weight + width + slant
+}
@@ -4,11 +4,17 @@ use skia_safe::{Point, Size};
 use skia_safe::paint::Style;
 
 use crate::common::context::Context;
-use crate::common::context::drawing_text::text_metrics::TextMetrics;
+use crate::common::context::drawing_text::text_blob_cache::TextBlobMeasurement;
+use crate::common::context::drawing_text::text_metrics::{TextMetrics, TEXT_METRICS_SIZE};
 use crate::common::context::drawing_text::typography::{get_font_baseline, to_real_text_align};
 use crate::common::context::text_styles::text_align::TextAlign;
 use crate::common::utils::geometry::inflate_stroke_rect;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
+pub mod font_registry;
+pub mod paragraph;
+pub(crate) mod text_blob_cache;
 pub mod text_metrics;
 pub(crate) mod typography;
 
@@ -22,6 +28,8 @@ impl Context {
     }
 
     fn draw_text(&mut self, is_fill: bool, text: &str, x: c_float, y: c_float, width: c_float) {
+        profile_scope!("context.draw_text");
+        stats::increment(Counter::DrawText);
         if x.is_infinite() || y.is_infinite() {
             return;
         }
@@ -47,10 +55,13 @@ impl Context {
                 self.state.shadow_blur,
             ).map(|p| p.clone());
         }
-        let font = &self.state.font;
+        let measurement = self
+            .text_cache
+            .get(text, &self.state.font, self.state.paint.fill_paint());
+        let font_width = measurement.width;
+        let line_spacing = measurement.line_spacing;
+        let metrics = measurement.metrics;
 
-        let measurement = font.to_skia().measure_str(text, Some(&paint));
-        let font_width = measurement.0;
         let max_width = width;
         let width: f32;
         let use_max_width = max_width > 0.0 && max_width < font_width;
@@ -59,8 +70,7 @@ impl Context {
         } else {
             width = font_width;
         }
-        let metrics = font.to_skia().metrics();
-        let baseline = get_font_baseline(metrics.1, self.state.text_baseline);
+        let baseline = get_font_baseline(metrics, self.state.text_baseline);
         let mut location: Point = (x, y + baseline).into();
 
         match to_real_text_align(self.state.text_align, self.state.direction) {
@@ -74,7 +84,6 @@ impl Context {
                 // NOOP
             }
         }
-        let (line_spacing, metrics) = font.to_skia().metrics();
 
         let mut rect: (Point, Size) = (
             (
@@ -104,20 +113,18 @@ impl Context {
             self.surface.canvas().scale((scale_x, 1.0));
         }
 
-        let font = font.to_skia();
-
         self.set_scale_for_device();
 
-        if let Some(shadow_paint) = shadow_paint {
-            self.surface
-                .canvas()
-                .draw_str(text, (location.x, location.y), &font, &shadow_paint);
-        }
+        if let Some(blob) = measurement.blob {
+            if let Some(shadow_paint) = shadow_paint {
+                self.surface
+                    .canvas()
+                    .draw_text_blob(&blob, (location.x, location.y), &shadow_paint);
+            }
 
-        {
             self.surface
                 .canvas()
-                .draw_str(text, (location.x, location.y), &font, &paint);
+                .draw_text_blob(&blob, (location.x, location.y), &paint);
         }
 
         self.clear_scale_for_device();
@@ -128,12 +135,17 @@ impl Context {
     }
 
     pub fn measure_text(&self, text: &str) -> TextMetrics {
-        let (width, bounds) = self
-            .state
-            .font
-            .to_skia()
-            .measure_str(text, Some(self.state.paint.fill_paint()));
-        let (_, metrics) = self.state.font.to_skia().metrics();
+        profile_scope!("text.measure");
+        let measurement = self
+            .text_cache
+            .measure(text, &self.state.font, self.state.paint.fill_paint());
+        self.text_metrics(&measurement)
+    }
+
+    fn text_metrics(&self, measurement: &TextBlobMeasurement) -> TextMetrics {
+        let width = measurement.width;
+        let bounds = measurement.bounds;
+        let metrics = measurement.metrics;
         let ascent = metrics.ascent;
         let descent = metrics.descent;
         let baseline_y = get_font_baseline(metrics, self.state.text_baseline);
@@ -152,4 +164,24 @@ impl Context {
             ideographic_baseline: (descent + baseline_y),
         }
     }
+
+    /// Measures every string in `texts` with the current font and baseline, returning
+    /// [`TEXT_METRICS_SIZE`] floats per string in the order given.
+    pub fn measure_text_batch<'a, I>(&self, texts: I) -> Vec<c_float>
+    where
+        I: IntoIterator<Item = &'a str>,
+    {
+        let texts = texts.into_iter();
+        let mut buffer = Vec::with_capacity(texts.size_hint().0 * TEXT_METRICS_SIZE);
+        // misses aren't cached, a batch would only evict what fillText draws
+        for text in texts {
+            let measurement = self.text_cache.measure_uncached(
+                text,
+                &self.state.font,
+                self.state.paint.fill_paint(),
+            );
+            self.text_metrics(&measurement).write_to(&mut buffer);
+        }
+        buffer
+    }
 }
@@ -0,0 +1,391 @@
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
+use std::os::raw::c_float;
+
+use parking_lot::Mutex;
+use skia_safe::canvas::SaveLayerRec;
+use skia_safe::textlayout::{
+    FontCollection, Paragraph, ParagraphBuilder, ParagraphStyle, TextStyle, TypefaceFontProvider,
+};
+use skia_safe::{BlendMode, FontMgr};
+
+use crate::common::context::drawing_text::font_registry::FontRegistry;
+use crate::common::context::drawing_text::typography::Font;
+use crate::common::context::text_styles::text_align::TextAlign;
+use crate::common::context::text_styles::text_baseline::TextBaseLine;
+use crate::common::context::text_styles::text_direction::TextDirection;
+use crate::common::context::Context;
+use crate::common::utils::lru_cache::LruCache;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
+
+const PARAGRAPH_CACHE_SIZE: usize = 64;
+
+/// Number of floats written before the per line metrics in a packed paragraph measurement:
+/// width, height, longest line, min intrinsic width, max intrinsic width,
+/// alphabetic baseline, ideographic baseline and line count.
+pub const PARAGRAPH_METRICS_HEADER_SIZE: usize = 8;
+
+/// Number of floats written for each line in a packed paragraph measurement:
+/// start index, end index, ascent, descent, height, width, left and baseline.
+pub const PARAGRAPH_LINE_METRICS_SIZE: usize = 8;
+
+impl Into<skia_safe::textlayout::TextAlign> for TextAlign {
+    fn into(self) -> skia_safe::textlayout::TextAlign {
+        match self {
+            TextAlign::START => skia_safe::textlayout::TextAlign::Start,
+            TextAlign::LEFT => skia_safe::textlayout::TextAlign::Left,
+            TextAlign::CENTER => skia_safe::textlayout::TextAlign::Center,
+            TextAlign::RIGHT => skia_safe::textlayout::TextAlign::Right,
+            TextAlign::END => skia_safe::textlayout::TextAlign::End,
+        }
+    }
+}
+
+impl Into<skia_safe::textlayout::TextDirection> for TextDirection {
+    fn into(self) -> skia_safe::textlayout::TextDirection {
+        match self {
+            TextDirection::LTR => skia_safe::textlayout::TextDirection::LTR,
+            TextDirection::RTL => skia_safe::textlayout::TextDirection::RTL,
+        }
+    }
+}
+
+struct CachedParagraph {
+    text: String,
+    font: String,
+    key: ParagraphKey,
+    paragraph: Paragraph,
+}
+
+#[derive(Copy, Clone, PartialEq, Eq, Hash)]
+struct ParagraphKey {
+    size: u32,
+    max_width: u32,
+    line_height: u32,
+    align: i32,
+    direction: i32,
+    color: u32,
+}
+
+/// Laid out paragraphs keyed by text, font and layout options.
+/// Paragraphs painted with a shader are not cached since the shader is baked into the layout.
+/// Layouts are built without the paint's blender and image filter, which would be baked in too,
+/// [`composite_layer`] applies them when painting.
+pub(crate) struct ParagraphCache {
+    layouts: Mutex<ParagraphLayouts>,
+}
+
+struct ParagraphLayouts {
+    font_collection: FontCollection,
+    /// [`FontRegistry`] generation `font_collection` was built from.
+    generation: usize,
+    entries: LruCache<u64, CachedParagraph>,
+}
+
+impl ParagraphLayouts {
+    fn new() -> Self {
+        let registry = FontRegistry::shared();
+        Self {
+            generation: registry.generation(),
+            font_collection: Self::font_collection(registry),
+            entries: LruCache::new(PARAGRAPH_CACHE_SIZE),
+        }
+    }
+
+    /// App registered fonts take precedence over the system ones, which also provide fallback.
+    fn font_collection(registry: &FontRegistry) -> FontCollection {
+        let mut font_collection = FontCollection::new();
+        let mut provider = TypefaceFontProvider::new();
+        let mut has_fonts = false;
+        registry.for_each(|family, typeface| {
+            provider.register_typeface(typeface.clone(), Some(family));
+            has_fonts = true;
+        });
+        if has_fonts {
+            font_collection.set_asset_font_manager(Some(provider.into()));
+        }
+        font_collection.set_default_font_manager(FontMgr::default(), None);
+        font_collection.enable_font_fallback();
+        font_collection
+    }
+
+    fn sync_fonts(&mut self) {
+        let registry = FontRegistry::shared();
+        let generation = registry.generation();
+        if self.generation != generation {
+            self.generation = generation;
+            self.font_collection = Self::font_collection(registry);
+            self.entries.clear();
+        }
+    }
+}
+
+impl ParagraphCache {
+    pub fn new() -> Self {
+        Self {
+            layouts: Mutex::new(ParagraphLayouts::new()),
+        }
+    }
+
+    fn hash(text: &str, font: &str, key: &ParagraphKey) -> u64 {
+        let mut hasher = DefaultHasher::new();
+        text.hash(&mut hasher);
+        font.hash(&mut hasher);
+        key.hash(&mut hasher);
+        hasher.finish()
+    }
+
+    fn build(
+        font_collection: &FontCollection,
+        text: &str,
+        font: &Font,
+        paint: &skia_safe::Paint,
+        max_width: c_float,
+        line_height: c_float,
+        align: TextAlign,
+        direction: TextDirection,
+    ) -> Paragraph {
+        profile_scope!("text.layout_paragraph");
+        let registry = FontRegistry::shared();
+        let families: Vec<String> = font
+            .families()
+            .iter()
+            .map(|family| registry.registered_name(family).unwrap_or_else(|| family.clone()))
+            .collect();
+        let mut text_style = TextStyle::new();
+        text_style
+            .set_font_families(families.as_slice())
+            .set_font_size(font.size())
+            .set_font_style(font.style())
+            .set_foreground_color(paint);
+        if line_height > 0.0 {
+            text_style.set_height(line_height).set_height_override(true);
+        }
+
+        let mut paragraph_style = ParagraphStyle::new();
+        paragraph_style
+            .set_text_style(&text_style)
+            .set_text_align(align.into())
+            .set_text_direction(direction.into());
+
+        let mut builder = ParagraphBuilder::new(&paragraph_style, font_collection.clone());
+        builder.push_style(&text_style);
+        builder.add_text(text);
+        let mut paragraph = builder.build();
+
+        if max_width > 0.0 && max_width.is_finite() {
+            paragraph.layout(max_width);
+        } else {
+            // No wrap width, shrink the layout box to the text so alignment stays relative to it.
+            paragraph.layout(f32::MAX);
+            let width = paragraph.max_intrinsic_width().ceil();
+            paragraph.layout(width);
+        }
+        paragraph
+    }
+
+    /// Runs `f` with the cached layout for the given options, building it on a miss.
+    fn with_paragraph<F, R>(
+        &self,
+        text: &str,
+        font: &Font,
+        paint: &skia_safe::Paint,
+        max_width: c_float,
+        line_height: c_float,
+        align: TextAlign,
+        direction: TextDirection,
+        f: F,
+    ) -> R
+    where
+        F: FnOnce(&mut Paragraph) -> R,
+    {
+        let mut layouts = self.layouts.lock();
+        layouts.sync_fonts();
+        let mut layout_paint = paint.clone();
+        layout_paint.set_blender(None::<skia_safe::Blender>);
+        layout_paint.set_image_filter(None::<skia_safe::ImageFilter>);
+        let paint = &layout_paint;
+        if paint.shader().is_some() {
+            let mut paragraph = Self::build(
+                &layouts.font_collection,
+                text,
+                font,
+                paint,
+                max_width,
+                line_height,
+                align,
+                direction,
+            );
+            return f(&mut paragraph);
+        }
+
+        let key = ParagraphKey {
+            size: font.size().to_bits(),
+            max_width: max_width.to_bits(),
+            line_height: line_height.to_bits(),
+            align: align.into(),
+            direction: direction.into(),
+            color: paint.color().into(),
+        };
+        let font_details = font.get_font_details();
+        let hash = Self::hash(text, font_details, &key);
+        let layouts = &mut *layouts;
+        if let Some(cached) = layouts.entries.get_mut(&hash) {
+            if cached.key == key && cached.text == text && cached.font == font_details {
+                stats::increment(Counter::TextCacheHits);
+                return f(&mut cached.paragraph);
+            }
+        }
+
+        stats::increment(Counter::TextCacheMisses);
+        let paragraph = Self::build(
+            &layouts.font_collection,
+            text,
+            font,
+            paint,
+            max_width,
+            line_height,
+            align,
+            direction,
+        );
+        let cached = layouts.entries.insert(
+            hash,
+            CachedParagraph {
+                text: text.to_string(),
+                font: font_details.to_string(),
+                key,
+                paragraph,
+            },
+        );
+        f(&mut cached.paragraph)
+    }
+}
+
+impl Clone for ParagraphCache {
+    fn clone(&self) -> Self {
+        Self::new()
+    }
+}
+
+impl Default for ParagraphCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Paint of the layer a paragraph is drawn into when the fill paint composites or filters, so
+/// both apply to the current state rather than the one the cached layout was built with.
+fn composite_layer(paint: &skia_safe::Paint) -> Option<skia_safe::Paint> {
+    let filter = paint.image_filter();
+    if filter.is_none() && paint.as_blend_mode() == Some(BlendMode::SrcOver) {
+        return None;
+    }
+    let mut layer = skia_safe::Paint::default();
+    layer.set_blender(paint.blender());
+    layer.set_image_filter(filter);
+    Some(layer)
+}
+
+fn paragraph_offset(paragraph: &Paragraph, baseline: TextBaseLine) -> f32 {
+    match baseline {
+        TextBaseLine::TOP | TextBaseLine::HANGING => 0.0,
+        TextBaseLine::MIDDLE => paragraph.height() / 2.0,
+        TextBaseLine::BOTTOM | TextBaseLine::IDEOGRAPHIC => paragraph.height(),
+        TextBaseLine::ALPHABETIC => paragraph.alphabetic_baseline(),
+    }
+}
+
+impl Context {
+    /// Wraps `text` to `max_width` using the current font, text align and direction, and draws it
+    /// with the current fill paint. `y` is interpreted using the current text baseline against the
+    /// first line for `alphabetic` and the whole paragraph box otherwise.
+    pub fn fill_paragraph(
+        &mut self,
+        text: &str,
+        x: c_float,
+        y: c_float,
+        max_width: c_float,
+        line_height: c_float,
+    ) {
+        stats::increment(Counter::DrawText);
+        if x.is_infinite() || y.is_infinite() {
+            return;
+        }
+        let baseline = self.state.text_baseline;
+        let layer = composite_layer(self.state.paint.fill_paint());
+        let canvas = self.surface.canvas();
+        let device_matrix = if self.enable_scaling {
+            Some(&self.device.matrix)
+        } else {
+            None
+        };
+        self.paragraph_cache.with_paragraph(
+            text,
+            &self.state.font,
+            self.state.paint.fill_paint(),
+            max_width,
+            line_height,
+            self.state.text_align,
+            self.state.direction,
+            |paragraph| {
+                let y = y - paragraph_offset(paragraph, baseline);
+                if let Some(matrix) = device_matrix {
+                    canvas.save();
+                    canvas.concat(matrix);
+                }
+
+                if let Some(layer) = &layer {
+                    canvas.save_layer(&SaveLayerRec::default().paint(layer));
+                }
+                paragraph.paint(canvas, (x, y));
+                if layer.is_some() {
+                    canvas.restore();
+                }
+
+                if device_matrix.is_some() {
+                    canvas.restore();
+                }
+            },
+        );
+    }
+
+    /// Lays out `text` like [`Context::fill_paragraph`] and returns its packed metrics, see
+    /// [`PARAGRAPH_METRICS_HEADER_SIZE`] and [`PARAGRAPH_LINE_METRICS_SIZE`] for the layout.
+    pub fn measure_paragraph(&self, text: &str, max_width: c_float, line_height: c_float) -> Vec<f32> {
+        self.paragraph_cache.with_paragraph(
+            text,
+            &self.state.font,
+            self.state.paint.fill_paint(),
+            max_width,
+            line_height,
+            self.state.text_align,
+            self.state.direction,
+            |paragraph| {
+                let lines = paragraph.get_line_metrics();
+                let mut metrics = Vec::with_capacity(
+                    PARAGRAPH_METRICS_HEADER_SIZE + lines.len() * PARAGRAPH_LINE_METRICS_SIZE,
+                );
+                metrics.push(paragraph.max_width());
+                metrics.push(paragraph.height());
+                metrics.push(paragraph.longest_line());
+                metrics.push(paragraph.min_intrinsic_width());
+                metrics.push(paragraph.max_intrinsic_width());
+                metrics.push(paragraph.alphabetic_baseline());
+                metrics.push(paragraph.ideographic_baseline());
+                metrics.push(lines.len() as f32);
+                for line in lines.iter() {
+                    metrics.push(line.start_index as f32);
+                    metrics.push(line.end_index as f32);
+                    metrics.push(line.ascent as f32);
+                    metrics.push(line.descent as f32);
+                    metrics.push(line.height as f32);
+                    metrics.push(line.width as f32);
+                    metrics.push(line.left as f32);
+                    metrics.push(line.baseline as f32);
+                }
+                metrics
+            },
+        )
+    }
+}
@@ -0,0 +1,171 @@
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
+
+use parking_lot::Mutex;
+use skia_safe::{FontMetrics, Rect, TextBlob};
+
+use crate::common::context::drawing_text::font_registry::FontRegistry;
+use crate::common::context::drawing_text::typography::Font;
+use crate::common::stats::{self, Counter};
+use crate::common::utils::lru_cache::LruCache;
+
+const TEXT_BLOB_CACHE_SIZE: usize = 256;
+
+/// Measured and, for drawing, shaped text. Cheap to clone since the blob is reference counted.
+#[derive(Clone)]
+pub(crate) struct TextBlobMeasurement {
+    /// Only set when asked for by [`TextBlobCache::get`].
+    pub(crate) blob: Option<TextBlob>,
+    pub(crate) width: f32,
+    pub(crate) bounds: Rect,
+    pub(crate) line_spacing: f32,
+    pub(crate) metrics: FontMetrics,
+}
+
+struct CachedTextBlob {
+    text: String,
+    font: String,
+    size: u32,
+    measurement: TextBlobMeasurement,
+    // false while the text was only measured, the blob is shaped by the first draw
+    shaped: bool,
+}
+
+impl CachedTextBlob {
+    fn matches(&self, text: &str, font: &str, size: u32) -> bool {
+        self.size == size && self.text == text && self.font == font
+    }
+}
+
+/// Bounded cache of shaped text keyed by (text, font, size) so unchanged labels only cost a blob draw.
+/// measureText is called from the JS thread while drawing happens on the render thread, hence the lock.
+pub(crate) struct TextBlobCache {
+    entries: Mutex<TextBlobEntries>,
+}
+
+struct TextBlobEntries {
+    /// [`FontRegistry`] generation the blobs were shaped with.
+    generation: usize,
+    blobs: LruCache<u64, CachedTextBlob>,
+}
+
+impl TextBlobCache {
+    pub fn new() -> Self {
+        Self {
+            entries: Mutex::new(TextBlobEntries {
+                generation: FontRegistry::shared().generation(),
+                blobs: LruCache::new(TEXT_BLOB_CACHE_SIZE),
+            }),
+        }
+    }
+
+    fn key(text: &str, font: &str, size: u32) -> u64 {
+        let mut hasher = DefaultHasher::new();
+        text.hash(&mut hasher);
+        font.hash(&mut hasher);
+        size.hash(&mut hasher);
+        hasher.finish()
+    }
+
+    /// Returns the measurement of `text` in `font` with its blob for drawing, shaping it on a miss
+    /// or when it was only measured so far.
+    pub fn get(&self, text: &str, font: &Font, paint: &skia_safe::Paint) -> TextBlobMeasurement {
+        self.fetch(text, font, paint, true, true)
+    }
+
+    /// Returns the measurement of `text` in `font` without shaping a blob, caching it for a later
+    /// draw of the same text.
+    pub fn measure(
+        &self,
+        text: &str,
+        font: &Font,
+        paint: &skia_safe::Paint,
+    ) -> TextBlobMeasurement {
+        self.fetch(text, font, paint, false, true)
+    }
+
+    /// Like [`measure`](Self::measure) but a miss isn't cached, for measuring many strings at once
+    /// without evicting what fillText draws.
+    pub fn measure_uncached(
+        &self,
+        text: &str,
+        font: &Font,
+        paint: &skia_safe::Paint,
+    ) -> TextBlobMeasurement {
+        self.fetch(text, font, paint, false, false)
+    }
+
+    fn fetch(
+        &self,
+        text: &str,
+        font: &Font,
+        paint: &skia_safe::Paint,
+        shape: bool,
+        store: bool,
+    ) -> TextBlobMeasurement {
+        let font_details = font.get_font_details();
+        let size = font.size().to_bits();
+        let key = Self::key(text, font_details, size);
+        let generation = FontRegistry::shared().generation();
+        let mut entries = self.entries.lock();
+        if entries.generation != generation {
+            entries.blobs.clear();
+            entries.generation = generation;
+        }
+        if let Some(entry) = entries.blobs.get_mut(&key) {
+            if entry.matches(text, font_details, size) {
+                stats::increment(Counter::TextCacheHits);
+                if shape && !entry.shaped {
+                    entry.measurement.blob = TextBlob::from_str(text, &font.to_skia());
+                    entry.shaped = true;
+                }
+                return entry.measurement.clone();
+            }
+        }
+        stats::increment(Counter::TextCacheMisses);
+
+        let (line_spacing, metrics) = font.metrics();
+        let font = font.to_skia();
+        let (width, bounds) = font.measure_str(text, Some(paint));
+        let measurement = TextBlobMeasurement {
+            blob: if shape {
+                TextBlob::from_str(text, &font)
+            } else {
+                None
+            },
+            width,
+            bounds,
+            line_spacing,
+            metrics,
+        };
+        if store {
+            entries.blobs.insert(
+                key,
+                CachedTextBlob {
+                    text: text.to_string(),
+                    font: font_details.to_string(),
+                    size,
+                    measurement: measurement.clone(),
+                    shaped: shape,
+                },
+            );
+        }
+        measurement
+    }
+
+    pub fn clear(&self) {
+        self.entries.lock().blobs.clear();
+    }
+}
+
+impl Clone for TextBlobCache {
+    fn clone(&self) -> Self {
+        Self::new()
+    }
+}
+
+impl Default for TextBlobCache {
+    fn default() -> Self {
+        Self::new()
+    }
+}
@@ -1,5 +1,8 @@
 use std::os::raw::c_float;
 
+/// Number of floats written per string by [`TextMetrics::write_to`], in field declaration order.
+pub const TEXT_METRICS_SIZE: usize = 12;
+
 #[repr(C)]
 #[derive(Clone, Copy, Debug)]
 pub struct TextMetrics {
@@ -18,6 +21,24 @@ pub struct TextMetrics {
 }
 
 impl TextMetrics {
+    /// Appends all metrics to `buffer` in field declaration order.
+    pub fn write_to(&self, buffer: &mut Vec<c_float>) {
+        buffer.extend_from_slice(&[
+            self.width,
+            self.actual_bounding_box_left,
+            self.actual_bounding_box_right,
+            self.font_bounding_box_ascent,
+            self.font_bounding_box_descent,
+            self.actual_bounding_box_ascent,
+            self.actual_bounding_box_descent,
+            self.em_height_ascent,
+            self.em_height_descent,
+            self.hanging_baseline,
+            self.alphabetic_baseline,
+            self.ideographic_baseline,
+        ]);
+    }
+
     pub fn width(&self) -> c_float {
         self.width
     }
@@ -1,5 +1,10 @@
+use std::collections::hash_map::DefaultHasher;
 use std::collections::VecDeque;
+use std::hash::{Hash, Hasher};
+use std::sync::Arc;
 
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
 
 use skia_safe::{
     font_style::{Slant, Weight, Width},
@@ -8,10 +13,13 @@ use skia_safe::{
 };
 
 use crate::{
+    common::context::drawing_text::font_registry::FontRegistry,
     common::context::text_styles::text_align::TextAlign,
     common::context::text_styles::text_baseline::TextBaseLine,
     common::context::text_styles::text_direction::TextDirection, common::context::Device,
     common::utils::dimensions::parse_size,
+    common::utils::lru_cache::LruCache,
+    common::stats::{self, Counter},
 };
 
 const XX_SMALL: &str = "9px";
@@ -67,73 +75,166 @@ pub(crate) fn to_real_text_align(align: TextAlign, direction: TextDirection) ->
     }
 }
 
+const FONT_DESCRIPTOR_CACHE_SIZE: usize = 128;
+
+lazy_static! {
+    static ref FONT_DESCRIPTORS: Mutex<LruCache<u64, Arc<FontDescriptor>>> =
+        Mutex::new(LruCache::new(FONT_DESCRIPTOR_CACHE_SIZE));
+}
+
+/// A css font string parsed and resolved to a skia font once, then interned and shared by every
+/// context so assigning the same `font` again is a hash lookup.
+pub(crate) struct FontDescriptor {
+    details: String,
+    parsed: ParsedFont,
+    families: Vec<String>,
+    style: FontStyle,
+    size: f32,
+    device: Device,
+    font: skia_safe::Font,
+    line_spacing: f32,
+    metrics: FontMetrics,
+    /// [`FontRegistry`] generation the typeface was resolved with.
+    generation: usize,
+}
+
+impl FontDescriptor {
+    fn new(details: &str, device: Device, generation: usize) -> Self {
+        let parsed = parse_font(details);
+        let families = parse_font_family(parsed.font_family());
+        let style = to_font_style(parsed.font_weight(), parsed.font_style());
+        let size = parse_size(parsed.font_size(), device);
+        let typeface = resolve_typeface(&families, style)
+            .or_else(|| Typeface::from_name("sans-serif", style))
+            .unwrap_or(Typeface::default());
+        let font = skia_safe::Font::from_typeface(typeface, Some(size));
+        let (line_spacing, metrics) = font.metrics();
+        Self {
+            details: details.to_string(),
+            parsed,
+            families,
+            style,
+            size,
+            device,
+            font,
+            line_spacing,
+            metrics,
+            generation,
+        }
+    }
+
+    fn key(details: &str, device: &Device) -> u64 {
+        let mut hasher = DefaultHasher::new();
+        details.hash(&mut hasher);
+        device.ppi.to_bits().hash(&mut hasher);
+        device.width.to_bits().hash(&mut hasher);
+        device.height.to_bits().hash(&mut hasher);
+        hasher.finish()
+    }
+
+    fn matches(&self, details: &str, device: &Device, generation: usize) -> bool {
+        self.generation == generation
+            && self.device.ppi == device.ppi
+            && self.device.width == device.width
+            && self.device.height == device.height
+            && self.details == details
+    }
+
+    /// Returns the shared descriptor for `details` on `device`, parsing and resolving it on a miss.
+    pub(crate) fn intern(details: &str, device: Device) -> Arc<FontDescriptor> {
+        let generation = FontRegistry::shared().generation();
+        let key = Self::key(details, &device);
+        let mut descriptors = FONT_DESCRIPTORS.lock();
+        if let Some(descriptor) = descriptors.get(&key) {
+            if descriptor.matches(details, &device, generation) {
+                stats::increment(Counter::FontCacheHits);
+                return Arc::clone(descriptor);
+            }
+        }
+        stats::increment(Counter::FontCacheMisses);
+        let descriptor = Arc::new(Self::new(details, device, generation));
+        descriptors.insert(key, Arc::clone(&descriptor));
+        descriptor
+    }
+
+    fn is_stale(&self) -> bool {
+        self.generation != FontRegistry::shared().generation()
+    }
+}
+
+impl std::fmt::Debug for FontDescriptor {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("FontDescriptor")
+            .field("details", &self.details)
+            .field("parsed", &self.parsed)
+            .field("size", &self.size)
+            .finish()
+    }
+}
+
 #[derive(Debug, Clone)]
 pub struct Font {
-    pub(crate) font_details: String,
-    pub(crate) font: ParsedFont,
-    pub(crate) device: Device,
+    descriptor: Arc<FontDescriptor>,
 }
 
 impl Font {
     pub fn new(font_details: &str, device: Device) -> Self {
         Self {
-            font_details: font_details.to_string(),
-            font: parse_font(font_details),
-            device,
+            descriptor: FontDescriptor::intern(font_details, device),
         }
     }
 
     pub fn get_font_details(&self) -> &str {
-        self.font_details.as_ref()
+        self.descriptor.details.as_ref()
     }
 
     pub fn get_font(&self) -> &ParsedFont {
-        &self.font
+        &self.descriptor.parsed
     }
 
     pub fn set_font(&mut self, font_details: &str) {
-        if font_details.is_empty() {
+        if font_details.is_empty() || font_details == self.descriptor.details {
             return;
         }
 
-        self.font_details = font_details.to_string();
-        self.font = parse_font(font_details);
+        self.descriptor = FontDescriptor::intern(font_details, self.descriptor.device);
     }
 
+    /// Registers the font file at `path` under its own family name so it can be used by any context.
     pub fn load_type_from_path(&mut self, path: &str) -> Option<Typeface> {
-        let mgr = FontMgr::default();
-        match std::fs::read(std::path::Path::new(path)) {
-            Ok(bytes) => {
-                mgr.new_from_data(bytes.as_slice(), None)
-            }
-            Err(_) => None
+        FontRegistry::shared().register_path(path, None)
+    }
+
+    pub fn to_skia(&self) -> skia_safe::Font {
+        if self.descriptor.is_stale() {
+            // fonts were registered since this was resolved
+            return FontDescriptor::intern(&self.descriptor.details, self.descriptor.device)
+                .font
+                .clone();
         }
+        self.descriptor.font.clone()
     }
 
-    fn to_font(&self) -> skia_safe::Font {
-        let style = to_font_style(self.font.font_weight(), self.font.font_style());
-        let families: Vec<String> = parse_font_family(self.font.font_family());
-        let mut default_typeface =
-            Typeface::from_name("sans-serif", style).unwrap_or(Typeface::default());
-        let mgr = FontMgr::default();
-        let families_count = mgr.count_families();
-        for i in 0..families_count {
-            let name = mgr.family_name(i);
-            if families.contains(&name) {
-                if let Some(typeface) = mgr.match_family_style(&name, style) {
-                    default_typeface = typeface;
-                    break;
-                }
-            }
+    /// Line spacing and metrics of the resolved font.
+    pub fn metrics(&self) -> (f32, FontMetrics) {
+        if self.descriptor.is_stale() {
+            let descriptor =
+                FontDescriptor::intern(&self.descriptor.details, self.descriptor.device);
+            return (descriptor.line_spacing, descriptor.metrics);
         }
-        skia_safe::Font::from_typeface(
-            default_typeface,
-            Some(parse_size(self.font.font_size(), self.device)),
-        )
+        (self.descriptor.line_spacing, self.descriptor.metrics)
     }
 
-    pub fn to_skia(&self) -> skia_safe::Font {
-        self.to_font()
+    pub(crate) fn families(&self) -> &[String] {
+        self.descriptor.families.as_slice()
+    }
+
+    pub(crate) fn style(&self) -> FontStyle {
+        self.descriptor.style
+    }
+
+    pub fn size(&self) -> f32 {
+        self.descriptor.size
     }
 }
 
@@ -326,11 +427,9 @@ fn parse_font_family(value: &str) -> Vec<String> {
         return result;
     }
 
-    let regex = regex::Regex::new(r#"/['"]+/g"#).unwrap();
-
     let split = value.split(',');
     for item in split {
-        let s = regex.replace(item.trim(), "");
+        let s = item.trim().trim_matches(|c: char| c == '\'' || c == '"').trim();
         if !s.is_empty() {
             result.push(s.to_string());
         }
@@ -339,6 +438,18 @@ fn parse_font_family(value: &str) -> Vec<String> {
     return result;
 }
 
+/// Picks the first family in css order that is registered with the app [`FontRegistry`] or known
+/// to the system font manager.
+fn resolve_typeface(families: &[String], style: FontStyle) -> Option<Typeface> {
+    let registry = FontRegistry::shared();
+    let mgr = FontMgr::default();
+    families.iter().find_map(|family| {
+        registry
+            .match_family_style(family, style)
+            .or_else(|| mgr.match_family_style(family, style))
+    })
+}
+
 fn is_size_length(value: &str) -> bool {
     return value.contains("pc")
         || value.contains("pt")
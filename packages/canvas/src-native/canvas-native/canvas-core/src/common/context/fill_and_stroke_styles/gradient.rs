@@ -5,6 +5,7 @@ use skia_safe::{
     gradient_shader::GradientShaderColors,
 };
 
+use crate::common::context::fill_and_stroke_styles::shader_cache::ShaderCache;
 use crate::common::context::matrix::Matrix;
 
 #[derive(Clone)]
@@ -16,6 +17,7 @@ pub enum Gradient {
         colors: Vec<Color>,
         matrix: Option<Matrix>,
         tile_mode: TileMode,
+        shader: ShaderCache,
     },
     Radial {
         start: Point,
@@ -26,6 +28,7 @@ pub enum Gradient {
         colors: Vec<Color>,
         matrix: Option<Matrix>,
         tile_mode: TileMode,
+        shader: ShaderCache,
     },
     Conic {
         center: Point,
@@ -34,6 +37,7 @@ pub enum Gradient {
         colors: Vec<Color>,
         matrix: Option<Matrix>,
         tile_mode: TileMode,
+        shader: ShaderCache,
     },
 }
 
@@ -46,7 +50,24 @@ impl Gradient {
         }
     }
 
+    fn shader_cache(&self) -> &ShaderCache {
+        match self {
+            Gradient::Linear { shader, .. } => shader,
+            Gradient::Radial { shader, .. } => shader,
+            Gradient::Conic { shader, .. } => shader,
+        }
+    }
+
+    fn invalidate_shader(&mut self) {
+        match self {
+            Gradient::Linear { shader, .. } => shader.invalidate(),
+            Gradient::Radial { shader, .. } => shader.invalidate(),
+            Gradient::Conic { shader, .. } => shader.invalidate(),
+        }
+    }
+
     pub(crate) fn set_tile_mode(&mut self, mode: TileMode) {
+        self.invalidate_shader();
         match self {
             Gradient::Linear {
                 ref mut tile_mode, ..
@@ -60,7 +81,15 @@ impl Gradient {
         }
     }
 
+    /// Returns the gradient's shader, built on first use and reused until a stop is added or the
+    /// tile mode changes.
     pub fn to_shader(gradient: &Gradient) -> Option<Shader> {
+        gradient
+            .shader_cache()
+            .get_or_build((), || Gradient::build_shader(gradient))
+    }
+
+    fn build_shader(gradient: &Gradient) -> Option<Shader> {
         match gradient {
             Gradient::Linear {
                 start,
@@ -235,6 +264,7 @@ impl Gradient {
     }
 
     pub fn add_color_stop(&mut self, offset: c_float, color: Color) {
+        self.invalidate_shader();
         let stops = match self {
             Gradient::Linear { stops, .. } => stops,
             Gradient::Radial { stops, .. } => stops,
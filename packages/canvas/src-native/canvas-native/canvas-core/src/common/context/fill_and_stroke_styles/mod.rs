@@ -1,12 +1,15 @@
 use crate::{common::context::Context, common::context::fill_and_stroke_styles::paint::PaintStyle};
+use crate::common::stats::{self, Counter};
 
 pub mod gradient;
 pub mod paint;
 pub mod pattern;
+pub mod shader_cache;
 
 impl Context {
     pub fn set_fill_style(&mut self, style: PaintStyle) {
-        self.state.paint.set_style(true, style)
+        stats::increment(Counter::StateChanges);
+        self.state.paint_mut().set_style(true, style)
     }
 
     pub fn fill_style(&mut self) -> &PaintStyle {
@@ -14,10 +17,9 @@ impl Context {
     }
 
     pub fn set_stroke_style(&mut self, style: PaintStyle) {
-        self.state
-            .paint
-            .image_smoothing_quality_set(self.state.image_filter_quality());
-        self.state.paint.set_style(false, style)
+        stats::increment(Counter::StateChanges);
+        self.state.sync_image_smoothing_quality();
+        self.state.paint_mut().set_style(false, style)
     }
 
     pub fn stroke_style(&mut self) -> &PaintStyle {
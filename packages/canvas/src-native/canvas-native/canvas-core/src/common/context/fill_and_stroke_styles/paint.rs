@@ -7,6 +7,7 @@ use crate::common::context::fill_and_stroke_styles::gradient::Gradient;
 use crate::common::context::fill_and_stroke_styles::pattern::Pattern;
 use crate::common::context::filter_quality::FilterQuality;
 use crate::common::context::image_smoothing::ImageSmoothingQuality;
+use crate::common::stats::{self, Counter};
 use crate::common::utils::color::to_parsed_color;
 
 #[derive(Clone)]
@@ -33,7 +34,6 @@ impl PaintStyle {
     }
 }
 
-#[derive(Clone)]
 pub struct Paint {
     fill_paint: skia_safe::Paint,
     stroke_paint: skia_safe::Paint,
@@ -43,11 +43,29 @@ pub struct Paint {
     image_smoothing_quality: FilterQuality,
 }
 
+impl Clone for Paint {
+    fn clone(&self) -> Self {
+        stats::increment(Counter::PaintClones);
+        Self {
+            fill_paint: self.fill_paint.clone(),
+            stroke_paint: self.stroke_paint.clone(),
+            image_paint: self.image_paint.clone(),
+            fill_style: self.fill_style.clone(),
+            stroke_style: self.stroke_style.clone(),
+            image_smoothing_quality: self.image_smoothing_quality,
+        }
+    }
+}
+
 impl Paint {
     pub fn image_smoothing_quality_set(&mut self, image_smoothing_quality: FilterQuality) {
         self.image_smoothing_quality = image_smoothing_quality
     }
 
+    pub fn image_smoothing_quality(&self) -> FilterQuality {
+        self.image_smoothing_quality
+    }
+
     fn update_paint_style(&mut self, is_fill: bool) {
         let style;
         if is_fill {
@@ -96,7 +114,7 @@ impl Paint {
         self.update_paint_style(is_fill);
     }
 
-    pub fn style(&mut self, is_fill: bool) -> &PaintStyle {
+    pub fn style(&self, is_fill: bool) -> &PaintStyle {
         if is_fill {
             &self.fill_style
         } else {
@@ -1,5 +1,6 @@
 use skia_safe::{Image, Shader, TileMode};
 
+use crate::common::context::fill_and_stroke_styles::shader_cache::ShaderCache;
 use crate::common::context::filter_quality::FilterQuality;
 use crate::common::context::matrix::Matrix;
 
@@ -40,13 +41,22 @@ pub struct Pattern {
     image: Image,
     repetition: Repetition,
     matrix: skia_safe::Matrix,
+    shader: ShaderCache<FilterQuality>,
 }
 
 impl Pattern {
+    /// Returns the pattern's shader for `image_smoothing_quality`, built on first use and reused
+    /// until the transform or the quality changes.
     pub fn to_pattern_shader(
         pattern: &Pattern,
         image_smoothing_quality: FilterQuality,
     ) -> Option<Shader> {
+        pattern.shader.get_or_build(image_smoothing_quality, || {
+            Pattern::build_shader(pattern, image_smoothing_quality)
+        })
+    }
+
+    fn build_shader(pattern: &Pattern, image_smoothing_quality: FilterQuality) -> Option<Shader> {
         let mode: (TileMode, TileMode) = match pattern.repetition {
             Repetition::NoRepeat => (TileMode::Clamp, TileMode::Clamp),
             Repetition::RepeatX => (TileMode::Repeat, TileMode::Clamp),
@@ -68,6 +78,7 @@ impl Pattern {
             image,
             repetition,
             matrix: skia_safe::Matrix::default(),
+            shader: ShaderCache::default(),
         }
     }
 
@@ -78,9 +89,11 @@ impl Pattern {
         self.matrix.set_affine(&affine);*/
         let matrix = matrix.matrix.to_m33();
         self.matrix.pre_concat(&matrix);
+        self.shader.invalidate();
     }
 
     pub(crate) fn matrix_mut(&mut self) -> &mut skia_safe::Matrix {
+        self.shader.invalidate();
         &mut self.matrix
     }
 
@@ -0,0 +1,49 @@
+use std::sync::Arc;
+
+use parking_lot::Mutex;
+use skia_safe::Shader;
+
+use crate::common::stats::{self, Counter};
+
+/// Lazily built shader of a gradient or pattern, shared by every copy of it. A style is copied
+/// each time it is assigned to a context, so sharing means assigning the same style object every
+/// frame builds its shader once.
+///
+/// Owners call [`ShaderCache::invalidate`] when they change, which swaps in an empty cache rather
+/// than clearing the shared one, so copies taken earlier keep a shader matching their own state.
+#[derive(Clone)]
+pub struct ShaderCache<K = ()> {
+    entry: Arc<Mutex<Option<(K, Option<Shader>)>>>,
+}
+
+impl<K> Default for ShaderCache<K> {
+    fn default() -> Self {
+        Self {
+            entry: Arc::new(Mutex::new(None)),
+        }
+    }
+}
+
+impl<K: Copy + PartialEq> ShaderCache<K> {
+    /// Returns the shader built for `key`, calling `build` if there is none yet.
+    pub fn get_or_build<F>(&self, key: K, build: F) -> Option<Shader>
+    where
+        F: FnOnce() -> Option<Shader>,
+    {
+        let mut entry = self.entry.lock();
+        if let Some((cached, shader)) = entry.as_ref() {
+            if *cached == key {
+                stats::increment(Counter::ShaderCacheHits);
+                return shader.clone();
+            }
+        }
+        stats::increment(Counter::ShaderCacheMisses);
+        let shader = build();
+        *entry = Some((key, shader.clone()));
+        shader
+    }
+
+    pub fn invalidate(&mut self) {
+        *self = Self::default();
+    }
+}
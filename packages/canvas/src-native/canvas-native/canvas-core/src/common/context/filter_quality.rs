@@ -1,6 +1,6 @@
 use skia_safe::{FilterMode, MipmapMode, SamplingOptions};
 
-#[derive(Copy, Clone)]
+#[derive(Copy, Clone, PartialEq, Eq)]
 pub enum FilterQuality {
     None,
     Low,
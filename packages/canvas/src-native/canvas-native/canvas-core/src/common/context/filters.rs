@@ -345,16 +345,11 @@ impl Context {
                 _ => chain,
             });
 
-        self.state.filter = value.to_string();
-        self.state
-            .paint
-            .fill_paint_mut()
-            .set_image_filter(filter.clone());
-        self.state
-            .paint
-            .stroke_paint_mut()
-            .set_image_filter(filter.clone());
-        self.state.paint.image_paint_mut().set_image_filter(filter);
+        self.state.filter = value.into();
+        let paint = self.state.paint_mut();
+        paint.fill_paint_mut().set_image_filter(filter.clone());
+        paint.stroke_paint_mut().set_image_filter(filter.clone());
+        paint.image_paint_mut().set_image_filter(filter);
     }
 
     pub fn get_filter(&self) -> &str {
@@ -5,6 +5,7 @@ use skia_safe::{Image, Point, TileMode};
 use crate::common::context::Context;
 use crate::common::context::fill_and_stroke_styles::gradient::Gradient;
 use crate::common::context::fill_and_stroke_styles::pattern::{Pattern, Repetition};
+use crate::common::context::fill_and_stroke_styles::shader_cache::ShaderCache;
 use crate::common::context::matrix::Matrix;
 
 impl Context {
@@ -22,6 +23,7 @@ impl Context {
             stops: Vec::new(),
             matrix: None,
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 
@@ -40,6 +42,7 @@ impl Context {
             stops: Vec::new(),
             matrix: Some(matrix),
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 
@@ -57,6 +60,7 @@ impl Context {
             stops: Vec::new(),
             matrix: None,
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 
@@ -75,6 +79,7 @@ impl Context {
             stops: Vec::new(),
             matrix: Some(matrix),
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 
@@ -100,6 +105,7 @@ impl Context {
             colors: Vec::new(),
             matrix: None,
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 
@@ -122,6 +128,7 @@ impl Context {
             colors: Vec::new(),
             matrix: Some(matrix),
             tile_mode: TileMode::Clamp,
+            shader: ShaderCache::default(),
         }
     }
 }
@@ -9,6 +9,8 @@ use parking_lot::lock_api::MutexGuard;
 use parking_lot::RawMutex;
 use stb::image::{Channels, Data, Info};
 use crate::common::ffi::u8_array::U8Array;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::Handle;
 
 enum ImageAssetInnerData {
     Stb(Data<u8>),
@@ -22,6 +24,7 @@ struct ImageAssetInner {
     did_resize: bool,
     skia_image: Option<skia_safe::Image>,
     density: f32,
+    _handle: Handle,
 }
 
 unsafe impl Send for ImageAssetInner {}
@@ -113,6 +116,7 @@ impl ImageAsset {
                                 skia_image: crate::common::utils::image::from_image_slice_non_copy(data.as_slice(), info.width, info.height),
                                 image: Some(ImageAssetInnerData::Stb(data)),
                                 density,
+                                _handle: Handle::new(),
                             };
                             return Some(Self(Arc::new(parking_lot::Mutex::new(inner))));
                         }
@@ -132,6 +136,7 @@ impl ImageAsset {
                         skia_image,
                         image: Some(ImageAssetInnerData::Raw(data.clone())),
                         density,
+                        _handle: Handle::new(),
                     };
                     Some(Self(Arc::new(parking_lot::Mutex::new(inner))))
                 }
@@ -148,6 +153,7 @@ impl ImageAsset {
             did_resize: false,
             skia_image: None,
             density: 1.,
+            _handle: Handle::new(),
         })))
     }
 
@@ -243,6 +249,7 @@ impl ImageAsset {
     }
 
     pub fn load_from_path(&mut self, path: &str) -> bool {
+        profile_scope!("image.decode");
         {
             let mut lock = self.get_lock();
             if !lock.error.is_empty() {
@@ -264,6 +271,7 @@ impl ImageAsset {
         where
             R: Read + Seek,
     {
+        profile_scope!("image.decode");
         let mut lock = self.get_lock();
         if !lock.error.is_empty() {
             lock.error.clear()
@@ -313,6 +321,7 @@ impl ImageAsset {
     }
 
     pub fn load_from_bytes(&mut self, buf: &[u8]) -> bool {
+        profile_scope!("image.decode");
         let mut lock = self.get_lock();
         if !lock.error.is_empty() {
             lock.error.clear()
@@ -337,6 +346,7 @@ impl ImageAsset {
     }
 
     pub fn scale(&mut self, x: c_uint, y: c_uint) -> bool {
+        profile_scope!("image.scale");
         let mut lock = self.get_lock();
         if !lock.error.is_empty() {
             lock.error.clear()
@@ -404,6 +414,7 @@ impl ImageAsset {
     }
 
     pub fn save_path(&mut self, path: &str, format: OutputFormat) -> bool {
+        profile_scope!("image.encode");
         let mut lock = self.get_lock();
         if !lock.error.is_empty() {
             lock.error.clear()
@@ -73,8 +73,6 @@ impl Context {
 
     pub fn set_image_smoothing_quality(&mut self, value: ImageSmoothingQuality) {
         self.state.image_smoothing_quality = value;
-        self.state
-            .paint
-            .image_smoothing_quality_set(self.state.image_filter_quality());
+        self.state.sync_image_smoothing_quality();
     }
 }
@@ -1,19 +1,22 @@
 use std::borrow::Cow;
 use std::os::raw::c_float;
+use std::sync::Arc;
 
 use skia_safe::PathEffect;
 
 use crate::common::context::Context;
 use crate::common::context::line_styles::line_cap::LineCap;
 use crate::common::context::line_styles::line_join::LineJoin;
+use crate::common::stats::{self, Counter};
 
 pub mod line_cap;
 pub mod line_join;
 
 impl Context {
     pub fn set_line_width(&mut self, width: c_float) {
+        stats::increment(Counter::StateChanges);
         self.state.line_width = width;
-        self.state.paint.stroke_paint_mut().set_stroke_width(width);
+        self.state.paint_mut().stroke_paint_mut().set_stroke_width(width);
     }
 
     pub fn line_width(&self) -> c_float {
@@ -21,9 +24,10 @@ impl Context {
     }
 
     pub fn set_line_cap(&mut self, cap: LineCap) {
+        stats::increment(Counter::StateChanges);
         self.state.line_cap = cap;
         self.state
-            .paint
+            .paint_mut()
             .stroke_paint_mut()
             .set_stroke_cap(cap.into());
     }
@@ -37,9 +41,10 @@ impl Context {
     }
 
     pub fn set_line_join(&mut self, join: LineJoin) {
+        stats::increment(Counter::StateChanges);
         self.state.line_join = join;
         self.state
-            .paint
+            .paint_mut()
             .stroke_paint_mut()
             .set_stroke_join(join.into());
     }
@@ -49,11 +54,13 @@ impl Context {
     }
 
     pub fn set_miter_limit(&mut self, limit: c_float) {
+        stats::increment(Counter::StateChanges);
         self.state.miter_limit = limit;
-        self.state.paint.stroke_paint_mut().set_stroke_miter(limit);
+        self.state.paint_mut().stroke_paint_mut().set_stroke_miter(limit);
     }
 
     pub fn set_line_dash(&mut self, dash: &[c_float]) {
+        stats::increment(Counter::StateChanges);
         // TODO ?
         let line_dash: Cow<[f32]>;
         let is_odd = (dash.len() % 2) != 0;
@@ -66,9 +73,8 @@ impl Context {
         if !line_dash.is_empty() {
             effect = PathEffect::dash(line_dash.as_ref(), self.state.line_dash_offset);
         }
-        let slice = line_dash.as_ref();
-        self.state.line_dash_list.splice(.., slice.iter().cloned());
-        self.state.paint.stroke_paint_mut().set_path_effect(effect);
+        self.state.line_dash_list = line_dash.as_ref().into();
+        self.state.paint_mut().stroke_paint_mut().set_path_effect(effect);
     }
 
     pub fn line_dash(&self) -> &[c_float] {
@@ -76,10 +82,11 @@ impl Context {
     }
 
     pub fn set_line_dash_offset(&mut self, offset: c_float) {
+        stats::increment(Counter::StateChanges);
         // TODO ?
         self.state.line_dash_offset = offset;
-        let list = self.state.line_dash_list.clone();
-        self.set_line_dash(list.as_slice());
+        let list = Arc::clone(&self.state.line_dash_list);
+        self.set_line_dash(&list);
     }
 
     pub fn line_dash_offset(&self) -> c_float {
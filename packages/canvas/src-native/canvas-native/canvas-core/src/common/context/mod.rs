@@ -1,10 +1,13 @@
 use std::os::raw::c_float;
+use std::sync::Arc;
 
 use skia_safe::{Color, Point, Surface};
 
 use crate::common::context::filter_quality::FilterQuality;
 use crate::{
     common::context::compositing::composite_operation_type::CompositeOperationType,
+    common::context::drawing_text::paragraph::ParagraphCache,
+    common::context::drawing_text::text_blob_cache::TextBlobCache,
     common::context::drawing_text::typography::Font,
     common::context::fill_and_stroke_styles::paint::Paint,
     common::context::image_smoothing::ImageSmoothingQuality,
@@ -15,6 +18,8 @@ use crate::{
         text_align::TextAlign, text_baseline::TextBaseLine, text_direction::TextDirection,
     },
 };
+use crate::common::profiler::profile_scope;
+use crate::common::stats::Handle;
 
 pub mod drawing_images;
 pub mod drawing_text;
@@ -72,10 +77,14 @@ impl Device {
     }
 }
 
+/// Drawing state saved and restored by `save()`/`restore()`. The larger members are shared
+/// between the current state and the saved stack and only copied when written to, so a save is
+/// mostly reference count bumps.
 #[derive(Clone)]
 pub(crate) struct State {
     pub(crate) direction: TextDirection,
-    pub(crate) paint: Paint,
+    /// Use [`State::paint_mut`] to modify.
+    pub(crate) paint: Arc<Paint>,
     pub(crate) font: Font,
     pub(crate) text_align: TextAlign,
     pub(crate) text_baseline: TextBaseLine,
@@ -88,9 +97,9 @@ pub(crate) struct State {
     pub(crate) line_cap: LineCap,
     pub(crate) line_join: LineJoin,
     pub(crate) miter_limit: f32,
-    pub(crate) line_dash_list: Vec<f32>,
+    pub(crate) line_dash_list: Arc<[f32]>,
     pub(crate) line_dash_offset: f32,
-    pub(crate) filter: String,
+    pub(crate) filter: Arc<str>,
     pub(crate) global_alpha: f32,
     pub(crate) global_composite_operation: CompositeOperationType,
 }
@@ -103,6 +112,20 @@ impl State {
             FilterQuality::None
         }
     }
+
+    /// Returns the paint for writing, copying it first if a saved state still shares it.
+    pub(crate) fn paint_mut(&mut self) -> &mut Paint {
+        Arc::make_mut(&mut self.paint)
+    }
+
+    /// Syncs the paint with the image smoothing settings, leaving a shared paint untouched when
+    /// they already match.
+    pub(crate) fn sync_image_smoothing_quality(&mut self) {
+        let quality = self.image_filter_quality();
+        if self.paint.image_smoothing_quality() != quality {
+            self.paint_mut().image_smoothing_quality_set(quality);
+        }
+    }
     pub fn from_device(device: Device, direction: TextDirection) -> Self {
         let font = Font::new("10px sans-serif", device);
         let mut paint = Paint::default();
@@ -112,7 +135,7 @@ impl State {
             .set_stroke_miter(10.);
         Self {
             direction,
-            paint,
+            paint: Arc::new(paint),
             font,
             text_align: TextAlign::default(),
             text_baseline: TextBaseLine::default(),
@@ -125,7 +148,7 @@ impl State {
             line_cap: LineCap::default(),
             line_join: LineJoin::default(),
             miter_limit: 10.0,
-            line_dash_list: Default::default(),
+            line_dash_list: Vec::new().into(),
             line_dash_offset: 0.0,
             filter: "none".into(),
             global_alpha: 1.0,
@@ -143,23 +166,24 @@ pub struct Context {
     pub(crate) device: Device,
     pub(crate) font_color: Color,
     pub(crate) enable_scaling: bool,
+    pub(crate) text_cache: TextBlobCache,
+    pub(crate) paragraph_cache: ParagraphCache,
+    _handle: Handle,
 }
 
 impl Context {
-    pub(crate) fn new(surface: Surface,
-                      path: Path,
-                      state: State,
-                      state_stack: Vec<State>,
-                      device: Device,
-                      font_color: Color) -> Self {
+    pub(crate) fn new(surface: Surface, device: Device, direction: TextDirection, font_color: Color) -> Self {
         Self {
             surface,
-            path,
-            state,
-            state_stack,
+            path: Path::default(),
+            state: State::from_device(device, direction),
+            state_stack: vec![],
             device,
             font_color,
             enable_scaling: false,
+            text_cache: TextBlobCache::default(),
+            paragraph_cache: ParagraphCache::default(),
+            _handle: Handle::new(),
         }
     }
 
@@ -178,6 +202,7 @@ impl Context {
     }
 
     pub fn flush(&mut self) {
+        profile_scope!("context.flush");
         self.surface.flush_and_submit();
     }
 
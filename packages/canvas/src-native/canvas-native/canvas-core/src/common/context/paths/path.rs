@@ -5,11 +5,22 @@ use skia_safe::{Point, Rect, RRect};
 use crate::common::context::drawing_paths::fill_rule::FillRule;
 
 use crate::common::context::matrix::Matrix;
+use crate::common::stats::{self, Counter, Handle};
 use crate::common::utils::geometry::{almost_equal, to_degrees};
 
-#[derive(Clone)]
 pub struct Path {
     pub(crate) path: skia_safe::Path,
+    _handle: Handle,
+}
+
+impl Clone for Path {
+    fn clone(&self) -> Self {
+        stats::increment(Counter::PathClones);
+        Self {
+            path: self.path.clone(),
+            _handle: Handle::new(),
+        }
+    }
 }
 
 impl Default for Path {
@@ -26,29 +37,36 @@ impl Path {
     pub fn make_scale(&mut self, (sx, sy): (f32, f32)) -> Self {
         Self {
             path: self.path.make_scale((sx, sy)),
+            _handle: Handle::new(),
         }
     }
 
     pub fn with_transform(&self, matrix: &skia_safe::Matrix) -> Path {
         Self {
             path: self.path.with_transform(matrix),
+            _handle: Handle::new(),
         }
     }
 
     pub fn new() -> Self {
         Self {
             path: skia_safe::Path::default(),
+            _handle: Handle::new(),
         }
     }
 
     pub fn from_str(val: &str) -> Self {
         Self {
             path: skia_safe::Path::from_svg(val).unwrap_or(skia_safe::Path::default()),
+            _handle: Handle::new(),
         }
     }
 
     pub fn from_path(path: &skia_safe::Path) -> Self {
-        Self { path: path.clone() }
+        Self {
+            path: path.clone(),
+            _handle: Handle::new(),
+        }
     }
 
     fn init(&mut self, _x: f32, _y: f32) {
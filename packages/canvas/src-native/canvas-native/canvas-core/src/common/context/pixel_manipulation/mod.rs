@@ -4,6 +4,8 @@ use skia_safe::{AlphaType, ColorType, ImageInfo, IPoint, ISize, IVector, Rect};
 
 use crate::common::context::Context;
 use crate::common::context::pixel_manipulation::image_data::ImageData;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 pub mod image_data;
 
@@ -19,6 +21,7 @@ impl Context {
         sw: c_float,
         sh: c_float,
     ) -> ImageData {
+        profile_scope!("context.get_image_data");
         let info = ImageInfo::new(
             ISize::new(sw as i32, sh as i32),
             ColorType::RGBA8888,
@@ -27,6 +30,7 @@ impl Context {
         );
         let row_bytes = info.width() * 4;
         let mut slice = vec![255u8; (row_bytes * info.height()) as usize];
+        stats::add(Counter::BytesReadBack, slice.len() as u64);
         let _ = self.surface.canvas().read_pixels(
             &info,
             slice.as_mut_slice(),
@@ -48,6 +52,8 @@ impl Context {
         sw: c_float,
         sh: c_float,
     ) {
+        profile_scope!("context.put_image_data");
+        stats::increment(Counter::DrawOther);
         let mut dx = dx;
         let mut dy = dy;
         let mut sx = sx;
@@ -95,6 +101,7 @@ impl Context {
 
             row_bytes = (sw * 4.0) as usize;
         }
+        stats::add(Counter::BytesUploaded, (row_bytes * info.height() as usize) as u64);
         let _ = self.surface.canvas().write_pixels(
             &info,
             &data.data(),
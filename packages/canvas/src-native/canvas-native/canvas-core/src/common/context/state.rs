@@ -1,13 +1,16 @@
 use crate::common::context::Context;
+use crate::common::stats::{self, Counter};
 
 impl Context {
     pub fn save(&mut self) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().save();
         let stack = self.state.clone();
         self.state_stack.push(stack);
     }
 
     pub fn restore(&mut self) {
+        stats::increment(Counter::StateChanges);
         if let Some(state) = self.state_stack.pop() {
             self.surface.canvas().restore();
             self.state = state;
@@ -4,6 +4,7 @@ use std::os::raw::c_float;
 use skia_safe::{M44, Matrix, Point};
 
 use crate::common::context::Context;
+use crate::common::stats::{self, Counter};
 
 impl Context {
     pub fn get_transform(&mut self) -> Matrix {
@@ -11,14 +12,17 @@ impl Context {
     }
 
     pub fn rotate(&mut self, angle: c_float) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().rotate(angle * (180.0 / PI), None);
     }
 
     pub fn scale(&mut self, x: c_float, y: c_float) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().scale((x, y));
     }
 
     pub fn translate(&mut self, x: c_float, y: c_float) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().translate(Point::new(x, y));
     }
 
@@ -31,12 +35,14 @@ impl Context {
         e: c_float,
         f: c_float,
     ) {
+        stats::increment(Counter::StateChanges);
         let affine = [a, b, c, d, e, f];
         let transform = Matrix::from_affine(&affine);
         self.surface.canvas().concat(&transform);
     }
 
     pub fn transform_with_matrix(&mut self, matrix: &Matrix) {
+        stats::increment(Counter::StateChanges);
         let mut current = self.surface.canvas().local_to_device_as_3x3();
         current.pre_concat(matrix);
         let m = M44::from(&current);
@@ -52,6 +58,7 @@ impl Context {
         e: c_float,
         f: c_float,
     ) {
+        stats::increment(Counter::StateChanges);
         let affine = [a, b, c, d, e, f];
         let matrix = Matrix::from_affine(&affine);
         let m44 = M44::from(matrix);
@@ -59,6 +66,7 @@ impl Context {
     }
 
     pub fn set_transform_matrix(&mut self, matrix: &Matrix) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().reset_matrix();
         let matrix = matrix.clone();
         let m44 = M44::from(matrix);
@@ -66,6 +74,7 @@ impl Context {
     }
 
     pub fn reset_transform(&mut self) {
+        stats::increment(Counter::StateChanges);
         self.surface.canvas().reset_matrix();
     }
 }
@@ -5,15 +5,20 @@ use skia_safe::image::CachingHint;
 
 use crate::common::context::Context;
 use crate::common::context::filter_quality::FilterQuality;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 pub mod context;
 pub mod ffi;
 pub mod image_bitmap;
 pub mod prelude;
+pub(crate) mod profiler;
+pub mod stats;
 pub(crate) mod svg;
 pub(crate) mod utils;
 
 pub(crate) fn image_to_data_url(image: Option<&Image>, format: &str, quality: c_int) -> String {
+    profile_scope!("image.encode");
     let mut encoded_prefix = String::new();
     encoded_prefix.push_str("data:");
     encoded_prefix.push_str(format);
@@ -77,6 +82,7 @@ pub(crate) fn to_data(context: &mut Context) -> Vec<u8> {
     );
     let row_bytes = info.width() * 4;
     let mut pixels = vec![255u8; (row_bytes * info.height()) as usize];
+    stats::add(Counter::BytesReadBack, pixels.len() as u64);
     let _read = image.read_pixels(
         &mut info,
         pixels.as_mut_slice(),
@@ -88,6 +94,7 @@ pub(crate) fn to_data(context: &mut Context) -> Vec<u8> {
 }
 
 pub(crate) fn flush_custom_surface(context: *mut Context, width: i32, height: i32, dst: &mut [u8]) {
+    profile_scope!("context.flush_custom_surface");
     unsafe {
         let context = &mut *context;
         context.surface.flush();
@@ -110,6 +117,7 @@ pub(crate) fn flush_custom_surface(context: *mut Context, width: i32, height: i3
 }
 
 pub(crate) fn snapshot_canvas(context: *mut Context) -> Option<Vec<u8>> {
+    profile_scope!("context.snapshot");
     unsafe {
         if context.is_null() {
             return None;
@@ -126,6 +134,7 @@ pub(crate) fn snapshot_canvas(context: *mut Context) -> Option<Vec<u8>> {
 }
 
 pub(crate) fn snapshot_canvas_raw(context: *mut Context) -> Vec<u8> {
+    profile_scope!("context.snapshot");
     unsafe {
         let context = &mut *context;
         let surface = &mut context.surface;
@@ -137,6 +146,7 @@ pub(crate) fn snapshot_canvas_raw(context: *mut Context) -> Vec<u8> {
         );
         let len: usize = info.min_row_bytes() * (info.height() as usize);
         let mut bytes = vec![0u8; len];
+        stats::add(Counter::BytesReadBack, len as u64);
         let mut dst_surface =
             Surface::new_raster_direct(&info, bytes.as_mut_slice(), None, None).unwrap();
         let dst_canvas = dst_surface.canvas();
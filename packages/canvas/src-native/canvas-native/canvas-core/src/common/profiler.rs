@@ -0,0 +1,312 @@
+//! Scoped timings of the hot paths, dumped as Chrome `trace_event` JSON for chrome://tracing or
+//! Perfetto.
+//!
+//! Only built with the `profiler` cargo feature, without it `profile_scope!` expands to nothing
+//! and the functions below are empty. With it, recording still has to be turned on at runtime
+//! with `set_enabled`, scopes only check a flag until then.
+
+/// Times the rest of the enclosing block as `name`.
+macro_rules! profile_scope {
+    ($name:expr) => {
+        #[cfg(feature = "profiler")]
+        let _profile_scope = $crate::common::profiler::Scope::new($name);
+    };
+}
+
+pub(crate) use profile_scope;
+
+#[cfg(feature = "profiler")]
+pub(crate) use imp::{Scope, clear, dump, record, set_enabled};
+
+#[cfg(not(feature = "profiler"))]
+pub(crate) fn set_enabled(_enabled: bool) -> bool {
+    false
+}
+
+#[cfg(not(feature = "profiler"))]
+pub(crate) fn record(_name: &str, _duration_ns: u64) {}
+
+#[cfg(not(feature = "profiler"))]
+pub(crate) fn clear() {}
+
+#[cfg(not(feature = "profiler"))]
+pub(crate) fn dump() -> String {
+    String::from("{\"traceEvents\":[]}")
+}
+
+#[cfg(feature = "profiler")]
+mod imp {
+    use std::collections::HashMap;
+    use std::fmt::Write;
+    use std::sync::atomic::{fence, AtomicBool, AtomicU64, AtomicUsize, Ordering};
+    use std::sync::Arc;
+    use std::time::Instant;
+
+    use lazy_static::lazy_static;
+    use parking_lot::Mutex;
+
+    // events kept per thread, older ones are overwritten
+    const CAPACITY: usize = 4096;
+
+    // buffers of exited threads kept for the next dump, pool threads come and go
+    const MAX_EXITED_THREADS: usize = 8;
+
+    static ENABLED: AtomicBool = AtomicBool::new(false);
+    static NEXT_TID: AtomicU64 = AtomicU64::new(1);
+
+    lazy_static! {
+        static ref EPOCH: Instant = Instant::now();
+        static ref THREADS: Mutex<Vec<Arc<ThreadBuffer>>> = Mutex::new(Vec::new());
+        // names recorded from the platforms aren't 'static, each distinct one is leaked once
+        static ref NAMES: Mutex<HashMap<String, &'static str>> = Mutex::new(HashMap::new());
+    }
+
+    thread_local! {
+        static BUFFER: ThreadHandle = ThreadHandle::register();
+    }
+
+    fn now() -> u64 {
+        EPOCH.elapsed().as_nanos() as u64
+    }
+
+    /// One event, written by its thread as a seqlock: `seq` is odd while the slot is written and
+    /// `2 * index + 2` once event `index` is complete, so a dump skips slots being overwritten.
+    struct Slot {
+        seq: AtomicU64,
+        name_ptr: AtomicUsize,
+        name_len: AtomicUsize,
+        start: AtomicU64,
+        duration: AtomicU64,
+    }
+
+    impl Slot {
+        fn new() -> Self {
+            Self {
+                seq: AtomicU64::new(0),
+                name_ptr: AtomicUsize::new(0),
+                name_len: AtomicUsize::new(0),
+                start: AtomicU64::new(0),
+                duration: AtomicU64::new(0),
+            }
+        }
+    }
+
+    /// Ring of the events of one thread. Only that thread writes, dumps read it without locking.
+    struct ThreadBuffer {
+        tid: u64,
+        name: String,
+        slots: Box<[Slot]>,
+        head: AtomicU64,
+        exited: AtomicBool,
+    }
+
+    impl ThreadBuffer {
+        fn push(&self, name: &'static str, start: u64, duration: u64) {
+            let index = self.head.load(Ordering::Relaxed);
+            let slot = &self.slots[index as usize % CAPACITY];
+            slot.seq.store(index * 2 + 1, Ordering::Relaxed);
+            fence(Ordering::Release);
+            slot.name_ptr.store(name.as_ptr() as usize, Ordering::Relaxed);
+            slot.name_len.store(name.len(), Ordering::Relaxed);
+            slot.start.store(start, Ordering::Relaxed);
+            slot.duration.store(duration, Ordering::Relaxed);
+            slot.seq.store(index * 2 + 2, Ordering::Release);
+            self.head.store(index + 1, Ordering::Release);
+        }
+
+        fn read(&self, index: u64) -> Option<(&'static str, u64, u64)> {
+            let slot = &self.slots[index as usize % CAPACITY];
+            let seq = slot.seq.load(Ordering::Acquire);
+            if seq != index * 2 + 2 {
+                return None;
+            }
+            let ptr = slot.name_ptr.load(Ordering::Relaxed);
+            let len = slot.name_len.load(Ordering::Relaxed);
+            let start = slot.start.load(Ordering::Relaxed);
+            let duration = slot.duration.load(Ordering::Relaxed);
+            fence(Ordering::Acquire);
+            if slot.seq.load(Ordering::Relaxed) != seq {
+                return None;
+            }
+            // only 'static names are pushed
+            let name = unsafe {
+                std::str::from_utf8_unchecked(std::slice::from_raw_parts(ptr as *const u8, len))
+            };
+            Some((name, start, duration))
+        }
+    }
+
+    struct ThreadHandle(Arc<ThreadBuffer>);
+
+    impl ThreadHandle {
+        fn register() -> Self {
+            let current = std::thread::current();
+            let tid = NEXT_TID.fetch_add(1, Ordering::Relaxed);
+            let buffer = Arc::new(ThreadBuffer {
+                tid,
+                name: current
+                    .name()
+                    .map(String::from)
+                    .unwrap_or_else(|| format!("thread-{}", tid)),
+                slots: (0..CAPACITY).map(|_| Slot::new()).collect(),
+                head: AtomicU64::new(0),
+                exited: AtomicBool::new(false),
+            });
+            let mut threads = THREADS.lock();
+            let exited = threads
+                .iter()
+                .filter(|buffer| buffer.exited.load(Ordering::Relaxed))
+                .count();
+            if exited > MAX_EXITED_THREADS {
+                let mut to_drop = exited - MAX_EXITED_THREADS;
+                threads.retain(|buffer| {
+                    if to_drop > 0 && buffer.exited.load(Ordering::Relaxed) {
+                        to_drop -= 1;
+                        false
+                    } else {
+                        true
+                    }
+                });
+            }
+            threads.push(Arc::clone(&buffer));
+            Self(buffer)
+        }
+    }
+
+    impl Drop for ThreadHandle {
+        fn drop(&mut self) {
+            self.0.exited.store(true, Ordering::Relaxed);
+        }
+    }
+
+    fn push(name: &'static str, start: u64, duration: u64) {
+        // try_with, the thread local may already be gone while a thread exits
+        let _ = BUFFER.try_with(|handle| handle.0.push(name, start, duration));
+    }
+
+    pub(crate) struct Scope {
+        name: &'static str,
+        start: u64,
+    }
+
+    impl Scope {
+        #[inline]
+        pub fn new(name: &'static str) -> Self {
+            let start = if ENABLED.load(Ordering::Relaxed) {
+                now()
+            } else {
+                0
+            };
+            Self { name, start }
+        }
+    }
+
+    impl Drop for Scope {
+        #[inline]
+        fn drop(&mut self) {
+            if self.start != 0 {
+                let end = now();
+                push(self.name, self.start, end - self.start);
+            }
+        }
+    }
+
+    /// Turns recording on or off, returns whether it is on.
+    pub(crate) fn set_enabled(enabled: bool) -> bool {
+        // the epoch is taken now so the first scope doesn't pay for it
+        lazy_static::initialize(&EPOCH);
+        ENABLED.store(enabled, Ordering::Relaxed);
+        enabled
+    }
+
+    /// Records an event named `name` that took `duration_ns` and ended now, for timings taken on
+    /// the platform side such as waits on the GL thread.
+    pub(crate) fn record(name: &str, duration_ns: u64) {
+        if !ENABLED.load(Ordering::Relaxed) {
+            return;
+        }
+        let end = now();
+        let name = {
+            let mut names = NAMES.lock();
+            match names.get(name) {
+                Some(name) => *name,
+                None => {
+                    let leaked: &'static str = Box::leak(name.to_string().into_boxed_str());
+                    names.insert(name.to_string(), leaked);
+                    leaked
+                }
+            }
+        };
+        let start = end.saturating_sub(duration_ns);
+        push(name, start, end - start);
+    }
+
+    /// Drops the recorded events, buffers of threads that are still running are kept.
+    pub(crate) fn clear() {
+        let mut threads = THREADS.lock();
+        threads.retain(|buffer| !buffer.exited.load(Ordering::Relaxed));
+        for buffer in threads.iter() {
+            // events before the current head are skipped from now on
+            let head = buffer.head.load(Ordering::Acquire);
+            for index in head.saturating_sub(CAPACITY as u64)..head {
+                let slot = &buffer.slots[index as usize % CAPACITY];
+                let _ = slot
+                    .seq
+                    .compare_exchange(index * 2 + 2, 0, Ordering::Relaxed, Ordering::Relaxed);
+            }
+        }
+    }
+
+    fn write_escaped(out: &mut String, value: &str) {
+        for c in value.chars() {
+            match c {
+                '"' => out.push_str("\\\""),
+                '\\' => out.push_str("\\\\"),
+                c if (c as u32) < 0x20 => {
+                    let _ = write!(out, "\\u{:04x}", c as u32);
+                }
+                c => out.push(c),
+            }
+        }
+    }
+
+    /// The recorded events of every thread as a Chrome `trace_event` JSON object.
+    pub(crate) fn dump() -> String {
+        let threads: Vec<Arc<ThreadBuffer>> = THREADS.lock().iter().cloned().collect();
+        let mut out = String::from("{\"traceEvents\":[");
+        let mut first = true;
+        for buffer in threads.iter() {
+            if !first {
+                out.push(',');
+            }
+            first = false;
+            let _ = write!(
+                out,
+                "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"",
+                buffer.tid
+            );
+            write_escaped(&mut out, &buffer.name);
+            out.push_str("\"}}");
+
+            let head = buffer.head.load(Ordering::Acquire);
+            for index in head.saturating_sub(CAPACITY as u64)..head {
+                if let Some((name, start, duration)) = buffer.read(index) {
+                    out.push_str(",{\"name\":\"");
+                    write_escaped(&mut out, name);
+                    // microseconds, with the nanoseconds as fraction
+                    let _ = write!(
+                        out,
+                        "\",\"cat\":\"canvas\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{}.{:03},\"dur\":{}.{:03}}}",
+                        buffer.tid,
+                        start / 1000,
+                        start % 1000,
+                        duration / 1000,
+                        duration % 1000
+                    );
+                }
+            }
+        }
+        out.push_str("],\"displayTimeUnit\":\"ms\"}");
+        out
+    }
+}
@@ -0,0 +1,260 @@
+//! Counters of the work done by the contexts, cheap enough to stay on in release builds: each one
+//! is a relaxed atomic add.
+//!
+//! Totals run since the last `reset`. `end_frame`, called once per frame by the platform's frame
+//! scheduler, also keeps what the frame that just ended added, which is what a regression in a
+//! frame's cost shows up in. `HandlesAlive` is a gauge rather than a count and reads the same in
+//! both.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
+
+#[repr(u32)]
+#[derive(Copy, Clone, Debug, PartialEq, Eq)]
+pub enum Counter {
+    DrawRect = 0,
+    DrawPath = 1,
+    DrawImage = 2,
+    DrawText = 3,
+    DrawOther = 4,
+    GlDrawArrays = 5,
+    GlDrawElements = 6,
+    StateChanges = 7,
+    PathClones = 8,
+    PaintClones = 9,
+    BytesUploaded = 10,
+    BytesReadBack = 11,
+    FontCacheHits = 12,
+    FontCacheMisses = 13,
+    TextCacheHits = 14,
+    TextCacheMisses = 15,
+    ShaderCacheHits = 16,
+    ShaderCacheMisses = 17,
+    ImageCacheHits = 18,
+    ImageCacheMisses = 19,
+    HandlesAlive = 20,
+    Frames = 21,
+}
+
+pub const COUNTER_COUNT: usize = 22;
+
+impl Counter {
+    pub fn from_u32(value: u32) -> Option<Self> {
+        use Counter::*;
+        const ALL: [Counter; COUNTER_COUNT] = [
+            DrawRect,
+            DrawPath,
+            DrawImage,
+            DrawText,
+            DrawOther,
+            GlDrawArrays,
+            GlDrawElements,
+            StateChanges,
+            PathClones,
+            PaintClones,
+            BytesUploaded,
+            BytesReadBack,
+            FontCacheHits,
+            FontCacheMisses,
+            TextCacheHits,
+            TextCacheMisses,
+            ShaderCacheHits,
+            ShaderCacheMisses,
+            ImageCacheHits,
+            ImageCacheMisses,
+            HandlesAlive,
+            Frames,
+        ];
+        ALL.get(value as usize).copied()
+    }
+}
+
+/// Every counter, in [`Counter`] order so the platforms can read it as an array of u64.
+#[repr(C)]
+#[derive(Copy, Clone, Debug, Default)]
+pub struct CanvasStats {
+    pub draw_rect: u64,
+    pub draw_path: u64,
+    pub draw_image: u64,
+    pub draw_text: u64,
+    pub draw_other: u64,
+    pub gl_draw_arrays: u64,
+    pub gl_draw_elements: u64,
+    pub state_changes: u64,
+    pub path_clones: u64,
+    pub paint_clones: u64,
+    pub bytes_uploaded: u64,
+    pub bytes_read_back: u64,
+    pub font_cache_hits: u64,
+    pub font_cache_misses: u64,
+    pub text_cache_hits: u64,
+    pub text_cache_misses: u64,
+    pub shader_cache_hits: u64,
+    pub shader_cache_misses: u64,
+    pub image_cache_hits: u64,
+    pub image_cache_misses: u64,
+    pub handles_alive: u64,
+    pub frames: u64,
+}
+
+impl CanvasStats {
+    fn from_values(values: &[u64; COUNTER_COUNT]) -> Self {
+        Self {
+            draw_rect: values[Counter::DrawRect as usize],
+            draw_path: values[Counter::DrawPath as usize],
+            draw_image: values[Counter::DrawImage as usize],
+            draw_text: values[Counter::DrawText as usize],
+            draw_other: values[Counter::DrawOther as usize],
+            gl_draw_arrays: values[Counter::GlDrawArrays as usize],
+            gl_draw_elements: values[Counter::GlDrawElements as usize],
+            state_changes: values[Counter::StateChanges as usize],
+            path_clones: values[Counter::PathClones as usize],
+            paint_clones: values[Counter::PaintClones as usize],
+            bytes_uploaded: values[Counter::BytesUploaded as usize],
+            bytes_read_back: values[Counter::BytesReadBack as usize],
+            font_cache_hits: values[Counter::FontCacheHits as usize],
+            font_cache_misses: values[Counter::FontCacheMisses as usize],
+            text_cache_hits: values[Counter::TextCacheHits as usize],
+            text_cache_misses: values[Counter::TextCacheMisses as usize],
+            shader_cache_hits: values[Counter::ShaderCacheHits as usize],
+            shader_cache_misses: values[Counter::ShaderCacheMisses as usize],
+            image_cache_hits: values[Counter::ImageCacheHits as usize],
+            image_cache_misses: values[Counter::ImageCacheMisses as usize],
+            handles_alive: values[Counter::HandlesAlive as usize],
+            frames: values[Counter::Frames as usize],
+        }
+    }
+
+    pub fn to_array(&self) -> [u64; COUNTER_COUNT] {
+        [
+            self.draw_rect,
+            self.draw_path,
+            self.draw_image,
+            self.draw_text,
+            self.draw_other,
+            self.gl_draw_arrays,
+            self.gl_draw_elements,
+            self.state_changes,
+            self.path_clones,
+            self.paint_clones,
+            self.bytes_uploaded,
+            self.bytes_read_back,
+            self.font_cache_hits,
+            self.font_cache_misses,
+            self.text_cache_hits,
+            self.text_cache_misses,
+            self.shader_cache_hits,
+            self.shader_cache_misses,
+            self.image_cache_hits,
+            self.image_cache_misses,
+            self.handles_alive,
+            self.frames,
+        ]
+    }
+}
+
+#[allow(clippy::declare_interior_mutable_const)]
+const ZERO: AtomicU64 = AtomicU64::new(0);
+
+static TOTALS: [AtomicU64; COUNTER_COUNT] = [ZERO; COUNTER_COUNT];
+
+struct Frames {
+    /// Totals when the current frame started.
+    start: [u64; COUNTER_COUNT],
+    last: [u64; COUNTER_COUNT],
+}
+
+lazy_static! {
+    static ref FRAMES: Mutex<Frames> = Mutex::new(Frames {
+        start: [0; COUNTER_COUNT],
+        last: [0; COUNTER_COUNT],
+    });
+}
+
+#[inline]
+pub(crate) fn add(counter: Counter, value: u64) {
+    TOTALS[counter as usize].fetch_add(value, Ordering::Relaxed);
+}
+
+#[inline]
+pub(crate) fn increment(counter: Counter) {
+    add(counter, 1);
+}
+
+#[inline]
+fn decrement(counter: Counter) {
+    TOTALS[counter as usize].fetch_sub(1, Ordering::Relaxed);
+}
+
+fn totals() -> [u64; COUNTER_COUNT] {
+    let mut values = [0; COUNTER_COUNT];
+    for (value, total) in values.iter_mut().zip(TOTALS.iter()) {
+        *value = total.load(Ordering::Relaxed);
+    }
+    values
+}
+
+/// The totals, or what the last ended frame added when `last_frame` is set.
+pub fn get_stats(last_frame: bool) -> CanvasStats {
+    if last_frame {
+        CanvasStats::from_values(&FRAMES.lock().last)
+    } else {
+        CanvasStats::from_values(&totals())
+    }
+}
+
+pub fn end_frame() {
+    increment(Counter::Frames);
+    let totals = totals();
+    let mut frames = FRAMES.lock();
+    for index in 0..COUNTER_COUNT {
+        frames.last[index] = totals[index].wrapping_sub(frames.start[index]);
+    }
+    frames.start = totals;
+    let alive = Counter::HandlesAlive as usize;
+    frames.last[alive] = totals[alive];
+}
+
+/// Zeroes every counter but `HandlesAlive`, handles created before the reset are still alive.
+pub fn reset() {
+    let mut frames = FRAMES.lock();
+    for (index, total) in TOTALS.iter().enumerate() {
+        if index != Counter::HandlesAlive as usize {
+            total.store(0, Ordering::Relaxed);
+        }
+    }
+    let alive = TOTALS[Counter::HandlesAlive as usize].load(Ordering::Relaxed);
+    frames.start = [0; COUNTER_COUNT];
+    frames.start[Counter::HandlesAlive as usize] = alive;
+    frames.last = [0; COUNTER_COUNT];
+}
+
+/// Counts its owner in `HandlesAlive` for as long as it lives, clones included.
+pub(crate) struct Handle(());
+
+impl Handle {
+    pub(crate) fn new() -> Self {
+        increment(Counter::HandlesAlive);
+        Self(())
+    }
+}
+
+impl Default for Handle {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl Clone for Handle {
+    fn clone(&self) -> Self {
+        Self::new()
+    }
+}
+
+impl Drop for Handle {
+    fn drop(&mut self) {
+        decrement(Counter::HandlesAlive);
+    }
+}
@@ -0,0 +1,245 @@
+use std::collections::HashMap;
+
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
+use skia_safe::canvas::SaveLayerRec;
+use skia_safe::{color_filters, BlendMode, Canvas, ClipOp, Color, IRect, Image, Paint, Rect, Size, Surface};
+
+use crate::common::context::Context;
+use crate::common::svg::cache::{self, SvgKey};
+use crate::common::svg::cancel::Cancellation;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
+
+const PAGE_SIZE: i32 = 1024;
+
+// pages kept before the atlas starts over, each is PAGE_SIZE² * 4 bytes
+const MAX_PAGES: usize = 4;
+
+// transparent border around every sprite so filtering doesn't pick up its neighbours
+const PADDING: i32 = 1;
+
+lazy_static! {
+    /// Rasterized svgs shared by every context, icons drawn at fixed sizes end up on a few pages.
+    static ref SVG_ATLAS: Mutex<SvgAtlas> = Mutex::new(SvgAtlas::new());
+}
+
+#[derive(Clone, PartialEq, Eq, Hash)]
+struct SpriteKey {
+    svg: SvgKey,
+    // in pixels, the requested size times the density
+    width: i32,
+    height: i32,
+    tint: u32,
+}
+
+struct Shelf {
+    y: i32,
+    height: i32,
+    x: i32,
+}
+
+struct Page {
+    surface: Surface,
+    shelves: Vec<Shelf>,
+    bottom: i32,
+    // snapshot drawn from, dropped whenever a sprite is added
+    image: Option<Image>,
+}
+
+unsafe impl Send for Page {}
+
+impl Page {
+    fn new() -> Option<Self> {
+        let surface = Surface::new_raster_n32_premul((PAGE_SIZE, PAGE_SIZE))?;
+        Some(Self {
+            surface,
+            shelves: Vec::new(),
+            bottom: 0,
+            image: None,
+        })
+    }
+
+    /// Shelf packing: a sprite goes on the lowest shelf it fits that isn't much taller than it,
+    /// otherwise a new shelf is opened below the others.
+    fn allocate(&mut self, width: i32, height: i32) -> Option<IRect> {
+        let padded_width = width + PADDING * 2;
+        let padded_height = height + PADDING * 2;
+        let mut best: Option<usize> = None;
+        for (index, shelf) in self.shelves.iter().enumerate() {
+            if shelf.height >= padded_height
+                && shelf.height <= padded_height + padded_height / 2
+                && shelf.x + padded_width <= PAGE_SIZE
+                && best.map_or(true, |best| self.shelves[best].height > shelf.height)
+            {
+                best = Some(index);
+            }
+        }
+        let index = match best {
+            Some(index) => index,
+            None => {
+                if self.bottom + padded_height > PAGE_SIZE {
+                    return None;
+                }
+                self.shelves.push(Shelf {
+                    y: self.bottom,
+                    height: padded_height,
+                    x: 0,
+                });
+                self.bottom += padded_height;
+                self.shelves.len() - 1
+            }
+        };
+        let shelf = &mut self.shelves[index];
+        let rect = IRect::from_xywh(shelf.x + PADDING, shelf.y + PADDING, width, height);
+        shelf.x += padded_width;
+        Some(rect)
+    }
+
+    fn image(&mut self) -> Image {
+        if self.image.is_none() {
+            self.image = Some(self.surface.image_snapshot());
+        }
+        self.image.clone().unwrap()
+    }
+}
+
+struct SvgAtlas {
+    pages: Vec<Page>,
+    sprites: HashMap<SpriteKey, (usize, IRect)>,
+}
+
+impl SvgAtlas {
+    fn new() -> Self {
+        Self {
+            pages: Vec::new(),
+            sprites: HashMap::new(),
+        }
+    }
+
+    /// The page image and source rect of `key`, rasterizing it on first use.
+    fn sprite(&mut self, key: SpriteKey, svg: &str) -> Option<(Image, IRect)> {
+        profile_scope!("svg.atlas_sprite");
+        if let Some(&(page, rect)) = self.sprites.get(&key) {
+            stats::increment(Counter::ImageCacheHits);
+            return Some((self.pages[page].image(), rect));
+        }
+        stats::increment(Counter::ImageCacheMisses);
+        if key.width <= 0
+            || key.height <= 0
+            || key.width > PAGE_SIZE - PADDING * 2
+            || key.height > PAGE_SIZE - PADDING * 2
+        {
+            return None;
+        }
+        let (page, rect) = self.allocate(key.width, key.height)?;
+        let drawn = {
+            let canvas = self.pages[page].surface.canvas();
+            canvas.save();
+            canvas.clip_rect(Rect::from_irect(rect), ClipOp::Intersect, false);
+            canvas.translate((rect.left as f32, rect.top as f32));
+            let drawn = render(
+                canvas,
+                Size::new(key.width as f32, key.height as f32),
+                key.svg.clone(),
+                svg,
+                key.tint,
+            );
+            canvas.restore();
+            drawn
+        };
+        if !drawn {
+            // the space stays unused until the atlas starts over
+            return None;
+        }
+        let page_entry = &mut self.pages[page];
+        page_entry.image = None;
+        let image = page_entry.image();
+        self.sprites.insert(key, (page, rect));
+        Some((image, rect))
+    }
+
+    fn allocate(&mut self, width: i32, height: i32) -> Option<(usize, IRect)> {
+        for (index, page) in self.pages.iter_mut().enumerate() {
+            if let Some(rect) = page.allocate(width, height) {
+                return Some((index, rect));
+            }
+        }
+        if self.pages.len() >= MAX_PAGES {
+            // simpler than tracking which sprites are still in use, they are rasterized again
+            // from the svg cache
+            self.pages.clear();
+            self.sprites.clear();
+        }
+        let mut page = Page::new()?;
+        let rect = page.allocate(width, height)?;
+        self.pages.push(page);
+        Some((self.pages.len() - 1, rect))
+    }
+}
+
+// draws svg scaled to size, tint replaces the color of every drawn pixel keeping its alpha
+fn render(canvas: &mut Canvas, size: Size, key: SvgKey, svg: &str, tint: u32) -> bool {
+    let tinted = tint != 0;
+    if tinted {
+        let mut paint = Paint::default();
+        paint.set_color_filter(color_filters::blend(Color::new(tint), BlendMode::SrcIn));
+        canvas.save_layer(&SaveLayerRec::default().paint(&paint));
+    }
+    let drawn = cache::draw_cached(
+        canvas,
+        size,
+        key,
+        || match skia_safe::svg::Dom::from_bytes(svg.as_bytes()) {
+            Ok(svg) => Some(svg),
+            Err(e) => {
+                log::debug!("svg read to string error: {}", e);
+                None
+            }
+        },
+        &Cancellation::none(),
+    );
+    if tinted {
+        canvas.restore();
+    }
+    drawn
+}
+
+/// Draws `svg` at `x`, `y` scaled to `width` x `height` from a shared atlas page. The svg is
+/// rasterized once per size, density and `tint` (ARGB, 0 for none), repeated draws of the same
+/// icons then all sample the same few page images.
+/// Sprites too large for a page are drawn directly.
+pub(crate) fn draw_svg_sprite(
+    context: &mut Context,
+    svg: &str,
+    x: f32,
+    y: f32,
+    width: f32,
+    height: f32,
+    tint: u32,
+) {
+    let density = context.device.density.max(1.0);
+    let key = SpriteKey {
+        svg: SvgKey::content(svg),
+        width: (width * density).ceil() as i32,
+        height: (height * density).ceil() as i32,
+        tint,
+    };
+    let sprite = SVG_ATLAS.lock().sprite(key.clone(), svg);
+    match sprite {
+        Some((image, rect)) => {
+            context.draw_image(
+                &image,
+                Rect::from_irect(rect),
+                Rect::from_xywh(x, y, width, height),
+            );
+        }
+        None => {
+            let canvas = context.surface.canvas();
+            canvas.save();
+            canvas.translate((x, y));
+            render(canvas, Size::new(width, height), key.svg, svg, tint);
+            canvas.restore();
+        }
+    }
+}
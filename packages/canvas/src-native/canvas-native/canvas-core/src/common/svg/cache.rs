@@ -0,0 +1,233 @@
+use std::collections::hash_map::DefaultHasher;
+use std::hash::{Hash, Hasher};
+use std::sync::Arc;
+use std::time::SystemTime;
+
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
+use skia_safe::{Canvas, Picture, PictureRecorder, Rect, Size};
+
+use crate::common::svg::cancel::Cancellation;
+use crate::common::utils::lru_cache::LruCache;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
+
+const DEFAULT_BUDGET: usize = 8 * 1024 * 1024;
+
+// rough size of a parsed dom relative to its source
+const DOM_BYTES_PER_SOURCE_BYTE: usize = 4;
+
+// bounds the eviction scan, the byte budget is usually reached first
+const MAX_SVGS: usize = 512;
+
+// container sizes recorded per svg, e.g. the same icon at a couple of sizes
+const PICTURES_PER_SVG: usize = 4;
+
+lazy_static! {
+    /// Parsed svgs shared by every context, the same icons tend to be drawn by many views.
+    static ref SVG_CACHE: Mutex<SvgCache> = Mutex::new(SvgCache::new(DEFAULT_BUDGET));
+}
+
+#[derive(Clone, PartialEq, Eq, Hash)]
+pub(crate) enum SvgKey {
+    Content { hash: u64, len: usize },
+    File { path: String, modified: Option<SystemTime>, len: u64 },
+}
+
+impl SvgKey {
+    pub fn content(svg: &str) -> Self {
+        let mut hasher = DefaultHasher::new();
+        svg.hash(&mut hasher);
+        SvgKey::Content {
+            hash: hasher.finish(),
+            len: svg.len(),
+        }
+    }
+
+    /// Keyed by modification time as well, so an updated file is parsed again.
+    pub fn file(path: &str) -> std::io::Result<Self> {
+        let metadata = std::fs::metadata(path)?;
+        Ok(SvgKey::File {
+            path: path.to_string(),
+            modified: metadata.modified().ok(),
+            len: metadata.len(),
+        })
+    }
+
+    fn source_len(&self) -> usize {
+        match self {
+            SvgKey::Content { len, .. } => *len,
+            SvgKey::File { len, .. } => *len as usize,
+        }
+    }
+}
+
+struct CachedSvg {
+    dom: skia_safe::svg::Dom,
+    // recorded at (width, height), oldest first
+    pictures: Vec<((u32, u32), Picture)>,
+}
+
+unsafe impl Send for CachedSvg {}
+
+impl CachedSvg {
+    /// The picture for `size`, recording it when missing. Also returns the change in bytes used.
+    fn picture(&mut self, size: Size) -> Option<(Picture, isize)> {
+        profile_scope!("svg.record");
+        let key = (size.width as u32, size.height as u32);
+        if let Some((_, picture)) = self.pictures.iter().find(|(recorded, _)| *recorded == key) {
+            return Some((picture.clone(), 0));
+        }
+        self.dom.set_container_size(size);
+        let mut recorder = PictureRecorder::new();
+        let canvas = recorder.begin_recording(Rect::from_size(size), None);
+        self.dom.render(canvas);
+        let picture = recorder.finish_recording_as_picture(None)?;
+        let mut delta = picture.approximate_bytes_used() as isize;
+        if self.pictures.len() >= PICTURES_PER_SVG {
+            let (_, oldest) = self.pictures.remove(0);
+            delta -= oldest.approximate_bytes_used() as isize;
+        }
+        self.pictures.push((key, picture.clone()));
+        Some((picture, delta))
+    }
+}
+
+struct CacheEntry {
+    svg: Arc<Mutex<CachedSvg>>,
+    bytes: usize,
+}
+
+/// Parsed svgs and the pictures recorded from them, evicting the least recently drawn once
+/// their estimated size exceeds the budget.
+struct SvgCache {
+    entries: LruCache<SvgKey, CacheEntry>,
+    bytes: usize,
+    budget: usize,
+}
+
+impl SvgCache {
+    fn new(budget: usize) -> Self {
+        Self {
+            entries: LruCache::new(MAX_SVGS),
+            bytes: 0,
+            budget,
+        }
+    }
+
+    fn insert(&mut self, key: SvgKey, svg: Arc<Mutex<CachedSvg>>) {
+        let bytes = key.source_len() * DOM_BYTES_PER_SOURCE_BYTE;
+        if let Some(previous) = self.entries.remove(&key) {
+            self.bytes -= previous.bytes;
+        }
+        if self.entries.len() >= MAX_SVGS {
+            if let Some(oldest) = self.entries.evict_oldest() {
+                self.bytes -= oldest.bytes;
+            }
+        }
+        self.entries.insert(key, CacheEntry { svg, bytes });
+        self.bytes += bytes;
+        self.trim();
+    }
+
+    fn grow(&mut self, key: &SvgKey, delta: isize) {
+        if let Some(entry) = self.entries.get_mut(key) {
+            let bytes = (entry.bytes as isize + delta).max(0) as usize;
+            self.bytes = self.bytes - entry.bytes + bytes;
+            entry.bytes = bytes;
+        }
+        self.trim();
+    }
+
+    fn trim(&mut self) {
+        while self.bytes > self.budget {
+            match self.entries.evict_oldest() {
+                Some(entry) => self.bytes -= entry.bytes,
+                None => break,
+            }
+        }
+    }
+}
+
+/// Draws the svg for `key` at `size`, parsing it with `load` only when it isn't cached.
+/// Returns false when `load` fails or the render was cancelled, in which case nothing was drawn.
+pub(crate) fn draw_cached<F>(
+    canvas: &mut Canvas,
+    size: Size,
+    key: SvgKey,
+    load: F,
+    cancellation: &Cancellation,
+) -> bool
+where
+    F: FnOnce() -> Option<skia_safe::svg::Dom>,
+{
+    let cached = {
+        let mut cache = SVG_CACHE.lock();
+        if cache.budget == 0 {
+            None
+        } else {
+            Some(cache.entries.get(&key).map(|entry| Arc::clone(&entry.svg)))
+        }
+    };
+    if cancellation.is_cancelled() {
+        return false;
+    }
+    let svg = match cached {
+        Some(Some(svg)) => {
+            stats::increment(Counter::ImageCacheHits);
+            svg
+        }
+        Some(None) => match load() {
+            Some(dom) => {
+                stats::increment(Counter::ImageCacheMisses);
+                let svg = Arc::new(Mutex::new(CachedSvg {
+                    dom,
+                    pictures: Vec::new(),
+                }));
+                SVG_CACHE.lock().insert(key.clone(), Arc::clone(&svg));
+                svg
+            }
+            None => return false,
+        },
+        // caching disabled
+        None => {
+            return match load() {
+                Some(mut dom) if !cancellation.is_cancelled() => {
+                    dom.set_container_size(size);
+                    dom.render(canvas);
+                    true
+                }
+                _ => false,
+            };
+        }
+    };
+    // parsing is usually the slow part, the parsed svg stays cached either way
+    if cancellation.is_cancelled() {
+        return false;
+    }
+    let recorded = svg.lock().picture(size);
+    match recorded {
+        Some((picture, delta)) => {
+            if delta != 0 {
+                SVG_CACHE.lock().grow(&key, delta);
+            }
+            if cancellation.is_cancelled() {
+                return false;
+            }
+            canvas.draw_picture(&picture, None, None);
+        }
+        None => {
+            let mut svg = svg.lock();
+            svg.dom.set_container_size(size);
+            svg.dom.render(canvas);
+        }
+    }
+    true
+}
+
+/// Bytes the cache may use, 0 disables caching and drops everything cached.
+pub(crate) fn set_budget(budget: usize) {
+    let mut cache = SVG_CACHE.lock();
+    cache.budget = budget;
+    cache.trim();
+}
@@ -0,0 +1,46 @@
+use std::sync::atomic::{AtomicU64, Ordering};
+
+/// Generation of the renders of one view. Starting a newer render cancels the one in progress at
+/// its next check, renders can't be interrupted inside skia.
+pub struct RenderToken(AtomicU64);
+
+impl RenderToken {
+    pub fn new() -> Self {
+        Self(AtomicU64::new(0))
+    }
+
+    /// Cancels the render in progress, called from any thread.
+    pub fn cancel(&self) {
+        self.0.fetch_add(1, Ordering::AcqRel);
+    }
+
+    pub fn start(&self) -> Cancellation<'_> {
+        Cancellation {
+            token: Some(self),
+            generation: self.0.load(Ordering::Acquire),
+        }
+    }
+}
+
+/// Checked by a render between its steps.
+pub struct Cancellation<'a> {
+    token: Option<&'a RenderToken>,
+    generation: u64,
+}
+
+impl Cancellation<'static> {
+    /// For renders nobody cancels.
+    pub fn none() -> Self {
+        Cancellation {
+            token: None,
+            generation: 0,
+        }
+    }
+}
+
+impl Cancellation<'_> {
+    pub fn is_cancelled(&self) -> bool {
+        self.token
+            .map_or(false, |token| token.0.load(Ordering::Acquire) != self.generation)
+    }
+}
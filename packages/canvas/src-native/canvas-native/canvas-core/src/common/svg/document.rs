@@ -0,0 +1,895 @@
+use std::collections::{HashMap, HashSet};
+
+use skia_safe::{Canvas, Picture, PictureRecorder, Rect, Size};
+
+use crate::common::svg::cancel::Cancellation;
+use crate::common::profiler::profile_scope;
+
+/// Index of a node in its document, stable while the node is attached. The slots of removed
+/// nodes are reused by later edits, so look nodes up again instead of keeping them.
+pub type NodeId = usize;
+
+// elements rendered in chunks of about this many nodes, an edit re-parses one chunk
+const CHUNK_NODES: usize = 128;
+
+// elements that draw nothing themselves but may be used from anywhere, part of every chunk
+const SHARED_ELEMENTS: [&str; 11] = [
+    "clipPath",
+    "defs",
+    "filter",
+    "linearGradient",
+    "marker",
+    "mask",
+    "pattern",
+    "radialGradient",
+    "style",
+    "symbol",
+    "title",
+];
+
+// group attributes that composite the group as a whole, such groups can't be split into chunks
+const COMPOSITING_ATTRIBUTES: [&str; 4] = ["opacity", "filter", "mask", "clip-path"];
+
+enum NodeKind {
+    Element {
+        name: String,
+        attributes: Vec<(String, String)>,
+        children: Vec<NodeId>,
+    },
+    Text(String),
+}
+
+struct Node {
+    parent: Option<NodeId>,
+    kind: NodeKind,
+}
+
+struct Chunk {
+    // groups the nodes are nested in, written around them with their attributes
+    wrappers: Vec<NodeId>,
+    nodes: Vec<NodeId>,
+    picture: Option<Picture>,
+}
+
+/// A parsed SVG that stays alive between draws. Elements can be edited in place and only the
+/// chunks containing the edits are parsed and recorded again, the rest replay their pictures.
+///
+/// Elements referenced by id (gradients, clip paths, `use` targets, ...) and definition elements
+/// are shared by every chunk, editing one of them re-records everything.
+pub struct SvgDocument {
+    nodes: Vec<Node>,
+    // slots of removed nodes, reused before growing `nodes`
+    free: Vec<NodeId>,
+    root: NodeId,
+    ids: HashMap<String, NodeId>,
+    shared: Vec<NodeId>,
+    referenced: Vec<NodeId>,
+    shared_set: HashSet<NodeId>,
+    chunks: Vec<Chunk>,
+    chunk_of: HashMap<NodeId, usize>,
+    partitioned: bool,
+    size: Size,
+}
+
+impl SvgDocument {
+    pub fn from_str(svg: &str) -> Result<Self, String> {
+        let mut nodes = Vec::new();
+        let top = Parser::new(svg).parse_document(&mut nodes)?;
+        let root = top
+            .into_iter()
+            .find(|id| matches!(&nodes[*id].kind, NodeKind::Element { name, .. } if local_name(name) == "svg"))
+            .ok_or_else(|| "missing svg element".to_string())?;
+        let mut document = Self {
+            nodes,
+            free: Vec::new(),
+            root,
+            ids: HashMap::new(),
+            shared: Vec::new(),
+            referenced: Vec::new(),
+            shared_set: HashSet::new(),
+            chunks: Vec::new(),
+            chunk_of: HashMap::new(),
+            partitioned: false,
+            size: Size::new_empty(),
+        };
+        document.index_ids(root);
+        Ok(document)
+    }
+
+    pub fn root(&self) -> NodeId {
+        self.root
+    }
+
+    pub fn element_by_id(&self, id: &str) -> Option<NodeId> {
+        self.ids.get(id).copied()
+    }
+
+    pub fn attribute(&self, node: NodeId, name: &str) -> Option<&str> {
+        match &self.nodes.get(node)?.kind {
+            NodeKind::Element { attributes, .. } => attributes
+                .iter()
+                .find(|(key, _)| key == name)
+                .map(|(_, value)| value.as_str()),
+            NodeKind::Text(_) => None,
+        }
+    }
+
+    /// Sets or, with `None`, removes an attribute. Returns false when `node` is not an element.
+    pub fn set_attribute(&mut self, node: NodeId, name: &str, value: Option<&str>) -> bool {
+        if !self.is_attached(node) {
+            return false;
+        }
+        let previous = match &mut self.nodes[node].kind {
+            NodeKind::Element { attributes, .. } => {
+                let index = attributes.iter().position(|(key, _)| key == name);
+                match (index, value) {
+                    (Some(index), Some(value)) => {
+                        if attributes[index].1 == value {
+                            return true;
+                        }
+                        Some(std::mem::replace(&mut attributes[index].1, value.to_string()))
+                    }
+                    (Some(index), None) => Some(attributes.remove(index).1),
+                    (None, Some(value)) => {
+                        attributes.push((name.to_string(), value.to_string()));
+                        None
+                    }
+                    (None, None) => return true,
+                }
+            }
+            NodeKind::Text(_) => return false,
+        };
+        if name == "id" {
+            if let Some(previous) = &previous {
+                if self.ids.get(previous) == Some(&node) {
+                    self.ids.remove(previous);
+                }
+            }
+            if let Some(value) = value {
+                self.ids.insert(value.to_string(), node);
+            }
+            // references to the old or new id may change which elements are shared
+            self.partitioned = false;
+        } else {
+            // only a change of the ids it refers to can change which elements are shared
+            let mut before = HashSet::new();
+            let mut after = HashSet::new();
+            if let Some(previous) = &previous {
+                attribute_references(name, previous, &mut before);
+            }
+            if let Some(value) = value {
+                attribute_references(name, value, &mut after);
+            }
+            if before != after {
+                self.partitioned = false;
+            }
+        }
+        self.touch(node);
+        true
+    }
+
+    /// Replaces the children of `node` with `text`, e.g. the content of a `text` element.
+    pub fn set_text(&mut self, node: NodeId, text: &str) -> bool {
+        if !self.is_attached(node) || !self.is_element(node) {
+            return false;
+        }
+        for child in self.children(node).to_vec() {
+            self.release(child);
+        }
+        let text_node = self.reserve();
+        self.nodes[text_node] = Node {
+            parent: Some(node),
+            kind: NodeKind::Text(text.to_string()),
+        };
+        if let NodeKind::Element { children, .. } = &mut self.nodes[node].kind {
+            children.push(text_node);
+        }
+        self.touch(node);
+        true
+    }
+
+    /// Parses `xml` and appends its nodes to `parent`, returning the first element appended.
+    pub fn append_child(&mut self, parent: NodeId, xml: &str) -> Result<Option<NodeId>, String> {
+        if !self.is_attached(parent) || !self.is_element(parent) {
+            return Err("parent is not an element".to_string());
+        }
+        let mut parsed = Vec::new();
+        let top = Parser::new(xml).parse_document(&mut parsed)?;
+        let slots: Vec<NodeId> = (0..parsed.len()).map(|_| self.reserve()).collect();
+        for (index, mut node) in parsed.into_iter().enumerate() {
+            node.parent = node.parent.map(|parent| slots[parent]);
+            if let NodeKind::Element { children, .. } = &mut node.kind {
+                for child in children.iter_mut() {
+                    *child = slots[*child];
+                }
+            }
+            self.nodes[slots[index]] = node;
+        }
+        let top: Vec<NodeId> = top.into_iter().map(|node| slots[node]).collect();
+        for &node in top.iter() {
+            self.nodes[node].parent = Some(parent);
+        }
+        // text outside the appended elements
+        for &node in slots.iter() {
+            if self.nodes[node].parent.is_none() {
+                self.release(node);
+            }
+        }
+        let mut first = None;
+        for &node in top.iter() {
+            if first.is_none() && self.is_element(node) {
+                first = Some(node);
+            }
+            self.index_ids(node);
+        }
+        if let NodeKind::Element { children, .. } = &mut self.nodes[parent].kind {
+            children.extend_from_slice(&top);
+        }
+        if top.iter().any(|&node| self.has_references(node)) {
+            self.partitioned = false;
+        }
+        self.touch(parent);
+        Ok(first)
+    }
+
+    /// Removes `node` and everything below it, the root can't be removed.
+    pub fn remove(&mut self, node: NodeId) -> bool {
+        if node == self.root || !self.is_attached(node) {
+            return false;
+        }
+        let parent = self.nodes[node].parent;
+        self.release(node);
+        if let Some(parent) = parent {
+            self.touch(parent);
+        }
+        true
+    }
+
+    pub fn to_xml(&self) -> String {
+        let mut xml = String::new();
+        self.write_node(self.root, &mut xml);
+        xml
+    }
+
+    /// Records the chunks changed since the last render at `size`, checking `cancellation`
+    /// between chunks. Returns false when cancelled, chunks recorded so far are kept.
+    pub fn prepare(&mut self, size: Size, cancellation: &Cancellation) -> bool {
+        profile_scope!("svg.prepare");
+        if size != self.size {
+            self.size = size;
+            self.invalidate_all();
+        }
+        if !self.partitioned {
+            self.partition();
+        }
+        if self.chunks.iter().any(|chunk| chunk.picture.is_none()) {
+            let prefix = self.document_prefix();
+            for index in 0..self.chunks.len() {
+                if self.chunks[index].picture.is_none() {
+                    if cancellation.is_cancelled() {
+                        return false;
+                    }
+                    let picture = self.record(&prefix, &self.chunks[index]);
+                    self.chunks[index].picture = picture;
+                }
+            }
+        }
+        true
+    }
+
+    /// Draws the document as recorded by the last [`prepare`](Self::prepare).
+    pub fn draw(&self, canvas: &mut Canvas) {
+        for chunk in self.chunks.iter() {
+            if let Some(picture) = &chunk.picture {
+                canvas.draw_picture(picture, None, None);
+            }
+        }
+    }
+
+    fn record(&self, prefix: &str, chunk: &Chunk) -> Option<Picture> {
+        let mut xml = String::from(prefix);
+        for &wrapper in chunk.wrappers.iter() {
+            self.write_open_tag(wrapper, &mut xml);
+        }
+        for &node in chunk.nodes.iter() {
+            self.write_node(node, &mut xml);
+        }
+        for &wrapper in chunk.wrappers.iter().rev() {
+            self.write_close_tag(wrapper, &mut xml);
+        }
+        self.write_close_tag(self.root, &mut xml);
+
+        match skia_safe::svg::Dom::from_bytes(xml.as_bytes()) {
+            Ok(mut dom) => {
+                dom.set_container_size(self.size);
+                let mut recorder = PictureRecorder::new();
+                let canvas = recorder.begin_recording(Rect::from_size(self.size), None);
+                dom.render(canvas);
+                recorder.finish_recording_as_picture(None)
+            }
+            Err(e) => {
+                log::debug!("svg chunk read error: {}", e);
+                None
+            }
+        }
+    }
+
+    // the root element with everything shared, each chunk is appended to it
+    fn document_prefix(&self) -> String {
+        let mut xml = String::new();
+        self.write_open_tag(self.root, &mut xml);
+        if !self.referenced.is_empty() {
+            xml.push_str("<defs>");
+            for &node in self.referenced.iter() {
+                self.write_node(node, &mut xml);
+            }
+            xml.push_str("</defs>");
+        }
+        for &node in self.shared.iter() {
+            self.write_node(node, &mut xml);
+        }
+        xml
+    }
+
+    fn invalidate_all(&mut self) {
+        for chunk in self.chunks.iter_mut() {
+            chunk.picture = None;
+        }
+    }
+
+    // drops the picture of the chunk `node` belongs to, or of every chunk when it is shared
+    fn touch(&mut self, node: NodeId) {
+        if !self.partitioned {
+            return;
+        }
+        let mut current = Some(node);
+        while let Some(id) = current {
+            if self.shared_set.contains(&id) {
+                self.invalidate_all();
+                return;
+            }
+            if let Some(&chunk) = self.chunk_of.get(&id) {
+                self.chunks[chunk].picture = None;
+                return;
+            }
+            current = self.nodes[id].parent;
+        }
+        // the root or a group split across chunks changed
+        self.partitioned = false;
+    }
+
+    fn partition(&mut self) {
+        self.shared.clear();
+        self.referenced.clear();
+        self.shared_set.clear();
+        self.chunks.clear();
+        self.chunk_of.clear();
+
+        let mut references = HashSet::new();
+        self.collect_references(self.root, &mut references);
+        let mut referenced: Vec<NodeId> = references
+            .iter()
+            .filter_map(|id| self.ids.get(id).copied())
+            .filter(|&node| node != self.root && self.is_attached(node))
+            .collect();
+        referenced.sort_unstable();
+        for node in referenced {
+            // already written as part of a shared ancestor
+            if !self.has_shared_ancestor(node) {
+                self.referenced.push(node);
+            }
+            self.shared_set.insert(node);
+        }
+
+        let root = self.root;
+        if self.is_splittable(root) {
+            self.partition_children(root, &[]);
+        } else {
+            let mut nodes = Vec::new();
+            for child in self.children(root).to_vec() {
+                if self.is_shared_element(child) {
+                    self.shared.push(child);
+                    self.shared_set.insert(child);
+                } else if self.is_element(child) {
+                    nodes.push(child);
+                }
+            }
+            self.push_chunk(&[], nodes);
+        }
+        self.partitioned = true;
+    }
+
+    fn partition_children(&mut self, parent: NodeId, wrappers: &[NodeId]) {
+        let mut run = Vec::new();
+        let mut run_size = 0;
+        for child in self.children(parent).to_vec() {
+            if !self.is_element(child) {
+                continue;
+            }
+            if self.is_shared_element(child) {
+                self.shared.push(child);
+                self.shared_set.insert(child);
+                continue;
+            }
+            let size = self.subtree_size(child);
+            if size > CHUNK_NODES && self.is_splittable(child) {
+                self.push_chunk(wrappers, std::mem::take(&mut run));
+                run_size = 0;
+                let mut inner = wrappers.to_vec();
+                inner.push(child);
+                self.partition_children(child, &inner);
+            } else {
+                if run_size + size > CHUNK_NODES && !run.is_empty() {
+                    self.push_chunk(wrappers, std::mem::take(&mut run));
+                    run_size = 0;
+                }
+                run.push(child);
+                run_size += size;
+            }
+        }
+        self.push_chunk(wrappers, run);
+    }
+
+    fn push_chunk(&mut self, wrappers: &[NodeId], nodes: Vec<NodeId>) {
+        if nodes.is_empty() {
+            return;
+        }
+        let index = self.chunks.len();
+        for &node in nodes.iter() {
+            self.chunk_of.insert(node, index);
+        }
+        self.chunks.push(Chunk {
+            wrappers: wrappers.to_vec(),
+            nodes,
+            picture: None,
+        });
+    }
+
+    fn is_splittable(&self, node: NodeId) -> bool {
+        match &self.nodes[node].kind {
+            NodeKind::Element { name, attributes, .. } => {
+                let name = local_name(name);
+                (name == "g" || node == self.root)
+                    && !attributes.iter().any(|(key, value)| {
+                        COMPOSITING_ATTRIBUTES.contains(&key.as_str())
+                            || (key == "style"
+                                && COMPOSITING_ATTRIBUTES.iter().any(|attribute| value.contains(attribute)))
+                    })
+            }
+            NodeKind::Text(_) => false,
+        }
+    }
+
+    fn is_shared_element(&self, node: NodeId) -> bool {
+        match &self.nodes[node].kind {
+            NodeKind::Element { name, .. } => SHARED_ELEMENTS.contains(&local_name(name)),
+            NodeKind::Text(_) => false,
+        }
+    }
+
+    fn has_shared_ancestor(&self, node: NodeId) -> bool {
+        let mut current = self.nodes[node].parent;
+        while let Some(id) = current {
+            if self.is_shared_element(id) || self.shared_set.contains(&id) {
+                return true;
+            }
+            current = self.nodes[id].parent;
+        }
+        false
+    }
+
+    fn has_references(&self, node: NodeId) -> bool {
+        let mut references = HashSet::new();
+        self.collect_references(node, &mut references);
+        !references.is_empty()
+    }
+
+    fn collect_references(&self, node: NodeId, references: &mut HashSet<String>) {
+        if let NodeKind::Element { attributes, children, .. } = &self.nodes[node].kind {
+            for (key, value) in attributes.iter() {
+                attribute_references(key, value, references);
+            }
+            for &child in children.iter() {
+                self.collect_references(child, references);
+            }
+        }
+    }
+
+    fn subtree_size(&self, node: NodeId) -> usize {
+        match &self.nodes[node].kind {
+            NodeKind::Element { children, .. } => {
+                1 + children.iter().map(|&child| self.subtree_size(child)).sum::<usize>()
+            }
+            NodeKind::Text(_) => 0,
+        }
+    }
+
+    fn children(&self, node: NodeId) -> &[NodeId] {
+        match &self.nodes[node].kind {
+            NodeKind::Element { children, .. } => children.as_slice(),
+            NodeKind::Text(_) => &[],
+        }
+    }
+
+    fn is_element(&self, node: NodeId) -> bool {
+        matches!(self.nodes[node].kind, NodeKind::Element { .. })
+    }
+
+    // released slots have no parent until they are reused
+    fn is_attached(&self, node: NodeId) -> bool {
+        let mut current = node;
+        loop {
+            if current == self.root {
+                return true;
+            }
+            match self.nodes.get(current).and_then(|node| node.parent) {
+                Some(parent) => current = parent,
+                None => return false,
+            }
+        }
+    }
+
+    fn detach(&mut self, node: NodeId) {
+        if let Some(parent) = self.nodes[node].parent.take() {
+            if let NodeKind::Element { children, .. } = &mut self.nodes[parent].kind {
+                children.retain(|&child| child != node);
+            }
+        }
+        self.unindex_ids(node);
+    }
+
+    fn reserve(&mut self) -> NodeId {
+        match self.free.pop() {
+            Some(node) => node,
+            None => {
+                self.nodes.push(Node {
+                    parent: None,
+                    kind: NodeKind::Text(String::new()),
+                });
+                self.nodes.len() - 1
+            }
+        }
+    }
+
+    // detaches `node` and hands its slot and those below it back for reuse
+    fn release(&mut self, node: NodeId) {
+        self.detach(node);
+        let mut pending = vec![node];
+        while let Some(node) = pending.pop() {
+            if self.shared_set.contains(&node) || self.chunk_of.contains_key(&node) {
+                // the partition still refers to the slot
+                self.partitioned = false;
+            }
+            let released = std::mem::replace(
+                &mut self.nodes[node],
+                Node {
+                    parent: None,
+                    kind: NodeKind::Text(String::new()),
+                },
+            );
+            if let NodeKind::Element { children, .. } = released.kind {
+                pending.extend(children);
+            }
+            self.free.push(node);
+        }
+    }
+
+    fn index_ids(&mut self, node: NodeId) {
+        let mut pending = vec![node];
+        while let Some(node) = pending.pop() {
+            if let NodeKind::Element { attributes, children, .. } = &self.nodes[node].kind {
+                if let Some((_, id)) = attributes.iter().find(|(key, _)| key == "id") {
+                    self.ids.insert(id.clone(), node);
+                }
+                pending.extend_from_slice(children);
+            }
+        }
+    }
+
+    fn unindex_ids(&mut self, node: NodeId) {
+        let mut pending = vec![node];
+        while let Some(node) = pending.pop() {
+            if let NodeKind::Element { attributes, children, .. } = &self.nodes[node].kind {
+                if let Some((_, id)) = attributes.iter().find(|(key, _)| key == "id") {
+                    if self.ids.get(id) == Some(&node) {
+                        self.ids.remove(id);
+                    }
+                }
+                pending.extend_from_slice(children);
+            }
+        }
+    }
+
+    fn write_open_tag(&self, node: NodeId, xml: &mut String) {
+        if let NodeKind::Element { name, attributes, .. } = &self.nodes[node].kind {
+            xml.push('<');
+            xml.push_str(name);
+            for (key, value) in attributes.iter() {
+                xml.push(' ');
+                xml.push_str(key);
+                xml.push_str("=\"");
+                escape_into(value, true, xml);
+                xml.push('"');
+            }
+            xml.push('>');
+        }
+    }
+
+    fn write_close_tag(&self, node: NodeId, xml: &mut String) {
+        if let NodeKind::Element { name, .. } = &self.nodes[node].kind {
+            xml.push_str("</");
+            xml.push_str(name);
+            xml.push('>');
+        }
+    }
+
+    fn write_node(&self, node: NodeId, xml: &mut String) {
+        match &self.nodes[node].kind {
+            NodeKind::Element { children, .. } => {
+                self.write_open_tag(node, xml);
+                for &child in children.iter() {
+                    self.write_node(child, xml);
+                }
+                self.write_close_tag(node, xml);
+            }
+            NodeKind::Text(text) => escape_into(text, false, xml),
+        }
+    }
+}
+
+// ids an attribute refers to, through href or url(#id)
+fn attribute_references(key: &str, value: &str, references: &mut HashSet<String>) {
+    if key == "href" || key.ends_with(":href") {
+        if let Some(id) = value.trim().strip_prefix('#') {
+            references.insert(id.to_string());
+        }
+    }
+    let mut rest = value;
+    while let Some(start) = rest.find("url(") {
+        rest = &rest[start + 4..];
+        let end = rest.find(')').unwrap_or(rest.len());
+        let target = rest[..end].trim().trim_matches(|c| c == '\'' || c == '"');
+        if let Some(id) = target.strip_prefix('#') {
+            references.insert(id.to_string());
+        }
+        rest = &rest[end..];
+    }
+}
+
+fn local_name(name: &str) -> &str {
+    name.rsplit(':').next().unwrap_or(name)
+}
+
+fn escape_into(value: &str, attribute: bool, xml: &mut String) {
+    for c in value.chars() {
+        match c {
+            '&' => xml.push_str("&amp;"),
+            '<' => xml.push_str("&lt;"),
+            '>' if !attribute => xml.push_str("&gt;"),
+            '"' if attribute => xml.push_str("&quot;"),
+            _ => xml.push(c),
+        }
+    }
+}
+
+fn unescape(value: &str) -> String {
+    if !value.contains('&') {
+        return value.to_string();
+    }
+    let mut out = String::with_capacity(value.len());
+    let mut rest = value;
+    while let Some(start) = rest.find('&') {
+        out.push_str(&rest[..start]);
+        rest = &rest[start..];
+        let decoded = rest.find(';').and_then(|end| {
+            let entity = &rest[1..end];
+            let c = match entity {
+                "amp" => Some('&'),
+                "lt" => Some('<'),
+                "gt" => Some('>'),
+                "quot" => Some('"'),
+                "apos" => Some('\''),
+                _ => {
+                    let code = if let Some(hex) = entity.strip_prefix("#x").or_else(|| entity.strip_prefix("#X")) {
+                        u32::from_str_radix(hex, 16).ok()
+                    } else if let Some(decimal) = entity.strip_prefix('#') {
+                        decimal.parse::<u32>().ok()
+                    } else {
+                        None
+                    };
+                    // NUL isn't a legal XML character, the reference stays text
+                    code.and_then(char::from_u32).filter(|&c| c != '\0')
+                }
+            };
+            c.map(|c| (c, end))
+        });
+        match decoded {
+            Some((c, end)) => {
+                out.push(c);
+                rest = &rest[end + 1..];
+            }
+            None => {
+                out.push('&');
+                rest = &rest[1..];
+            }
+        }
+    }
+    out.push_str(rest);
+    out
+}
+
+/// Just enough XML for SVG: elements, attributes, text and CDATA. Comments, processing
+/// instructions and doctypes are skipped.
+struct Parser<'a> {
+    src: &'a str,
+    pos: usize,
+}
+
+impl<'a> Parser<'a> {
+    fn new(src: &'a str) -> Self {
+        Self { src, pos: 0 }
+    }
+
+    fn rest(&self) -> &'a str {
+        &self.src[self.pos..]
+    }
+
+    fn starts_with(&self, prefix: &str) -> bool {
+        self.rest().starts_with(prefix)
+    }
+
+    fn skip_past(&mut self, terminator: &str) -> Result<(), String> {
+        match self.rest().find(terminator) {
+            Some(index) => {
+                self.pos += index + terminator.len();
+                Ok(())
+            }
+            None => Err(format!("missing {}", terminator)),
+        }
+    }
+
+    fn skip_whitespace(&mut self) {
+        let rest = self.rest();
+        self.pos += rest.len() - rest.trim_start().len();
+    }
+
+    fn name(&mut self) -> Result<&'a str, String> {
+        let rest = self.rest();
+        let end = rest
+            .find(|c: char| c.is_whitespace() || c == '=' || c == '>' || c == '/' || c == '<')
+            .unwrap_or(rest.len());
+        if end == 0 {
+            return Err(format!("expected a name at {}", self.pos));
+        }
+        self.pos += end;
+        Ok(&rest[..end])
+    }
+
+    /// Top level nodes, text outside elements is dropped.
+    fn parse_document(&mut self, nodes: &mut Vec<Node>) -> Result<Vec<NodeId>, String> {
+        let top = self.parse_content(nodes, None)?;
+        if self.pos < self.src.len() {
+            return Err(format!("unexpected closing tag at {}", self.pos));
+        }
+        Ok(top
+            .into_iter()
+            .filter(|&node| matches!(nodes[node].kind, NodeKind::Element { .. }))
+            .collect())
+    }
+
+    fn parse_content(&mut self, nodes: &mut Vec<Node>, parent: Option<NodeId>) -> Result<Vec<NodeId>, String> {
+        let mut children = Vec::new();
+        while self.pos < self.src.len() {
+            if self.starts_with("</") {
+                break;
+            } else if self.starts_with("<!--") {
+                self.skip_past("-->")?;
+            } else if self.starts_with("<![CDATA[") {
+                self.pos += "<![CDATA[".len();
+                let rest = self.rest();
+                let end = rest.find("]]>").ok_or_else(|| "missing ]]>".to_string())?;
+                children.push(push_node(nodes, parent, NodeKind::Text(rest[..end].to_string())));
+                self.pos += end + 3;
+            } else if self.starts_with("<?") {
+                self.skip_past("?>")?;
+            } else if self.starts_with("<!") {
+                self.skip_doctype()?;
+            } else if self.starts_with("<") {
+                children.push(self.parse_element(nodes, parent)?);
+            } else {
+                let rest = self.rest();
+                let end = rest.find('<').unwrap_or(rest.len());
+                children.push(push_node(nodes, parent, NodeKind::Text(unescape(&rest[..end]))));
+                self.pos += end;
+            }
+        }
+        if parent.is_some() && self.pos >= self.src.len() {
+            return Err("unexpected end of document".to_string());
+        }
+        Ok(children)
+    }
+
+    fn skip_doctype(&mut self) -> Result<(), String> {
+        let mut depth = 0;
+        for (index, c) in self.rest().char_indices() {
+            match c {
+                '[' => depth += 1,
+                ']' => depth -= 1,
+                '>' if depth == 0 => {
+                    self.pos += index + 1;
+                    return Ok(());
+                }
+                _ => {}
+            }
+        }
+        Err("unterminated doctype".to_string())
+    }
+
+    fn parse_element(&mut self, nodes: &mut Vec<Node>, parent: Option<NodeId>) -> Result<NodeId, String> {
+        self.pos += 1;
+        let name = self.name()?;
+        let mut attributes = Vec::new();
+        let self_closing = loop {
+            self.skip_whitespace();
+            if self.starts_with("/>") {
+                self.pos += 2;
+                break true;
+            }
+            if self.starts_with(">") {
+                self.pos += 1;
+                break false;
+            }
+            if self.pos >= self.src.len() {
+                return Err(format!("unterminated <{}>", name));
+            }
+            let key = self.name()?;
+            self.skip_whitespace();
+            if !self.starts_with("=") {
+                return Err(format!("expected = after {}", key));
+            }
+            self.pos += 1;
+            self.skip_whitespace();
+            let quote = match self.rest().chars().next() {
+                Some(quote) if quote == '"' || quote == '\'' => quote,
+                _ => return Err(format!("expected a quoted value for {}", key)),
+            };
+            self.pos += 1;
+            let rest = self.rest();
+            let end = rest.find(quote).ok_or_else(|| format!("unterminated value for {}", key))?;
+            attributes.push((key.to_string(), unescape(&rest[..end])));
+            self.pos += end + 1;
+        };
+
+        let node = push_node(
+            nodes,
+            parent,
+            NodeKind::Element {
+                name: name.to_string(),
+                attributes,
+                children: Vec::new(),
+            },
+        );
+        if !self_closing {
+            let content = self.parse_content(nodes, Some(node))?;
+            self.pos += 2;
+            let closing = self.name()?;
+            if closing != name {
+                return Err(format!("expected </{}> but found </{}>", name, closing));
+            }
+            self.skip_whitespace();
+            if !self.starts_with(">") {
+                return Err(format!("unterminated </{}>", name));
+            }
+            self.pos += 1;
+            if let NodeKind::Element { children, .. } = &mut nodes[node].kind {
+                *children = content;
+            }
+        }
+        Ok(node)
+    }
+}
+
+fn push_node(nodes: &mut Vec<Node>, parent: Option<NodeId>, kind: NodeKind) -> NodeId {
+    nodes.push(Node { parent, kind });
+    nodes.len() - 1
+}
@@ -1,61 +1,100 @@
 use std::io::{Read, Seek, SeekFrom};
 
 use crate::common::context::Context;
+use crate::common::svg::cancel::Cancellation;
+use crate::common::profiler::profile_scope;
 
-pub(crate) fn draw_svg_from_path(context: &mut Context, path: &str) {
-    let file = std::fs::File::open(path);
-    match file {
-        Ok(file) => {
-            let mut reader = std::io::BufReader::new(file);
-            let mut bytes = [0; 16];
-            let result = reader.read(&mut bytes);
-            match result {
-                Ok(_) => {
-                    let _ = reader.seek(SeekFrom::Start(0));
-                    match skia_safe::svg::Dom::read(reader) {
-                        Ok(mut svg) => {
-                            let _device = context.device;
-                            let size = skia_safe::Size::new(
-                                context.surface.width() as f32,
-                                context.surface.height() as f32,
-                            );
-                            let canvas = context.surface.canvas();
-                            svg.set_container_size(size);
-                            //  canvas.scale((device.density, device.density));
-                            svg.render(canvas)
-                        }
-                        Err(e) => {
-                            println!("svg read to string error: {}", e);
-                        }
+pub(crate) mod atlas;
+pub(crate) mod cache;
+pub mod cancel;
+pub mod document;
+
+/// Returns false when nothing was drawn, because the svg failed to load or the render was
+/// cancelled.
+pub(crate) fn draw_svg_from_path(
+    context: &mut Context,
+    path: &str,
+    cancellation: &Cancellation,
+) -> bool {
+    profile_scope!("svg.render");
+    let key = match cache::SvgKey::file(path) {
+        Ok(key) => key,
+        Err(e) => {
+            println!("svg file open error: {}", e);
+            return false;
+        }
+    };
+    let size = skia_safe::Size::new(
+        context.surface.width() as f32,
+        context.surface.height() as f32,
+    );
+    let canvas = context.surface.canvas();
+    // canvas.scale((device.density, device.density));
+    let load = || {
+        let file = match std::fs::File::open(path) {
+            Ok(file) => file,
+            Err(e) => {
+                println!("svg file open error: {}", e);
+                return None;
+            }
+        };
+        let mut reader = std::io::BufReader::new(file);
+        let mut bytes = [0; 16];
+        match reader.read(&mut bytes) {
+            Ok(_) => {
+                let _ = reader.seek(SeekFrom::Start(0));
+                // TODO check bytes to verify it's an svg
+                match skia_safe::svg::Dom::read(reader) {
+                    Ok(svg) => Some(svg),
+                    Err(e) => {
+                        println!("svg read to string error: {}", e);
+                        None
                     }
-                    // TODO check bytes to verify it's an svg
-                }
-                Err(e) => {
-                    println!("svg file read error: {}", e);
                 }
             }
+            Err(e) => {
+                println!("svg file read error: {}", e);
+                None
+            }
         }
-        Err(e) => {
-            println!("svg file open error: {}", e);
-        }
-    }
+    };
+    cache::draw_cached(canvas, size, key, load, cancellation)
 }
 
-pub(crate) fn draw_svg(context: &mut Context, svg: &str) {
-    match skia_safe::svg::Dom::from_bytes(svg.as_bytes()) {
-        Ok(mut svg) => {
-            let _device = context.device;
-            let size = skia_safe::Size::new(
-                context.surface.width() as f32,
-                context.surface.height() as f32,
-            );
-            let canvas = context.surface.canvas();
-            svg.set_container_size(size);
-            // canvas.scale((device.density, device.density));
-            svg.render(canvas)
-        }
+pub(crate) fn draw_svg(context: &mut Context, svg: &str, cancellation: &Cancellation) -> bool {
+    profile_scope!("svg.render");
+    let size = skia_safe::Size::new(
+        context.surface.width() as f32,
+        context.surface.height() as f32,
+    );
+    let canvas = context.surface.canvas();
+    // canvas.scale((device.density, device.density));
+    let load = || match skia_safe::svg::Dom::from_bytes(svg.as_bytes()) {
+        Ok(svg) => Some(svg),
         Err(e) => {
             log::debug!("svg read to string error: {}", e);
+            None
         }
+    };
+    cache::draw_cached(canvas, size, cache::SvgKey::content(svg), load, cancellation)
+}
+
+pub(crate) fn draw_svg_document(
+    context: &mut Context,
+    document: &mut document::SvgDocument,
+    cancellation: &Cancellation,
+) -> bool {
+    profile_scope!("svg.render_document");
+    let size = skia_safe::Size::new(
+        context.surface.width() as f32,
+        context.surface.height() as f32,
+    );
+    if !document.prepare(size, cancellation) {
+        return false;
     }
+    let canvas = context.surface.canvas();
+    // edits redraw the whole document, drop what the previous render left behind
+    canvas.clear(skia_safe::Color::TRANSPARENT);
+    document.draw(canvas);
+    true
 }
@@ -1,40 +1,390 @@
+use lazy_static::lazy_static;
+use parking_lot::Mutex;
 use skia_safe::Color;
 
+use crate::common::utils::lru_cache::LruCache;
+
+const PARSED_COLORS_CAPACITY: usize = 64;
+
+const HEX_DIGITS: &[u8; 16] = b"0123456789abcdef";
+
+lazy_static! {
+    /// Recently parsed non hex color strings, style strings tend to repeat every frame.
+    static ref PARSED_COLORS: Mutex<LruCache<String, Color>> =
+        Mutex::new(LruCache::new(PARSED_COLORS_CAPACITY));
+    /// `alpha / 255` as serialized by `to_parsed_color`, indexed by alpha.
+    static ref ALPHA_STRINGS: Vec<String> = (0..=255u32)
+        .map(|alpha| (alpha as f32 / 255.0).to_string())
+        .collect();
+}
+
+/// Parses a css color: `#rgb`, `#rgba`, `#rrggbb`, `#rrggbbaa`, `rgb()`, `rgba()`, `hsl()`,
+/// `hsla()` in comma or space separated form, named colors and `transparent`.
 pub(crate) fn parse_color(value: &str) -> Option<Color> {
-    match value.parse::<css_color_parser::Color>() {
-        Ok(color) => Some(Color::from_argb(
-            (color.a * 255.0) as u8,
-            color.r,
-            color.g,
-            color.b,
-        )),
+    let value = value.trim();
+    if let Some(hex) = value.strip_prefix('#') {
+        // cheaper to parse than to look up
+        return parse_hex(hex);
+    }
+    if let Some(color) = PARSED_COLORS.lock().get(value) {
+        return Some(*color);
+    }
+    let color = parse_uncached(value)?;
+    PARSED_COLORS.lock().insert(value.to_string(), color);
+    Some(color)
+}
+
+fn parse_uncached(value: &str) -> Option<Color> {
+    let lower;
+    let value = if value.bytes().any(|b| b.is_ascii_uppercase()) {
+        lower = value.to_ascii_lowercase();
+        lower.as_str()
+    } else {
+        value
+    };
+    if let Some(open) = value.find('(') {
+        let args = value[open + 1..].strip_suffix(')')?;
+        return match value[..open].trim_end() {
+            "rgb" | "rgba" => parse_rgb(args),
+            "hsl" | "hsla" => parse_hsl(args),
+            _ => None,
+        };
+    }
+    if value == "transparent" {
+        return Some(Color::TRANSPARENT);
+    }
+    NAMED_COLORS
+        .binary_search_by(|(name, _)| name.cmp(&value))
+        .ok()
+        .map(|index| Color::new(0xFF000000 | NAMED_COLORS[index].1))
+}
+
+fn hex_value(digit: u8) -> Option<u8> {
+    match digit {
+        b'0'..=b'9' => Some(digit - b'0'),
+        b'a'..=b'f' => Some(digit - b'a' + 10),
+        b'A'..=b'F' => Some(digit - b'A' + 10),
         _ => None,
     }
 }
 
-fn to_hex(value: u8) -> String {
-    let mut hex = format!("{:x}", value);
-    if hex.len() == 1 {
-        hex = format!("0{}", hex);
+fn parse_hex(hex: &str) -> Option<Color> {
+    let digits = hex.as_bytes();
+    if digits.len() > 8 {
+        return None;
+    }
+    let mut values = [0u8; 8];
+    for (value, digit) in values.iter_mut().zip(digits.iter()) {
+        *value = hex_value(*digit)?;
+    }
+    let v = values;
+    let (r, g, b, a) = match digits.len() {
+        3 => (v[0] * 17, v[1] * 17, v[2] * 17, 255),
+        4 => (v[0] * 17, v[1] * 17, v[2] * 17, v[3] * 17),
+        6 => (v[0] << 4 | v[1], v[2] << 4 | v[3], v[4] << 4 | v[5], 255),
+        8 => (
+            v[0] << 4 | v[1],
+            v[2] << 4 | v[3],
+            v[4] << 4 | v[5],
+            v[6] << 4 | v[7],
+        ),
+        _ => return None,
+    };
+    Some(Color::from_argb(a, r, g, b))
+}
+
+/// Splits function arguments written either as `a, b, c[, alpha]` or `a b c[ / alpha]`.
+fn split_args(args: &str) -> Option<([&str; 3], Option<&str>)> {
+    let mut parts = [""; 4];
+    let mut count = 0;
+    if args.contains(',') {
+        for part in args.split(',') {
+            if count == parts.len() {
+                return None;
+            }
+            parts[count] = part.trim();
+            count += 1;
+        }
+    } else {
+        let (channels, alpha) = match args.split_once('/') {
+            Some((channels, alpha)) => (channels, Some(alpha.trim())),
+            None => (args, None),
+        };
+        for part in channels.split_ascii_whitespace() {
+            if count == 3 {
+                return None;
+            }
+            parts[count] = part;
+            count += 1;
+        }
+        if count == 3 {
+            if let Some(alpha) = alpha {
+                parts[3] = alpha;
+                count = 4;
+            }
+        }
+    }
+    if count < 3 || parts[..count].iter().any(|part| part.is_empty()) {
+        return None;
+    }
+    let alpha = if count == 4 { Some(parts[3]) } else { None };
+    Some(([parts[0], parts[1], parts[2]], alpha))
+}
+
+fn parse_number(value: &str) -> Option<f32> {
+    value.parse::<f32>().ok().filter(|value| value.is_finite())
+}
+
+/// Parses a number, or a percentage scaled to `percent_of`.
+fn parse_component(value: &str, percent_of: f32) -> Option<f32> {
+    match value.strip_suffix('%') {
+        Some(percent) => parse_number(percent).map(|percent| percent / 100.0 * percent_of),
+        None => parse_number(value),
+    }
+}
+
+fn parse_alpha(value: Option<&str>) -> Option<u8> {
+    match value {
+        Some(value) => parse_component(value, 1.0).map(unit_to_byte),
+        None => Some(255),
+    }
+}
+
+fn parse_hue(value: &str) -> Option<f32> {
+    // grad before rad, it shares the suffix
+    let (number, degrees) = if let Some(number) = value.strip_suffix("deg") {
+        (number, 1.0)
+    } else if let Some(number) = value.strip_suffix("grad") {
+        (number, 0.9)
+    } else if let Some(number) = value.strip_suffix("rad") {
+        (number, 180.0 / std::f32::consts::PI)
+    } else if let Some(number) = value.strip_suffix("turn") {
+        (number, 360.0)
+    } else {
+        (value, 1.0)
+    };
+    parse_number(number).map(|hue| (hue * degrees).rem_euclid(360.0))
+}
+
+fn unit_to_byte(value: f32) -> u8 {
+    (value.max(0.0).min(1.0) * 255.0).round() as u8
+}
+
+fn channel_to_byte(value: f32) -> u8 {
+    value.max(0.0).min(255.0).round() as u8
+}
+
+fn parse_rgb(args: &str) -> Option<Color> {
+    let ([r, g, b], alpha) = split_args(args)?;
+    let r = channel_to_byte(parse_component(r, 255.0)?);
+    let g = channel_to_byte(parse_component(g, 255.0)?);
+    let b = channel_to_byte(parse_component(b, 255.0)?);
+    Some(Color::from_argb(parse_alpha(alpha)?, r, g, b))
+}
+
+fn parse_hsl(args: &str) -> Option<Color> {
+    let ([h, s, l], alpha) = split_args(args)?;
+    let h = parse_hue(h)?;
+    // saturation and lightness are percentages, bare numbers are read as such too
+    let s = parse_number(s.strip_suffix('%').unwrap_or(s))?.max(0.0).min(100.0) / 100.0;
+    let l = parse_number(l.strip_suffix('%').unwrap_or(l))?.max(0.0).min(100.0) / 100.0;
+    let channel = |n: f32| {
+        let k = (n + h / 30.0) % 12.0;
+        let a = s * l.min(1.0 - l);
+        unit_to_byte(l - a * (k - 3.0).min(9.0 - k).min(1.0).max(-1.0))
+    };
+    Some(Color::from_argb(
+        parse_alpha(alpha)?,
+        channel(0.0),
+        channel(8.0),
+        channel(4.0),
+    ))
+}
+
+fn push_decimal(out: &mut String, value: u8) {
+    if value >= 100 {
+        out.push((b'0' + value / 100) as char);
     }
-    hex
+    if value >= 10 {
+        out.push((b'0' + value / 10 % 10) as char);
+    }
+    out.push((b'0' + value % 10) as char);
 }
 
+/// Serializes `color` as `#rrggbb` when opaque and `rgba(r,g,b,a)` otherwise. Style getters call
+/// this for every read, so it is written out by hand rather than with `format!`.
 pub(crate) fn to_parsed_color(color: Color) -> String {
+    let channels = [color.r(), color.g(), color.b()];
     if color.a() == 255 {
-        format!(
-            "#{}{}{}",
-            to_hex(color.r()),
-            to_hex(color.g()),
-            to_hex(color.b())
-        )
+        let mut hex = String::with_capacity(7);
+        hex.push('#');
+        for channel in channels.iter() {
+            hex.push(HEX_DIGITS[(*channel >> 4) as usize] as char);
+            hex.push(HEX_DIGITS[(*channel & 0xF) as usize] as char);
+        }
+        hex
     } else {
-        format!(
-            "rgba({},{},{},{})",
-            color.r(),
-            color.g(),
-            color.b(),
-            (color.a() as f32 / 255.0)
-        )
+        let alpha = &ALPHA_STRINGS[color.a() as usize];
+        let mut rgba = String::with_capacity(18 + alpha.len());
+        rgba.push_str("rgba(");
+        for channel in channels.iter() {
+            push_decimal(&mut rgba, *channel);
+            rgba.push(',');
+        }
+        rgba.push_str(alpha);
+        rgba.push(')');
+        rgba
     }
 }
+
+/// Css named colors as `0xRRGGBB`, sorted by name for binary search.
+const NAMED_COLORS: [(&str, u32); 148] = [
+    ("aliceblue", 0xF0F8FF),
+    ("antiquewhite", 0xFAEBD7),
+    ("aqua", 0x00FFFF),
+    ("aquamarine", 0x7FFFD4),
+    ("azure", 0xF0FFFF),
+    ("beige", 0xF5F5DC),
+    ("bisque", 0xFFE4C4),
+    ("black", 0x000000),
+    ("blanchedalmond", 0xFFEBCD),
+    ("blue", 0x0000FF),
+    ("blueviolet", 0x8A2BE2),
+    ("brown", 0xA52A2A),
+    ("burlywood", 0xDEB887),
+    ("cadetblue", 0x5F9EA0),
+    ("chartreuse", 0x7FFF00),
+    ("chocolate", 0xD2691E),
+    ("coral", 0xFF7F50),
+    ("cornflowerblue", 0x6495ED),
+    ("cornsilk", 0xFFF8DC),
+    ("crimson", 0xDC143C),
+    ("cyan", 0x00FFFF),
+    ("darkblue", 0x00008B),
+    ("darkcyan", 0x008B8B),
+    ("darkgoldenrod", 0xB8860B),
+    ("darkgray", 0xA9A9A9),
+    ("darkgreen", 0x006400),
+    ("darkgrey", 0xA9A9A9),
+    ("darkkhaki", 0xBDB76B),
+    ("darkmagenta", 0x8B008B),
+    ("darkolivegreen", 0x556B2F),
+    ("darkorange", 0xFF8C00),
+    ("darkorchid", 0x9932CC),
+    ("darkred", 0x8B0000),
+    ("darksalmon", 0xE9967A),
+    ("darkseagreen", 0x8FBC8F),
+    ("darkslateblue", 0x483D8B),
+    ("darkslategray", 0x2F4F4F),
+    ("darkslategrey", 0x2F4F4F),
+    ("darkturquoise", 0x00CED1),
+    ("darkviolet", 0x9400D3),
+    ("deeppink", 0xFF1493),
+    ("deepskyblue", 0x00BFFF),
+    ("dimgray", 0x696969),
+    ("dimgrey", 0x696969),
+    ("dodgerblue", 0x1E90FF),
+    ("firebrick", 0xB22222),
+    ("floralwhite", 0xFFFAF0),
+    ("forestgreen", 0x228B22),
+    ("fuchsia", 0xFF00FF),
+    ("gainsboro", 0xDCDCDC),
+    ("ghostwhite", 0xF8F8FF),
+    ("gold", 0xFFD700),
+    ("goldenrod", 0xDAA520),
+    ("gray", 0x808080),
+    ("green", 0x008000),
+    ("greenyellow", 0xADFF2F),
+    ("grey", 0x808080),
+    ("honeydew", 0xF0FFF0),
+    ("hotpink", 0xFF69B4),
+    ("indianred", 0xCD5C5C),
+    ("indigo", 0x4B0082),
+    ("ivory", 0xFFFFF0),
+    ("khaki", 0xF0E68C),
+    ("lavender", 0xE6E6FA),
+    ("lavenderblush", 0xFFF0F5),
+    ("lawngreen", 0x7CFC00),
+    ("lemonchiffon", 0xFFFACD),
+    ("lightblue", 0xADD8E6),
+    ("lightcoral", 0xF08080),
+    ("lightcyan", 0xE0FFFF),
+    ("lightgoldenrodyellow", 0xFAFAD2),
+    ("lightgray", 0xD3D3D3),
+    ("lightgreen", 0x90EE90),
+    ("lightgrey", 0xD3D3D3),
+    ("lightpink", 0xFFB6C1),
+    ("lightsalmon", 0xFFA07A),
+    ("lightseagreen", 0x20B2AA),
+    ("lightskyblue", 0x87CEFA),
+    ("lightslategray", 0x778899),
+    ("lightslategrey", 0x778899),
+    ("lightsteelblue", 0xB0C4DE),
+    ("lightyellow", 0xFFFFE0),
+    ("lime", 0x00FF00),
+    ("limegreen", 0x32CD32),
+    ("linen", 0xFAF0E6),
+    ("magenta", 0xFF00FF),
+    ("maroon", 0x800000),
+    ("mediumaquamarine", 0x66CDAA),
+    ("mediumblue", 0x0000CD),
+    ("mediumorchid", 0xBA55D3),
+    ("mediumpurple", 0x9370DB),
+    ("mediumseagreen", 0x3CB371),
+    ("mediumslateblue", 0x7B68EE),
+    ("mediumspringgreen", 0x00FA9A),
+    ("mediumturquoise", 0x48D1CC),
+    ("mediumvioletred", 0xC71585),
+    ("midnightblue", 0x191970),
+    ("mintcream", 0xF5FFFA),
+    ("mistyrose", 0xFFE4E1),
+    ("moccasin", 0xFFE4B5),
+    ("navajowhite", 0xFFDEAD),
+    ("navy", 0x000080),
+    ("oldlace", 0xFDF5E6),
+    ("olive", 0x808000),
+    ("olivedrab", 0x6B8E23),
+    ("orange", 0xFFA500),
+    ("orangered", 0xFF4500),
+    ("orchid", 0xDA70D6),
+    ("palegoldenrod", 0xEEE8AA),
+    ("palegreen", 0x98FB98),
+    ("paleturquoise", 0xAFEEEE),
+    ("palevioletred", 0xDB7093),
+    ("papayawhip", 0xFFEFD5),
+    ("peachpuff", 0xFFDAB9),
+    ("peru", 0xCD853F),
+    ("pink", 0xFFC0CB),
+    ("plum", 0xDDA0DD),
+    ("powderblue", 0xB0E0E6),
+    ("purple", 0x800080),
+    ("rebeccapurple", 0x663399),
+    ("red", 0xFF0000),
+    ("rosybrown", 0xBC8F8F),
+    ("royalblue", 0x4169E1),
+    ("saddlebrown", 0x8B4513),
+    ("salmon", 0xFA8072),
+    ("sandybrown", 0xF4A460),
+    ("seagreen", 0x2E8B57),
+    ("seashell", 0xFFF5EE),
+    ("sienna", 0xA0522D),
+    ("silver", 0xC0C0C0),
+    ("skyblue", 0x87CEEB),
+    ("slateblue", 0x6A5ACD),
+    ("slategray", 0x708090),
+    ("slategrey", 0x708090),
+    ("snow", 0xFFFAFA),
+    ("springgreen", 0x00FF7F),
+    ("steelblue", 0x4682B4),
+    ("tan", 0xD2B48C),
+    ("teal", 0x008080),
+    ("thistle", 0xD8BFD8),
+    ("tomato", 0xFF6347),
+    ("turquoise", 0x40E0D0),
+    ("violet", 0xEE82EE),
+    ("wheat", 0xF5DEB3),
+    ("white", 0xFFFFFF),
+    ("whitesmoke", 0xF5F5F5),
+    ("yellow", 0xFFFF00),
+    ("yellowgreen", 0x9ACD32),
+];
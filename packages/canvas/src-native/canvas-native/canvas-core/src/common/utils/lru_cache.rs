@@ -0,0 +1,95 @@
+use std::borrow::Borrow;
+use std::collections::HashMap;
+use std::hash::Hash;
+
+struct Entry<V> {
+    value: V,
+    last_used: u64,
+}
+
+/// Small bounded map which evicts the least recently used entry once `capacity` is reached.
+/// Eviction scans the map, so this is meant for caches with a few hundred entries at most.
+pub(crate) struct LruCache<K, V> {
+    entries: HashMap<K, Entry<V>>,
+    capacity: usize,
+    tick: u64,
+}
+
+impl<K: Hash + Eq + Clone, V> LruCache<K, V> {
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            entries: HashMap::with_capacity(capacity),
+            capacity: capacity.max(1),
+            tick: 0,
+        }
+    }
+
+    pub fn get<Q: ?Sized>(&mut self, key: &Q) -> Option<&V>
+    where
+        K: Borrow<Q>,
+        Q: Hash + Eq,
+    {
+        self.tick += 1;
+        let tick = self.tick;
+        self.entries.get_mut(key).map(|entry| {
+            entry.last_used = tick;
+            &entry.value
+        })
+    }
+
+    pub fn get_mut<Q: ?Sized>(&mut self, key: &Q) -> Option<&mut V>
+    where
+        K: Borrow<Q>,
+        Q: Hash + Eq,
+    {
+        self.tick += 1;
+        let tick = self.tick;
+        self.entries.get_mut(key).map(|entry| {
+            entry.last_used = tick;
+            &mut entry.value
+        })
+    }
+
+    pub fn insert(&mut self, key: K, value: V) -> &mut V {
+        self.tick += 1;
+        if !self.entries.contains_key(&key) && self.entries.len() >= self.capacity {
+            self.evict_oldest();
+        }
+        let entry = Entry {
+            value,
+            last_used: self.tick,
+        };
+        match self.entries.entry(key) {
+            std::collections::hash_map::Entry::Occupied(mut occupied) => {
+                occupied.insert(entry);
+                &mut occupied.into_mut().value
+            }
+            std::collections::hash_map::Entry::Vacant(vacant) => &mut vacant.insert(entry).value,
+        }
+    }
+
+    pub fn remove<Q: ?Sized>(&mut self, key: &Q) -> Option<V>
+    where
+        K: Borrow<Q>,
+        Q: Hash + Eq,
+    {
+        self.entries.remove(key).map(|entry| entry.value)
+    }
+
+    pub fn evict_oldest(&mut self) -> Option<V> {
+        let oldest = self
+            .entries
+            .iter()
+            .min_by_key(|(_, entry)| entry.last_used)
+            .map(|(key, _)| key.clone());
+        oldest.and_then(|key| self.remove(&key))
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.clear();
+    }
+}
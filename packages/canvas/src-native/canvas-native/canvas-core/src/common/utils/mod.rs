@@ -4,3 +4,4 @@ pub(crate) mod dimensions;
 pub(crate) mod geometry;
 pub(crate) mod gl;
 pub(crate) mod image;
+pub(crate) mod lru_cache;
@@ -1,6 +1,5 @@
 use std::ffi::{CStr, CString};
 use std::os::raw::{c_char, c_float, c_int, c_longlong, c_uint};
-use std::str::FromStr;
 
 use skia_safe::{
     AlphaType, Color, ColorType, EncodedImageFormat, ImageInfo, IPoint, ISize, M44, PixelGeometry,
@@ -9,7 +8,7 @@ use skia_safe::{
 use skia_safe::gpu::gl::Interface;
 use skia_safe::image::CachingHint;
 
-use crate::common::context::{Context, Device, State};
+use crate::common::context::{Context, Device};
 use crate::common::context::compositing::composite_operation_type::CompositeOperationType;
 use crate::common::context::drawing_paths::fill_rule::FillRule;
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
@@ -28,7 +27,7 @@ use crate::common::ffi::f32_array::F32Array;
 use crate::common::ffi::paint_style_value::{PaintStyleValue, PaintStyleValueType};
 use crate::common::ffi::u8_array::U8Array;
 use crate::common::to_data_url;
-use crate::common::utils::color::to_parsed_color;
+use crate::common::utils::color::{parse_color, to_parsed_color};
 use crate::common::utils::image::{from_image_slice, to_image, to_image_encoded};
 
 /*
@@ -114,15 +113,12 @@ pub extern "C" fn context_init_context(
         Some(&surface_props),
     );
 
-    Box::into_raw(Box::new(Context {
-        surface: surface_holder.unwrap(),
-        path: Path::default(),
-        state: State::from_device(device, direction),
-        state_stack: vec![],
-        font_color: Color::new(font_color),
+    Box::into_raw(Box::new(Context::new(
+        surface_holder.unwrap(),
         device,
-        enable_scaling: false,
-    })) as c_longlong
+        direction,
+        Color::new(font_color),
+    ))) as c_longlong
 }
 
 #[no_mangle]
@@ -152,15 +148,12 @@ pub extern "C" fn context_init_context_with_custom_surface(
         None,
     );
 
-    Box::into_raw(Box::new(Context {
-        surface: Surface::new_raster(&info, None, None).unwrap(),
-        path: Path::default(),
-        state: State::from_device(device, direction),
-        state_stack: vec![],
-        font_color: Color::new(font_color as u32),
+    Box::into_raw(Box::new(Context::new(
+        Surface::new_raster(&info, None, None).unwrap(),
         device,
-        enable_scaling: false,
-    })) as c_longlong
+        direction,
+        Color::new(font_color as u32),
+    ))) as c_longlong
 }
 
 #[no_mangle]
@@ -351,6 +344,81 @@ pub(crate) fn context_to_data(context: *mut Context) -> Vec<u8> {
     }
 }
 
+/// Returns a native image handle of the canvas contents, drawn and released by
+/// `context_draw_image_snapshot`.
+#[no_mangle]
+pub extern "C" fn context_snapshot_image(context: c_longlong) -> c_longlong {
+    if context == 0 {
+        return 0;
+    }
+    unsafe {
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        match context.snapshot_image() {
+            Some(image) => Box::into_raw(Box::new(image)) as c_longlong,
+            None => 0,
+        }
+    }
+}
+
+/// Draws a snapshot taken with `context_snapshot_image` and releases it.
+#[no_mangle]
+pub extern "C" fn context_draw_image_snapshot(
+    context: c_longlong,
+    snapshot: c_longlong,
+    sx: c_float,
+    sy: c_float,
+    s_width: c_float,
+    s_height: c_float,
+    dx: c_float,
+    dy: c_float,
+    d_width: c_float,
+    d_height: c_float,
+) {
+    if snapshot == 0 {
+        return;
+    }
+    unsafe {
+        let snapshot: *mut skia_safe::Image = snapshot as _;
+        let snapshot = Box::from_raw(snapshot);
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        context.draw_image(
+            &snapshot,
+            Rect::from_xywh(sx, sy, s_width, s_height),
+            Rect::from_xywh(dx, dy, d_width, d_height),
+        );
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn context_draw_image_self(
+    context: c_longlong,
+    sx: c_float,
+    sy: c_float,
+    s_width: c_float,
+    s_height: c_float,
+    dx: c_float,
+    dy: c_float,
+    d_width: c_float,
+    d_height: c_float,
+) {
+    unsafe {
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        context.draw_snapshot(
+            Rect::from_xywh(sx, sy, s_width, s_height),
+            Rect::from_xywh(dx, dy, d_width, d_height),
+        );
+    }
+}
+
 #[inline]
 #[no_mangle]
 pub extern "C" fn context_snapshot_canvas(context: c_longlong) -> *mut U8Array {
@@ -814,13 +882,8 @@ pub extern "C" fn context_set_shadow_color_string(context: c_longlong, color: *c
         let context: *mut Context = context as _;
         let context = &mut *context;
         let color = CStr::from_ptr(color).to_string_lossy();
-        if let Ok(color) = css_color_parser::Color::from_str(color.as_ref()) {
-            context.set_shadow_color(Color::from_argb(
-                (color.a * 255.0) as u8,
-                color.r,
-                color.g,
-                color.b,
-            ))
+        if let Some(color) = parse_color(color.as_ref()) {
+            context.set_shadow_color(color)
         }
     }
 }
@@ -1469,6 +1532,58 @@ pub extern "C" fn context_draw_image_asset(
     }
 }
 
+/// Draws `sprites_length / IMAGE_BATCH_SPRITE_SIZE` sprites of the image, see
+/// `Context::draw_image_batch` for the layout.
+#[no_mangle]
+pub extern "C" fn context_draw_image_batch(
+    context: c_longlong,
+    image_data: *const u8,
+    image_len: usize,
+    width: c_float,
+    height: c_float,
+    sprites: *const c_float,
+    sprites_length: usize,
+) {
+    unsafe {
+        if context == 0 || sprites.is_null() {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        if let Some(image) = to_image(image_data, image_len, width as i32, height as i32) {
+            context.draw_image_batch(&image, std::slice::from_raw_parts(sprites, sprites_length))
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn context_draw_image_batch_asset(
+    context: c_longlong,
+    asset: c_longlong,
+    sprites: *const c_float,
+    sprites_length: usize,
+) {
+    unsafe {
+        if context == 0 || asset == 0 || sprites.is_null() {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let asset: *mut ImageAsset = asset as _;
+        let asset = &mut *asset;
+        let sprites = std::slice::from_raw_parts(sprites, sprites_length);
+        if let Some(image) = asset.skia_image() {
+            context.draw_image_batch(&image, sprites)
+        } else if let Some(bytes) = asset.get_bytes() {
+            if let Some(image) =
+                from_image_slice(bytes, asset.width() as i32, asset.height() as i32)
+            {
+                context.draw_image_batch(&image, sprites)
+            }
+        }
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn context_ellipse(
     context: c_longlong,
@@ -1555,6 +1670,28 @@ pub extern "C" fn context_fill_text(
     }
 }
 
+/// Draws `svg` from the shared svg atlas, `tint` is ARGB and 0 for none.
+#[no_mangle]
+pub extern "C" fn context_draw_svg(
+    context: c_longlong,
+    svg: *const c_char,
+    x: c_float,
+    y: c_float,
+    width: c_float,
+    height: c_float,
+    tint: c_uint,
+) {
+    unsafe {
+        if context == 0 || svg.is_null() {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let svg = CStr::from_ptr(svg).to_string_lossy();
+        crate::common::svg::atlas::draw_svg_sprite(context, svg.as_ref(), x, y, width, height, tint)
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn context_get_image_data(
     context: c_longlong,
@@ -1670,6 +1807,85 @@ pub extern "C" fn context_measure_text(context: c_longlong, text: *const c_char)
     }
 }
 
+/// Measures the strings packed in `text`, a UTF-8 buffer where string `i` starts at `offsets[i]`
+/// and ends at the next offset (or `text_len` for the last one).
+#[no_mangle]
+pub extern "C" fn context_measure_text_batch(
+    context: c_longlong,
+    text: *const u8,
+    text_len: usize,
+    offsets: *const usize,
+    offsets_len: usize,
+) -> *mut F32Array {
+    unsafe {
+        if context == 0 || (text.is_null() && text_len > 0) || (offsets.is_null() && offsets_len > 0) {
+            return std::ptr::null_mut();
+        }
+        let context: *const Context = context as _;
+        let context = &*context;
+        let text = if text_len == 0 {
+            &[][..]
+        } else {
+            std::slice::from_raw_parts(text, text_len)
+        };
+        let offsets = if offsets_len == 0 {
+            &[][..]
+        } else {
+            std::slice::from_raw_parts(offsets, offsets_len)
+        };
+        let strings: Vec<_> = offsets
+            .iter()
+            .enumerate()
+            .map(|(i, start)| {
+                let end = offsets.get(i + 1).copied().unwrap_or(text_len).min(text_len);
+                let start = (*start).min(end);
+                String::from_utf8_lossy(&text[start..end])
+            })
+            .collect();
+        let metrics = context.measure_text_batch(strings.iter().map(|text| text.as_ref()));
+        Box::into_raw(Box::new(F32Array::from(metrics)))
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn context_fill_paragraph(
+    context: c_longlong,
+    text: *const c_char,
+    x: c_float,
+    y: c_float,
+    max_width: c_float,
+    line_height: c_float,
+) {
+    unsafe {
+        if context == 0 {
+            return;
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let txt = CStr::from_ptr(text).to_string_lossy();
+        context.fill_paragraph(txt.as_ref(), x, y, max_width, line_height)
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn context_measure_paragraph(
+    context: c_longlong,
+    text: *const c_char,
+    max_width: c_float,
+    line_height: c_float,
+) -> *mut F32Array {
+    unsafe {
+        if context == 0 {
+            return std::ptr::null_mut();
+        }
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let text = CStr::from_ptr(text).to_string_lossy();
+        let metrics = context.measure_paragraph(text.as_ref(), max_width, line_height);
+        Box::into_raw(Box::new(F32Array::from(metrics)))
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn context_move_to(context: c_longlong, x: c_float, y: c_float) {
     unsafe {
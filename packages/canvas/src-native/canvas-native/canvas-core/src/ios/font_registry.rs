@@ -0,0 +1,59 @@
+use std::ffi::CStr;
+use std::os::raw::c_char;
+
+use crate::common::context::drawing_text::font_registry::FontRegistry;
+
+unsafe fn get_alias(alias: *const c_char) -> Option<String> {
+    if alias.is_null() {
+        return None;
+    }
+    Some(CStr::from_ptr(alias).to_string_lossy().to_string())
+}
+
+#[no_mangle]
+pub extern "C" fn font_registry_register_path(path: *const c_char, alias: *const c_char) -> bool {
+    if path.is_null() {
+        return false;
+    }
+    unsafe {
+        let path = CStr::from_ptr(path).to_string_lossy();
+        let alias = get_alias(alias);
+        FontRegistry::shared()
+            .register_path(path.as_ref(), alias.as_deref())
+            .is_some()
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn font_registry_register_bytes(
+    bytes: *const u8,
+    size: usize,
+    alias: *const c_char,
+) -> bool {
+    if bytes.is_null() || size == 0 {
+        return false;
+    }
+    unsafe {
+        let bytes = std::slice::from_raw_parts(bytes, size);
+        let alias = get_alias(alias);
+        FontRegistry::shared()
+            .register_bytes(bytes, alias.as_deref())
+            .is_some()
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn font_registry_unregister(family: *const c_char) -> bool {
+    if family.is_null() {
+        return false;
+    }
+    unsafe {
+        let family = CStr::from_ptr(family).to_string_lossy();
+        FontRegistry::shared().unregister(family.as_ref())
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn font_registry_clear() {
+    FontRegistry::shared().clear();
+}
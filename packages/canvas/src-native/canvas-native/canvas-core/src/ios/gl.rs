@@ -1,6 +1,8 @@
 use std::os::raw::{c_int, c_longlong, c_uint, c_void};
 
 use crate::common::context::image_asset::ImageAsset;
+use crate::common::profiler::profile_scope;
+use crate::common::stats::{self, Counter};
 
 const RGB: u32 = 0x1907;
 const RGBA: u32 = 0x1908;
@@ -16,11 +18,13 @@ pub extern "C" fn gl_tex_image_2D_asset(
     asset: c_longlong,
     flip_y: bool,
 ) {
+    profile_scope!("gl.tex_image_2d");
     unsafe {
         let asset: *mut ImageAsset = asset as _;
         let asset = &mut *asset;
         let data = asset.get_bytes();
         if let Some(data) = data {
+            stats::add(Counter::BytesUploaded, data.len() as u64);
             let internalformat = RGBA as i32;
 
             let format = RGBA;
@@ -76,6 +80,7 @@ pub extern "C" fn gl_tex_sub_image_2D_asset(
     asset: c_longlong,
     flip_y: bool,
 ) {
+    profile_scope!("gl.tex_sub_image_2d");
     unsafe {
         let asset: *mut ImageAsset = asset as _;
         let asset = &mut *asset;
@@ -84,6 +89,7 @@ pub extern "C" fn gl_tex_sub_image_2D_asset(
         let height = asset.height();
 
         if let Some(data) = data {
+            stats::add(Counter::BytesUploaded, data.len() as u64);
             let format = match (format, asset.channels()) {
                 (RGB, 4) => RGBA,
                 _ => format
@@ -146,6 +152,7 @@ pub extern "C" fn gl_tex_image_3D_asset(
         let asset = &mut *asset;
         let data = asset.get_bytes();
         if let Some(data) = data {
+            stats::add(Counter::BytesUploaded, data.len() as u64);
             let internalformat = RGBA as i32;
 
             let format = RGBA;
@@ -211,6 +218,7 @@ pub extern "C" fn gl_tex_sub_image_3D_asset(
         let asset = &mut *asset;
         let data = asset.get_bytes();
         if let Some(data) = data {
+            stats::add(Counter::BytesUploaded, data.len() as u64);
             let format = match (format, asset.channels()) {
                 (RGB, 4) => RGBA,
                 _ => format
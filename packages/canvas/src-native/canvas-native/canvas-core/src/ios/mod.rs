@@ -6,6 +6,7 @@ use crate::common::context::drawing_text::text_metrics::TextMetrics;
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
 
 pub mod context;
+pub mod font_registry;
 pub mod gl;
 pub mod gradient;
 pub mod image_asset;
@@ -15,6 +16,8 @@ pub mod matrix;
 pub mod paint;
 pub mod path;
 pub mod pattern;
+pub mod profiler;
+pub mod stats;
 pub mod svg;
 pub mod text_decoder;
 pub mod text_encoder;
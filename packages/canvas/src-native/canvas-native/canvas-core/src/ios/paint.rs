@@ -1,12 +1,9 @@
 use std::ffi::{CStr, CString};
 use std::os::raw::{c_char, c_longlong};
-use std::str::FromStr;
-
-use css_color_parser::{Color};
 
 use crate::common::context::Context;
 use crate::common::context::fill_and_stroke_styles::paint::PaintStyle;
-use crate::common::utils::color::to_parsed_color;
+use crate::common::utils::color::{parse_color, to_parsed_color};
 
 pub(crate) fn paint_style_set_color_with_string(
     context: c_longlong,
@@ -20,13 +17,8 @@ pub(crate) fn paint_style_set_color_with_string(
         let context: *mut Context = context as _;
         let context = &mut *context;
         let color = CStr::from_ptr(color).to_string_lossy();
-        if let Ok(color) = Color::from_str(color.as_ref()) {
-            let style = PaintStyle::Color(skia_safe::Color::from_argb(
-                (color.a * 255.0) as u8,
-                color.r,
-                color.g,
-                color.b,
-            ));
+        if let Some(color) = parse_color(color.as_ref()) {
+            let style = PaintStyle::Color(color);
             if is_fill {
                 context.set_fill_style(style);
             } else {
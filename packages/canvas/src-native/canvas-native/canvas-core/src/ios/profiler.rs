@@ -0,0 +1,31 @@
+use std::ffi::{CStr, CString};
+use std::os::raw::{c_char, c_ulonglong};
+
+use crate::common::profiler;
+
+#[no_mangle]
+pub extern "C" fn profiler_set_enabled(enabled: bool) -> bool {
+    profiler::set_enabled(enabled)
+}
+
+#[no_mangle]
+pub extern "C" fn profiler_record(name: *const c_char, duration_ns: c_ulonglong) {
+    if name.is_null() {
+        return;
+    }
+    unsafe {
+        let name = CStr::from_ptr(name).to_string_lossy();
+        profiler::record(name.as_ref(), duration_ns);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn profiler_clear() {
+    profiler::clear();
+}
+
+/// Chrome trace JSON of the recorded events, free with `destroy_string`.
+#[no_mangle]
+pub extern "C" fn profiler_dump() -> *const c_char {
+    CString::new(profiler::dump()).unwrap().into_raw()
+}
@@ -0,0 +1,31 @@
+use std::os::raw::c_ulonglong;
+
+use crate::common::stats::{self, CanvasStats, Counter};
+
+#[no_mangle]
+pub extern "C" fn stats_get(stats: *mut CanvasStats, last_frame: bool) {
+    if stats.is_null() {
+        return;
+    }
+    unsafe {
+        *stats = stats::get_stats(last_frame);
+    }
+}
+
+/// Adds to a counter from the platform side, e.g. the WebGL draw calls.
+#[no_mangle]
+pub extern "C" fn stats_add(counter: u32, value: c_ulonglong) {
+    if let Some(counter) = Counter::from_u32(counter) {
+        stats::add(counter, value);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn stats_end_frame() {
+    stats::end_frame();
+}
+
+#[no_mangle]
+pub extern "C" fn stats_reset() {
+    stats::reset();
+}
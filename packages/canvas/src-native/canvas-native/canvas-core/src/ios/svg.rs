@@ -1,7 +1,9 @@
-use std::ffi::CStr;
-use std::os::raw::c_longlong;
+use std::ffi::{CStr, CString};
+use std::os::raw::{c_char, c_int, c_longlong};
 
 use crate::common::context::Context;
+use crate::common::svg::cancel::Cancellation;
+use crate::common::svg::document::SvgDocument;
 
 #[no_mangle]
 pub extern "C" fn svg_draw_from_string(context: c_longlong, svg: *const i8) {
@@ -11,7 +13,7 @@ pub extern "C" fn svg_draw_from_string(context: c_longlong, svg: *const i8) {
             let context = &mut *context;
             let svg = CStr::from_ptr(svg);
             let svg = svg.to_string_lossy();
-            crate::common::svg::draw_svg(context, svg.as_ref());
+            crate::common::svg::draw_svg(context, svg.as_ref(), &Cancellation::none());
         }
     }
 }
@@ -24,7 +26,166 @@ pub extern "C" fn svg_draw_from_path(context: c_longlong, path: *const i8) {
             let context = &mut *context;
             let path = CStr::from_ptr(path);
             let path = path.to_string_lossy();
-            crate::common::svg::draw_svg_from_path(context, path.as_ref());
+            crate::common::svg::draw_svg_from_path(context, path.as_ref(), &Cancellation::none());
         }
     }
 }
+
+/// Bytes the parsed svg cache may use, 0 disables it.
+#[no_mangle]
+pub extern "C" fn svg_set_cache_budget(bytes: c_longlong) {
+    crate::common::svg::cache::set_budget(bytes.max(0) as usize);
+}
+
+#[no_mangle]
+pub extern "C" fn svg_draw_document(context: c_longlong, document: c_longlong) {
+    if context == 0 || document == 0 {
+        return;
+    }
+    unsafe {
+        let context: *mut Context = context as _;
+        let context = &mut *context;
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        crate::common::svg::draw_svg_document(context, document, &Cancellation::none());
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn svg_document_create(svg: *const c_char) -> c_longlong {
+    if svg.is_null() {
+        return 0;
+    }
+    unsafe {
+        let svg = CStr::from_ptr(svg).to_string_lossy();
+        match SvgDocument::from_str(svg.as_ref()) {
+            Ok(document) => Box::into_raw(Box::new(document)) as c_longlong,
+            Err(e) => {
+                log::debug!("svg document parse error: {}", e);
+                0
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn svg_document_destroy(document: c_longlong) {
+    if document == 0 {
+        return;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let _ = Box::from_raw(document);
+    }
+}
+
+/// Node of the element with `id`, the root for a null `id` and -1 when there is none.
+#[no_mangle]
+pub extern "C" fn svg_document_element_by_id(document: c_longlong, id: *const c_char) -> c_int {
+    if document == 0 {
+        return -1;
+    }
+    unsafe {
+        let document: *const SvgDocument = document as _;
+        let document = &*document;
+        if id.is_null() {
+            return document.root() as c_int;
+        }
+        let id = CStr::from_ptr(id).to_string_lossy();
+        document
+            .element_by_id(id.as_ref())
+            .map_or(-1, |node| node as c_int)
+    }
+}
+
+/// A null `value` removes the attribute.
+#[no_mangle]
+pub extern "C" fn svg_document_set_attribute(
+    document: c_longlong,
+    node: c_int,
+    name: *const c_char,
+    value: *const c_char,
+) -> bool {
+    if document == 0 || node < 0 || name.is_null() {
+        return false;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        let name = CStr::from_ptr(name).to_string_lossy();
+        let value = if value.is_null() {
+            None
+        } else {
+            Some(CStr::from_ptr(value).to_string_lossy())
+        };
+        document.set_attribute(node as usize, name.as_ref(), value.as_deref())
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn svg_document_set_text(
+    document: c_longlong,
+    node: c_int,
+    text: *const c_char,
+) -> bool {
+    if document == 0 || node < 0 || text.is_null() {
+        return false;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        let text = CStr::from_ptr(text).to_string_lossy();
+        document.set_text(node as usize, text.as_ref())
+    }
+}
+
+/// Parses `xml` into `parent`, returns the first element appended or -1.
+#[no_mangle]
+pub extern "C" fn svg_document_append_child(
+    document: c_longlong,
+    parent: c_int,
+    xml: *const c_char,
+) -> c_int {
+    if document == 0 || parent < 0 || xml.is_null() {
+        return -1;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        let xml = CStr::from_ptr(xml).to_string_lossy();
+        match document.append_child(parent as usize, xml.as_ref()) {
+            Ok(node) => node.map_or(-1, |node| node as c_int),
+            Err(e) => {
+                log::debug!("svg append error: {}", e);
+                -1
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn svg_document_remove(document: c_longlong, node: c_int) -> bool {
+    if document == 0 || node < 0 {
+        return false;
+    }
+    unsafe {
+        let document: *mut SvgDocument = document as _;
+        let document = &mut *document;
+        document.remove(node as usize)
+    }
+}
+
+/// The document as XML, free with `destroy_string`. Null when a text contains NUL, which a C
+/// string can't hold.
+#[no_mangle]
+pub extern "C" fn svg_document_to_string(document: c_longlong) -> *const c_char {
+    if document == 0 {
+        return std::ptr::null();
+    }
+    unsafe {
+        let document: *const SvgDocument = document as _;
+        let document = &*document;
+        CString::new(document.to_xml())
+            .map_or(std::ptr::null(), |xml| xml.into_raw() as *const c_char)
+    }
+}
@@ -2075,6 +2075,14 @@ declare module org {
 		export module canvas {
 			export class TNSWebGLRenderingContext extends org.nativescript.canvas.TNSCanvasRenderingContext {
 				public static class: java.lang.Class<org.nativescript.canvas.TNSWebGLRenderingContext>;
+				public precompileProgram(param0: string, param1: string): void;
+				public precompileProgram(param0: string, param1: string, param2: java.util.Map<string,java.lang.Integer>): void;
+				public uniformBatch(param0: number, param1: org.nativescript.canvas.WebGLUniformBatch): number;
+				public uniformBatch(param0: number, param1: java.nio.ByteBuffer, param2: number, param3: number): number;
+				public readPixelsAsync(param0: number, param1: number, param2: number, param3: number, param4: number, param5: number): org.nativescript.canvas.WebGLReadback;
+				public beginGpuPass(param0: string): void;
+				public endGpuPass(): void;
+				public readPixelsAsync(param0: number, param1: number, param2: number, param3: number, param4: number, param5: number, param6: org.nativescript.canvas.WebGLReadback.Callback): org.nativescript.canvas.WebGLReadback;
 				public static SIZE_OF_BYTE: number;
 				public static SIZE_OF_SHORT: number;
 				public static SIZE_OF_INT: number;
@@ -3316,5 +3324,82 @@ declare module org {
 	}
 }
 
+declare module org {
+	export module nativescript {
+		export module canvas {
+			export class WebGLUniformBatch {
+				public static class: java.lang.Class<org.nativescript.canvas.WebGLUniformBatch>;
+				public constructor();
+				public constructor(param0: number);
+				public getSize(): number;
+				public clear(): void;
+				public uniform(param0: number, param1: number, param2: androidNative.Array<number>): void;
+				public uniform(param0: number, param1: number, param2: androidNative.Array<number>, param3: boolean): void;
+				public uniform1f(param0: number, param1: number): void;
+				public uniform1i(param0: number, param1: number): void;
+				public static components(param0: number): number;
+			}
+		}
+	}
+}
+declare module org {
+	export module nativescript {
+		export module canvas {
+			export class WebGLReadback {
+				public static class: java.lang.Class<org.nativescript.canvas.WebGLReadback>;
+				public getWidth(): number;
+				public getHeight(): number;
+				public getFormat(): number;
+				public getType(): number;
+				public isDone(): boolean;
+				public getData(): java.nio.ByteBuffer;
+				public getError(): string;
+				public then(param0: org.nativescript.canvas.WebGLReadback.Callback): void;
+			}
+			export module WebGLReadback {
+				export class Callback {
+					public static class: java.lang.Class<org.nativescript.canvas.WebGLReadback.Callback>;
+					/**
+					 * Constructs a new instance of the org.nativescript.canvas.WebGLReadback$Callback interface with the provided implementation. An empty constructor exists calling super() when extending the interface class.
+					 */
+					public constructor(implementation: {
+						onSuccess(param0: any): void;
+						onError(param0: string): void;
+					});
+					public constructor();
+					public onSuccess(param0: any): void;
+					public onError(param0: string): void;
+				}
+			}
+		}
+	}
+}
+
+declare module org {
+	export module nativescript {
+		export module canvas {
+			export class TNSAnimationFrame {
+				public static class: java.lang.Class<org.nativescript.canvas.TNSAnimationFrame>;
+				public static INSTANCE: org.nativescript.canvas.TNSAnimationFrame;
+				public static requestAnimationFrame(param0: org.nativescript.canvas.TNSAnimationFrame.Callback): number;
+				public static cancelAnimationFrame(param0: number): void;
+			}
+			export module TNSAnimationFrame {
+				export class Callback {
+					public static class: java.lang.Class<org.nativescript.canvas.TNSAnimationFrame.Callback>;
+					/**
+					 * Constructs a new instance of the org.nativescript.canvas.TNSAnimationFrame$Callback interface with the provided implementation. An empty constructor exists calling super() when extending the interface class.
+					 */
+					public constructor(implementation: {
+						onAnimationFrame(param0: number): void;
+					});
+					public constructor();
+					public onAnimationFrame(param0: number): void;
+				}
+			}
+		}
+	}
+}
+
 //Generics information:
 
@@ -252,16 +252,26 @@ declare const enum Repetition {
 
 declare class TNSAnimationFrame extends NSObject {
 
+	static addFrameListener(listener: TNSFrameListener): void;
+
 	static alloc(): TNSAnimationFrame; // inherited from NSObject
 
-	static cancelAnimationFrameWithId(id: string): void;
+	static cancelAnimationFrameWithId(id: number): void;
 
 	static new(): TNSAnimationFrame; // inherited from NSObject
 
-	static requestAnimationFrameToLoop(toLoop: (p1: number) => void): void;
+	static removeFrameListener(listener: TNSFrameListener): void;
+
+	static requestAnimationFrameToLoop(toLoop: (p1: number) => void): number;
+
+	static resetStats(): void;
+
+	static stats(): TNSFrameStats;
+
+	static targetFrameRate: number;
 }
 
-declare class TNSCanvas extends UIView {
+declare class TNSCanvas extends UIView implements TNSFrameListener {
 
 	static alloc(): TNSCanvas; // inherited from NSObject
 
@@ -329,6 +339,8 @@ declare class TNSCanvas extends UIView {
 
 	moveToMain(): void;
 
+	onFrame(interval: number): void;
+
 	pause(): void;
 
 	resume(): void;
@@ -654,6 +666,40 @@ declare const enum TNSFillRule {
 	EvenOdd = 1
 }
 
+interface TNSFrameListener {
+
+	onFrame(interval: number): void;
+}
+declare var TNSFrameListener: {
+
+	prototype: TNSFrameListener;
+};
+
+declare class TNSFrameStats extends NSObject {
+
+	static alloc(): TNSFrameStats; // inherited from NSObject
+
+	static new(): TNSFrameStats; // inherited from NSObject
+
+	readonly averageCallbackTime: number;
+
+	readonly averageFlushTime: number;
+
+	readonly callbackTime: number;
+
+	readonly droppedFrames: number;
+
+	readonly flushTime: number;
+
+	readonly frameInterval: number;
+
+	readonly frames: number;
+
+	readonly maxCallbackTime: number;
+
+	readonly maxFlushTime: number;
+}
+
 declare class TNSFramebufferAttachmentParameter extends NSObject {
 
 	static alloc(): TNSFramebufferAttachmentParameter; // inherited from NSObject